@@ -2,6 +2,7 @@
 
 #include <Logging.h>
 
+#include <algorithm>
 #include <cstdlib>
 
 bool FontDecompressor::init() {
@@ -132,3 +133,77 @@ const uint8_t* FontDecompressor::getBitmap(const EpdFontData* fontData, const Ep
   }
   return &entry->data[glyph->dataOffset];
 }
+
+void FontDecompressor::PrewarmSet::addGlyph(const EpdFontData* fontData, const EpdGlyph* glyph) {
+  if (!fontData->groups || fontData->groupCount == 0) {
+    return;  // Uncompressed font, nothing to warm
+  }
+
+  const uint16_t groupIndex = getGroupIndex(fontData, static_cast<uint16_t>(glyph - fontData->glyph));
+  if (groupIndex >= fontData->groupCount) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    if (entries[i].font == fontData && entries[i].groupIndex == groupIndex) {
+      if (entries[i].uses < UINT16_MAX) entries[i].uses++;
+      return;
+    }
+  }
+
+  if (count >= MAX_PREWARM_GROUPS) {
+    overflow++;
+    return;
+  }
+  entries[count++] = {fontData, groupIndex, 1};
+}
+
+uint16_t FontDecompressor::prewarm(PrewarmSet& set) {
+  if (set.count == 0) {
+    return set.overflow;
+  }
+
+  // Most used groups first: these are the ones that get a cache slot
+  std::sort(set.entries, set.entries + set.count,
+            [](const PrewarmSet::Entry& a, const PrewarmSet::Entry& b) { return a.uses > b.uses; });
+  const uint8_t resident = std::min<uint8_t>(set.count, CACHE_SLOTS);
+
+  // Groups outside the resident set are not worth keeping around
+  for (auto& entry : cache) {
+    if (!entry.valid) continue;
+    bool wanted = false;
+    for (uint8_t i = 0; i < resident; i++) {
+      if (entry.font == set.entries[i].font && entry.groupIndex == set.entries[i].groupIndex) {
+        wanted = true;
+        break;
+      }
+    }
+    if (!wanted) {
+      free(entry.data);
+      entry.data = nullptr;
+      entry.valid = false;
+    }
+  }
+
+  // Decompress least used first so that the most used group ends up with the newest LRU stamp
+  uint16_t failed = 0;
+  for (int i = resident - 1; i >= 0; i--) {
+    const auto& wanted = set.entries[i];
+    CacheEntry* entry = findInCache(wanted.font, wanted.groupIndex);
+    if (!entry) {
+      entry = findEvictionCandidate();
+      if (!decompressGroup(wanted.font, wanted.groupIndex, entry)) {
+        failed++;
+        continue;
+      }
+    }
+    entry->lastUsed = ++accessCounter;
+  }
+
+  const uint16_t misses = (set.count - resident) + set.overflow + failed;
+  if (misses > 0) {
+    LOG_DBG("FDC", "Prewarm: %u groups needed, %u cache slots, %u expected misses", set.count + set.overflow,
+            CACHE_SLOTS, misses);
+  }
+  return misses;
+}
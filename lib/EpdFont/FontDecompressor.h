@@ -16,9 +16,36 @@ class FontDecompressor {
   // Evict all cached decompressed groups (call between pages for within-page-only caching).
   void clearCache();
 
- private:
   static constexpr uint8_t CACHE_SLOTS = 4;
+  static constexpr uint8_t MAX_PREWARM_GROUPS = 32;
+
+  // Set of compressed groups needed to draw a page, collected before rasterization starts.
+  // Each entry counts how many glyphs on the page come from that group.
+  class PrewarmSet {
+   public:
+    void addGlyph(const EpdFontData* fontData, const EpdGlyph* glyph);
+    uint8_t size() const { return count; }
+    // Number of distinct groups that were dropped because the set was full
+    uint16_t overflowCount() const { return overflow; }
+
+   private:
+    friend class FontDecompressor;
+    struct Entry {
+      const EpdFontData* font;
+      uint16_t groupIndex;
+      uint16_t uses;
+    };
+    Entry entries[MAX_PREWARM_GROUPS] = {};
+    uint8_t count = 0;
+    uint16_t overflow = 0;
+  };
+
+  // Decompress the groups in `set` ahead of drawing, least used first so the hottest groups are the last to be
+  // evicted. Groups already in the cache are kept rather than decompressed again.
+  // Returns the number of groups that do not fit in the cache, i.e. the expected misses while drawing the page.
+  uint16_t prewarm(PrewarmSet& set);
 
+ private:
   struct CacheEntry {
     const EpdFontData* font = nullptr;
     uint16_t groupIndex = 0;
@@ -33,7 +60,7 @@ class FontDecompressor {
   uint32_t accessCounter = 0;
 
   void freeAllEntries();
-  uint16_t getGroupIndex(const EpdFontData* fontData, uint16_t glyphIndex);
+  static uint16_t getGroupIndex(const EpdFontData* fontData, uint16_t glyphIndex);
   CacheEntry* findInCache(const EpdFontData* fontData, uint16_t groupIndex);
   CacheEntry* findEvictionCandidate();
   bool decompressGroup(const EpdFontData* fontData, uint16_t groupIndex, CacheEntry* entry);
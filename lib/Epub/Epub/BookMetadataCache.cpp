@@ -9,8 +9,9 @@
 #include "FsHelpers.h"
 
 namespace {
-constexpr uint8_t BOOK_CACHE_VERSION = 5;
+constexpr uint8_t BOOK_CACHE_VERSION = 6;
 constexpr char bookBinFile[] = "/book.bin";
+constexpr char tmpBookBinFile[] = "/book.bin.tmp";
 constexpr char tmpSpineBinFile[] = "/spine.bin.tmp";
 constexpr char tmpTocBinFile[] = "/toc.bin.tmp";
 }  // namespace
@@ -29,12 +30,18 @@ bool BookMetadataCache::beginContentOpfPass() {
   LOG_DBG("BMC", "Beginning content opf pass");
 
   // Open spine file for writing
-  return Storage.openFileForWrite("BMC", cachePath + tmpSpineBinFile, spineFile);
+  if (!Storage.openFileForWrite("BMC", cachePath + tmpSpineBinFile, spineFile)) {
+    return false;
+  }
+  spineWriter.reset(new serialization::BufferedWriter(spineFile));
+  return true;
 }
 
 bool BookMetadataCache::endContentOpfPass() {
+  const bool written = spineWriter && spineWriter->flush();
+  spineWriter.reset();
   spineFile.close();
-  return true;
+  return written;
 }
 
 bool BookMetadataCache::beginTocPass() {
@@ -47,13 +54,15 @@ bool BookMetadataCache::beginTocPass() {
     spineFile.close();
     return false;
   }
+  spineReader.reset(new serialization::BufferedReader(spineFile));
+  tocWriter.reset(new serialization::BufferedWriter(tocFile));
 
   if (spineCount >= LARGE_SPINE_THRESHOLD) {
     spineHrefIndex.clear();
     spineHrefIndex.reserve(spineCount);
-    spineFile.seek(0);
+    spineReader->seek(0);
     for (int i = 0; i < spineCount; i++) {
-      auto entry = readSpineEntry(spineFile);
+      auto entry = readSpineEntry(*spineReader);
       SpineHrefIndexEntry idx;
       idx.hrefHash = fnvHash64(entry.href);
       idx.hrefLen = static_cast<uint16_t>(entry.href.size());
@@ -64,7 +73,7 @@ bool BookMetadataCache::beginTocPass() {
               [](const SpineHrefIndexEntry& a, const SpineHrefIndexEntry& b) {
                 return a.hrefHash < b.hrefHash || (a.hrefHash == b.hrefHash && a.hrefLen < b.hrefLen);
               });
-    spineFile.seek(0);
+    spineReader->seek(0);
     useSpineHrefIndex = true;
     LOG_DBG("BMC", "Using fast index for %d spine items", spineCount);
   } else {
@@ -75,6 +84,9 @@ bool BookMetadataCache::beginTocPass() {
 }
 
 bool BookMetadataCache::endTocPass() {
+  const bool written = tocWriter && tocWriter->flush();
+  tocWriter.reset();
+  spineReader.reset();
   tocFile.close();
   spineFile.close();
 
@@ -82,7 +94,7 @@ bool BookMetadataCache::endTocPass() {
   spineHrefIndex.shrink_to_fit();
   useSpineHrefIndex = false;
 
-  return true;
+  return written;
 }
 
 bool BookMetadataCache::endWrite() {
@@ -96,9 +108,11 @@ bool BookMetadataCache::endWrite() {
   return true;
 }
 
-bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMetadata& metadata) {
-  // Open all three files, writing to meta, reading from spine and toc
-  if (!Storage.openFileForWrite("BMC", cachePath + bookBinFile, bookFile)) {
+bool BookMetadataCache::buildBookBin(const std::string& epubPath, const std::string& zipIndexPath,
+                                     const BookMetadata& metadata) {
+  // Open all three files, writing to meta, reading from spine and toc. book.bin is written under a temporary name and
+  // only replaces the old one once complete.
+  if (!Storage.openFileForWrite("BMC", cachePath + tmpBookBinFile, bookFile)) {
     return false;
   }
 
@@ -113,6 +127,11 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     return false;
   }
 
+  // Heap, not stack: three sector buffers are a lot for the task this runs on
+  auto book = std::unique_ptr<serialization::BufferedWriter>(new serialization::BufferedWriter(bookFile));
+  auto spine = std::unique_ptr<serialization::BufferedReader>(new serialization::BufferedReader(spineFile));
+  auto toc = std::unique_ptr<serialization::BufferedReader>(new serialization::BufferedReader(tocFile));
+
   constexpr uint32_t headerASize =
       sizeof(BOOK_CACHE_VERSION) + /* LUT Offset */ sizeof(uint32_t) + sizeof(spineCount) + sizeof(tocCount);
   const uint32_t metadataSize = metadata.title.size() + metadata.author.size() + metadata.language.size() +
@@ -122,31 +141,31 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
   const uint32_t lutOffset = headerASize + metadataSize;
 
   // Header A
-  serialization::writePod(bookFile, BOOK_CACHE_VERSION);
-  serialization::writePod(bookFile, lutOffset);
-  serialization::writePod(bookFile, spineCount);
-  serialization::writePod(bookFile, tocCount);
+  serialization::writePod(*book, BOOK_CACHE_VERSION);
+  serialization::writePod(*book, lutOffset);
+  serialization::writePod(*book, spineCount);
+  serialization::writePod(*book, tocCount);
   // Metadata
-  serialization::writeString(bookFile, metadata.title);
-  serialization::writeString(bookFile, metadata.author);
-  serialization::writeString(bookFile, metadata.language);
-  serialization::writeString(bookFile, metadata.coverItemHref);
-  serialization::writeString(bookFile, metadata.textReferenceHref);
+  serialization::writeString(*book, metadata.title);
+  serialization::writeString(*book, metadata.author);
+  serialization::writeString(*book, metadata.language);
+  serialization::writeString(*book, metadata.coverItemHref);
+  serialization::writeString(*book, metadata.textReferenceHref);
 
   // Loop through spine entries, writing LUT positions
-  spineFile.seek(0);
+  spine->seek(0);
   for (int i = 0; i < spineCount; i++) {
-    uint32_t pos = spineFile.position();
-    auto spineEntry = readSpineEntry(spineFile);
-    serialization::writePod(bookFile, pos + lutOffset + lutSize);
+    uint32_t pos = spine->position();
+    auto spineEntry = readSpineEntry(*spine);
+    serialization::writePod(*book, pos + lutOffset + lutSize);
   }
 
   // Loop through toc entries, writing LUT positions
-  tocFile.seek(0);
+  toc->seek(0);
   for (int i = 0; i < tocCount; i++) {
-    uint32_t pos = tocFile.position();
-    auto tocEntry = readTocEntry(tocFile);
-    serialization::writePod(bookFile, pos + lutOffset + lutSize + static_cast<uint32_t>(spineFile.position()));
+    uint32_t pos = toc->position();
+    auto tocEntry = readTocEntry(*toc);
+    serialization::writePod(*book, pos + lutOffset + lutSize + static_cast<uint32_t>(spine->position()));
   }
 
   // LUTs complete
@@ -154,9 +173,9 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
 
   // Build spineIndex->tocIndex mapping in one pass (O(n) instead of O(n*m))
   std::vector<int16_t> spineToTocIndex(spineCount, -1);
-  tocFile.seek(0);
+  toc->seek(0);
   for (int j = 0; j < tocCount; j++) {
-    auto tocEntry = readTocEntry(tocFile);
+    auto tocEntry = readTocEntry(*toc);
     if (tocEntry.spineIndex >= 0 && tocEntry.spineIndex < spineCount) {
       if (spineToTocIndex[tocEntry.spineIndex] == -1) {
         spineToTocIndex[tocEntry.spineIndex] = static_cast<int16_t>(j);
@@ -164,13 +183,15 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     }
   }
 
-  ZipFile zip(epubPath);
+  ZipFile zip(epubPath, zipIndexPath);
   // Pre-open zip file to speed up size calculations
   if (!zip.open()) {
     LOG_ERR("BMC", "Could not open EPUB zip for size calculations");
+    book.reset();
     bookFile.close();
     spineFile.close();
     tocFile.close();
+    Storage.remove((cachePath + tmpBookBinFile).c_str());
     return false;
   }
   // NOTE: We intentionally skip calling loadAllFileStatSlims() here.
@@ -190,9 +211,9 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     std::vector<ZipFile::SizeTarget> targets;
     targets.reserve(spineCount);
 
-    spineFile.seek(0);
+    spine->seek(0);
     for (int i = 0; i < spineCount; i++) {
-      auto entry = readSpineEntry(spineFile);
+      auto entry = readSpineEntry(*spine);
       std::string path = FsHelpers::normalisePath(entry.href);
 
       ZipFile::SizeTarget t;
@@ -217,10 +238,10 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
   }
 
   uint32_t cumSize = 0;
-  spineFile.seek(0);
+  spine->seek(0);
   int lastSpineTocIndex = -1;
   for (int i = 0; i < spineCount; i++) {
-    auto spineEntry = readSpineEntry(spineFile);
+    auto spineEntry = readSpineEntry(*spine);
 
     spineEntry.tocIndex = spineToTocIndex[i];
 
@@ -253,21 +274,32 @@ bool BookMetadataCache::buildBookBin(const std::string& epubPath, const BookMeta
     spineEntry.cumulativeSize = cumSize;
 
     // Write out spine data to book.bin
-    writeSpineEntry(bookFile, spineEntry);
+    writeSpineEntry(*book, spineEntry);
   }
   // Close opened zip file
   zip.close();
 
   // Loop through toc entries from toc file writing to book.bin
-  tocFile.seek(0);
+  toc->seek(0);
   for (int i = 0; i < tocCount; i++) {
-    auto tocEntry = readTocEntry(tocFile);
-    writeTocEntry(bookFile, tocEntry);
+    auto tocEntry = readTocEntry(*toc);
+    writeTocEntry(*book, tocEntry);
   }
 
-  bookFile.close();
+  // The trailer vouches for everything load() reads up front: header, metadata and both LUTs
+  uint32_t crc = 0;
+  const bool sealed = book->flush() && serialization::crc32(bookFile, 0, lutOffset + lutSize, crc) &&
+                      serialization::writeTrailer(bookFile, crc);
+  book.reset();
+  const bool closed = bookFile.close();
   spineFile.close();
   tocFile.close();
+  if (!sealed || !closed ||
+      !Storage.replace((cachePath + tmpBookBinFile).c_str(), (cachePath + bookBinFile).c_str())) {
+    LOG_ERR("BMC", "Failed to write book.bin");
+    Storage.remove((cachePath + tmpBookBinFile).c_str());
+    return false;
+  }
 
   LOG_DBG("BMC", "Successfully built book.bin");
   return true;
@@ -280,10 +312,13 @@ bool BookMetadataCache::cleanupTmpFiles() const {
   if (Storage.exists((cachePath + tmpTocBinFile).c_str())) {
     Storage.remove((cachePath + tmpTocBinFile).c_str());
   }
+  if (Storage.exists((cachePath + tmpBookBinFile).c_str())) {
+    Storage.remove((cachePath + tmpBookBinFile).c_str());
+  }
   return true;
 }
 
-uint32_t BookMetadataCache::writeSpineEntry(FsFile& file, const SpineEntry& entry) const {
+uint32_t BookMetadataCache::writeSpineEntry(serialization::BufferedWriter& file, const SpineEntry& entry) const {
   const uint32_t pos = file.position();
   serialization::writeString(file, entry.href);
   serialization::writePod(file, entry.cumulativeSize);
@@ -291,7 +326,7 @@ uint32_t BookMetadataCache::writeSpineEntry(FsFile& file, const SpineEntry& entr
   return pos;
 }
 
-uint32_t BookMetadataCache::writeTocEntry(FsFile& file, const TocEntry& entry) const {
+uint32_t BookMetadataCache::writeTocEntry(serialization::BufferedWriter& file, const TocEntry& entry) const {
   const uint32_t pos = file.position();
   serialization::writeString(file, entry.title);
   serialization::writeString(file, entry.href);
@@ -304,19 +339,19 @@ uint32_t BookMetadataCache::writeTocEntry(FsFile& file, const TocEntry& entry) c
 // Note: for the LUT to be accurate, this **MUST** be called for all spine items before `addTocEntry` is ever called
 // this is because in this function we're marking positions of the items
 void BookMetadataCache::createSpineEntry(const std::string& href) {
-  if (!buildMode || !spineFile) {
+  if (!buildMode || !spineFile || !spineWriter) {
     LOG_DBG("BMC", "createSpineEntry called but not in build mode");
     return;
   }
 
   const SpineEntry entry(href, 0, -1);
-  writeSpineEntry(spineFile, entry);
+  writeSpineEntry(*spineWriter, entry);
   spineCount++;
 }
 
 void BookMetadataCache::createTocEntry(const std::string& title, const std::string& href, const std::string& anchor,
                                        const uint8_t level) {
-  if (!buildMode || !tocFile || !spineFile) {
+  if (!buildMode || !tocFile || !spineFile || !tocWriter || !spineReader) {
     LOG_DBG("BMC", "createTocEntry called but not in build mode");
     return;
   }
@@ -342,9 +377,9 @@ void BookMetadataCache::createTocEntry(const std::string& title, const std::stri
       LOG_DBG("BMC", "createTocEntry: Could not find spine item for TOC href %s", href.c_str());
     }
   } else {
-    spineFile.seek(0);
+    spineReader->seek(0);
     for (int i = 0; i < spineCount; i++) {
-      auto spineEntry = readSpineEntry(spineFile);
+      auto spineEntry = readSpineEntry(*spineReader);
       if (spineEntry.href == href) {
         spineIndex = static_cast<int16_t>(i);
         break;
@@ -356,7 +391,7 @@ void BookMetadataCache::createTocEntry(const std::string& title, const std::stri
   }
 
   const TocEntry entry(title, href, anchor, level, spineIndex);
-  writeTocEntry(tocFile, entry);
+  writeTocEntry(*tocWriter, entry);
   tocCount++;
 }
 
@@ -366,24 +401,41 @@ bool BookMetadataCache::load() {
   if (!Storage.openFileForRead("BMC", cachePath + bookBinFile, bookFile)) {
     return false;
   }
+  bookReader.reset(new serialization::BufferedReader(bookFile));
 
   uint8_t version;
-  serialization::readPod(bookFile, version);
+  serialization::readPod(*bookReader, version);
   if (version != BOOK_CACHE_VERSION) {
     LOG_DBG("BMC", "Cache version mismatch: expected %d, got %d", BOOK_CACHE_VERSION, version);
+    bookReader.reset();
     bookFile.close();
     return false;
   }
 
-  serialization::readPod(bookFile, lutOffset);
-  serialization::readPod(bookFile, spineCount);
-  serialization::readPod(bookFile, tocCount);
-
-  serialization::readString(bookFile, coreMetadata.title);
-  serialization::readString(bookFile, coreMetadata.author);
-  serialization::readString(bookFile, coreMetadata.language);
-  serialization::readString(bookFile, coreMetadata.coverItemHref);
-  serialization::readString(bookFile, coreMetadata.textReferenceHref);
+  serialization::readPod(*bookReader, lutOffset);
+  serialization::readPod(*bookReader, spineCount);
+  serialization::readPod(*bookReader, tocCount);
+
+  serialization::readString(*bookReader, coreMetadata.title);
+  serialization::readString(*bookReader, coreMetadata.author);
+  serialization::readString(*bookReader, coreMetadata.language);
+  serialization::readString(*bookReader, coreMetadata.coverItemHref);
+  serialization::readString(*bookReader, coreMetadata.textReferenceHref);
+
+  // A damaged file fails here and gets rebuilt, instead of handing getSpineEntry/getTocEntry bad LUT positions
+  const uint64_t lutEnd = static_cast<uint64_t>(lutOffset) + sizeof(uint32_t) * (spineCount + tocCount);
+  uint32_t sealedCrc = 0;
+  uint32_t crc = 0;
+  if (!bookReader->ok() || lutOffset != bookReader->position() || !serialization::readTrailer(bookFile, sealedCrc) ||
+      lutEnd + sizeof(serialization::Trailer) > bookFile.size() ||
+      !serialization::crc32(bookFile, 0, lutEnd, crc) || crc != sealedCrc) {
+    LOG_ERR("BMC", "Cache file is damaged, rebuilding");
+    bookReader.reset();
+    bookFile.close();
+    return false;
+  }
+  // The checks above moved the file under the reader
+  bookReader.reset(new serialization::BufferedReader(bookFile));
 
   loaded = true;
   LOG_DBG("BMC", "Loaded cache data: %d spine, %d TOC entries", spineCount, tocCount);
@@ -401,12 +453,12 @@ BookMetadataCache::SpineEntry BookMetadataCache::getSpineEntry(const int index)
     return {};
   }
 
-  // Seek to spine LUT item, read from LUT and get out data
-  bookFile.seek(lutOffset + sizeof(uint32_t) * index);
+  // Seek to spine LUT item, read from LUT and get out data. Neighbouring lookups are usually still buffered.
+  bookReader->seek(lutOffset + sizeof(uint32_t) * index);
   uint32_t spineEntryPos;
-  serialization::readPod(bookFile, spineEntryPos);
-  bookFile.seek(spineEntryPos);
-  return readSpineEntry(bookFile);
+  serialization::readPod(*bookReader, spineEntryPos);
+  bookReader->seek(spineEntryPos);
+  return readSpineEntry(*bookReader);
 }
 
 BookMetadataCache::TocEntry BookMetadataCache::getTocEntry(const int index) {
@@ -421,14 +473,14 @@ BookMetadataCache::TocEntry BookMetadataCache::getTocEntry(const int index) {
   }
 
   // Seek to TOC LUT item, read from LUT and get out data
-  bookFile.seek(lutOffset + sizeof(uint32_t) * spineCount + sizeof(uint32_t) * index);
+  bookReader->seek(lutOffset + sizeof(uint32_t) * spineCount + sizeof(uint32_t) * index);
   uint32_t tocEntryPos;
-  serialization::readPod(bookFile, tocEntryPos);
-  bookFile.seek(tocEntryPos);
-  return readTocEntry(bookFile);
+  serialization::readPod(*bookReader, tocEntryPos);
+  bookReader->seek(tocEntryPos);
+  return readTocEntry(*bookReader);
 }
 
-BookMetadataCache::SpineEntry BookMetadataCache::readSpineEntry(FsFile& file) const {
+BookMetadataCache::SpineEntry BookMetadataCache::readSpineEntry(serialization::BufferedReader& file) const {
   SpineEntry entry;
   serialization::readString(file, entry.href);
   serialization::readPod(file, entry.cumulativeSize);
@@ -436,7 +488,7 @@ BookMetadataCache::SpineEntry BookMetadataCache::readSpineEntry(FsFile& file) co
   return entry;
 }
 
-BookMetadataCache::TocEntry BookMetadataCache::readTocEntry(FsFile& file) const {
+BookMetadataCache::TocEntry BookMetadataCache::readTocEntry(serialization::BufferedReader& file) const {
   TocEntry entry;
   serialization::readString(file, entry.title);
   serialization::readString(file, entry.href);
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <HalStorage.h>
+#include <Serialization.h>
 
 #include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -44,7 +45,7 @@ class BookMetadataCache {
 
  private:
   std::string cachePath;
-  size_t lutOffset;
+  uint32_t lutOffset;
   uint16_t spineCount;
   uint16_t tocCount;
   bool loaded;
@@ -54,6 +55,11 @@ class BookMetadataCache {
   // Temp file handles during build
   FsFile spineFile;
   FsFile tocFile;
+  // Sector buffers over the files above, held only while a phase needs them across calls
+  std::unique_ptr<serialization::BufferedReader> bookReader;
+  std::unique_ptr<serialization::BufferedWriter> spineWriter;
+  std::unique_ptr<serialization::BufferedReader> spineReader;
+  std::unique_ptr<serialization::BufferedWriter> tocWriter;
 
   // Index for fast href→spineIndex lookup (used only for large EPUBs)
   struct SpineHrefIndexEntry {
@@ -76,10 +82,10 @@ class BookMetadataCache {
     return hash;
   }
 
-  uint32_t writeSpineEntry(FsFile& file, const SpineEntry& entry) const;
-  uint32_t writeTocEntry(FsFile& file, const TocEntry& entry) const;
-  SpineEntry readSpineEntry(FsFile& file) const;
-  TocEntry readTocEntry(FsFile& file) const;
+  uint32_t writeSpineEntry(serialization::BufferedWriter& file, const SpineEntry& entry) const;
+  uint32_t writeTocEntry(serialization::BufferedWriter& file, const TocEntry& entry) const;
+  SpineEntry readSpineEntry(serialization::BufferedReader& file) const;
+  TocEntry readTocEntry(serialization::BufferedReader& file) const;
 
  public:
   BookMetadata coreMetadata;
@@ -100,7 +106,7 @@ class BookMetadataCache {
   bool cleanupTmpFiles() const;
 
   // Post-processing to update mappings and sizes
-  bool buildBookBin(const std::string& epubPath, const BookMetadata& metadata);
+  bool buildBookBin(const std::string& epubPath, const std::string& zipIndexPath, const BookMetadata& metadata);
 
   // Reading phase (read mode)
   bool load();
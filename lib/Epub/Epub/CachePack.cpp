@@ -0,0 +1,441 @@
+#include "CachePack.h"
+
+#include <Logging.h>
+#include <Serialization.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+constexpr char PACK_FILE[] = "/images.pack";
+constexpr char PACK_TMP_FILE[] = "/images.pack.tmp";
+constexpr uint32_t PACK_MAGIC = 0x4B435043;      // "CPCK"
+constexpr uint32_t RECORD_LIVE = 0x4556494C;     // "LIVE"
+constexpr uint32_t RECORD_DEAD = 0x44414544;     // "DEAD"
+constexpr uint32_t RECORD_PENDING = 0xFFFFFFFF;  // Still being appended; a pack ending in one was cut off
+constexpr uint16_t MAX_NAME_LEN = 64;
+// Compaction copies every live record into a new pack; not worth it for a few stale images
+constexpr uint32_t COMPACT_MIN_DEAD_BYTES = 256 * 1024;
+constexpr size_t COPY_CHUNK_SIZE = 4096;
+
+struct RecordHeader {
+  uint32_t state;
+  uint32_t size;
+  uint16_t nameLen;
+  uint16_t reserved;
+};
+static_assert(sizeof(RecordHeader) == 12, "RecordHeader is part of the pack format");
+
+uint32_t recordLength(const RecordHeader& header) { return sizeof(RecordHeader) + header.nameLen + header.size; }
+
+// FNV-1a
+uint32_t hashName(const char* name, const size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+  }
+  return hash;
+}
+
+// Splits "<dir>/<name>" into the pack directory and the entry name
+bool splitPath(const std::string& path, std::string& dir, std::string& name) {
+  const size_t slash = path.find_last_of('/');
+  if (slash == std::string::npos || slash + 1 == path.size() || path.size() - slash - 1 > MAX_NAME_LEN) {
+    LOG_ERR("PCK", "Not a pack entry path: %s", path.c_str());
+    return false;
+  }
+  dir = path.substr(0, slash);
+  name = path.substr(slash + 1);
+  return true;
+}
+
+// Reads the header and name of the record at `offset` in one go
+bool readRecordHead(FsFile& file, const uint32_t offset, RecordHeader& header, char* name) {
+  uint8_t buffer[sizeof(RecordHeader) + MAX_NAME_LEN];
+  if (!Storage.seek(file, offset)) {
+    return false;
+  }
+  const int n = Storage.read(file, buffer, sizeof(buffer));
+  if (n < static_cast<int>(sizeof(RecordHeader))) {
+    return false;
+  }
+  memcpy(&header, buffer, sizeof(header));
+  if (header.nameLen > MAX_NAME_LEN || n < static_cast<int>(sizeof(RecordHeader) + header.nameLen)) {
+    return false;
+  }
+  memcpy(name, buffer + sizeof(RecordHeader), header.nameLen);
+  return true;
+}
+}  // namespace
+
+std::string CachePack::loadedDir;
+std::vector<CachePack::IndexEntry> CachePack::index;
+
+/* ============= ENTRIES ================ */
+
+int CachePack::Entry::read(void* buffer, const size_t count) {
+  if (pos >= length) {
+    return 0;
+  }
+  const int n = Storage.read(file, buffer, std::min<size_t>(count, length - pos));
+  if (n > 0) {
+    pos += n;
+  }
+  return n;
+}
+
+bool CachePack::Entry::seek(const uint32_t position) {
+  if (position > length || !Storage.seek(file, dataOffset + position)) {
+    return false;
+  }
+  pos = position;
+  return true;
+}
+
+void CachePack::Entry::close() {
+  if (file) {
+    Storage.close(file);
+  }
+}
+
+CachePack::Writer::~Writer() {
+  if (file) {
+    abort();
+  }
+}
+
+size_t CachePack::Writer::write(const uint8_t* buffer, const size_t size) {
+  if (failed || !file) {
+    return 0;
+  }
+  const size_t n = Storage.write(file, buffer, size);
+  length += n;
+  if (n != size) {
+    failed = true;
+  }
+  return n;
+}
+
+bool CachePack::Writer::commit() {
+  if (!file) {
+    return false;
+  }
+  if (failed) {
+    LOG_ERR("PCK", "Failed to write entry %s", name.c_str());
+    abort();
+    return false;
+  }
+
+  // The index only covers the pack that was loaded last
+  IndexEntry* previous = nullptr;
+  const bool indexed = loadedDir == packDir;
+  if (indexed) {
+    findRecord(file, name, &previous);
+  }
+
+  // Go live before retiring the old record: if we're cut off in between, loading keeps the newer of the two
+  const RecordHeader header = {RECORD_LIVE, length, static_cast<uint16_t>(name.size()), 0};
+  bool ok = Storage.seek(file, recordOffset) && Storage.write(file, &header, sizeof(header)) == sizeof(header);
+  if (ok && previous) {
+    constexpr uint32_t dead = RECORD_DEAD;
+    ok = Storage.seek(file, previous->recordOffset) && Storage.write(file, &dead, sizeof(dead)) == sizeof(dead);
+  }
+  if (!ok) {
+    LOG_ERR("PCK", "Failed to commit entry %s", name.c_str());
+    abort();
+    return false;
+  }
+  if (!Storage.close(file)) {
+    LOG_ERR("PCK", "Failed to sync pack after %s", name.c_str());
+    return false;
+  }
+
+  if (previous) {
+    previous->recordOffset = recordOffset;
+    previous->size = length;
+  } else if (indexed) {
+    index.push_back({hashName(name.data(), name.size()), recordOffset, length});
+  }
+  return true;
+}
+
+void CachePack::Writer::abort() {
+  file.truncate(recordOffset);
+  Storage.close(file);
+}
+
+/* ============= LOOKUP ================ */
+
+bool CachePack::findRecord(FsFile& file, const std::string& name, IndexEntry** found) {
+  const uint32_t hash = hashName(name.data(), name.size());
+  RecordHeader header;
+  char recordName[MAX_NAME_LEN];
+  for (auto& entry : index) {
+    if (entry.nameHash != hash || !readRecordHead(file, entry.recordOffset, header, recordName)) {
+      continue;
+    }
+    if (header.state == RECORD_LIVE && header.nameLen == name.size() &&
+        memcmp(recordName, name.data(), name.size()) == 0) {
+      *found = &entry;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CachePack::exists(const std::string& path) {
+  Entry entry;
+  const bool found = openEntry(path, entry);
+  entry.close();
+  return found;
+}
+
+bool CachePack::openEntry(const std::string& path, Entry& entry) {
+  std::string dir, name;
+  if (!splitPath(path, dir, name) || !load(dir, false)) {
+    return false;
+  }
+
+  const uint32_t hash = hashName(name.data(), name.size());
+  if (std::none_of(index.begin(), index.end(), [hash](const IndexEntry& e) { return e.nameHash == hash; })) {
+    return false;
+  }
+
+  if (!Storage.openFileForRead("PCK", dir + PACK_FILE, entry.file)) {
+    return false;
+  }
+  IndexEntry* found = nullptr;
+  if (!findRecord(entry.file, name, &found)) {
+    entry.close();
+    return false;
+  }
+  entry.dataOffset = found->recordOffset + sizeof(RecordHeader) + name.size();
+  entry.length = found->size;
+  entry.pos = 0;
+  if (!Storage.seek(entry.file, entry.dataOffset)) {
+    entry.close();
+    return false;
+  }
+  return true;
+}
+
+bool CachePack::beginEntry(const std::string& path, Writer& writer) {
+  std::string dir, name;
+  if (!splitPath(path, dir, name) || !load(dir, false)) {
+    return false;
+  }
+
+  writer.file = Storage.open((dir + PACK_FILE).c_str(), O_RDWR | O_CREAT);
+  if (!writer.file) {
+    LOG_ERR("PCK", "Failed to open pack in %s", dir.c_str());
+    return false;
+  }
+
+  uint32_t end = writer.file.size();
+  if (end == 0) {
+    if (Storage.write(writer.file, &PACK_MAGIC, sizeof(PACK_MAGIC)) != sizeof(PACK_MAGIC)) {
+      Storage.close(writer.file);
+      return false;
+    }
+    end = sizeof(PACK_MAGIC);
+  }
+
+  writer.packDir = dir;
+  writer.name = name;
+  writer.recordOffset = end;
+  writer.length = 0;
+  writer.failed = false;
+
+  const RecordHeader header = {RECORD_PENDING, 0, static_cast<uint16_t>(name.size()), 0};
+  if (!Storage.seek(writer.file, end) || Storage.write(writer.file, &header, sizeof(header)) != sizeof(header) ||
+      Storage.write(writer.file, name.data(), name.size()) != name.size()) {
+    LOG_ERR("PCK", "Failed to start entry %s", path.c_str());
+    writer.abort();
+    return false;
+  }
+  return true;
+}
+
+/* ============= LOADING ================ */
+
+void CachePack::release(const std::string& cacheDir) {
+  if (loadedDir != cacheDir) {
+    return;
+  }
+  loadedDir.clear();
+  index.clear();
+  index.shrink_to_fit();
+}
+
+bool CachePack::open(const std::string& cacheDir) {
+  // Left behind by a compaction that was cut short; the pack itself is still the one before it
+  const std::string tmpPath = cacheDir + PACK_TMP_FILE;
+  if (Storage.exists(tmpPath.c_str())) {
+    Storage.remove(tmpPath.c_str());
+  }
+  return load(cacheDir, true);
+}
+
+bool CachePack::load(const std::string& dir, const bool compactDead) {
+  if (dir == loadedDir) {
+    return true;
+  }
+  release(loadedDir);
+
+  const std::string packPath = dir + PACK_FILE;
+  if (Storage.exists(packPath.c_str())) {
+    uint32_t liveBytes, deadBytes;
+    if (!scan(packPath, liveBytes, deadBytes)) {
+      return false;
+    }
+    if (compactDead && deadBytes > liveBytes && deadBytes >= COMPACT_MIN_DEAD_BYTES) {
+      LOG_DBG("PCK", "Compacting %s: %lu live, %lu dead bytes", packPath.c_str(), static_cast<unsigned long>(liveBytes),
+              static_cast<unsigned long>(deadBytes));
+      // A failed compaction leaves the pack as it was; read its index again
+      if (!compact(dir) && !scan(packPath, liveBytes, deadBytes)) {
+        index.clear();
+        return false;
+      }
+    }
+  }
+
+  loadedDir = dir;
+  LOG_DBG("PCK", "Loaded %zu entries from %s", index.size(), packPath.c_str());
+  return true;
+}
+
+bool CachePack::scan(const std::string& packPath, uint32_t& liveBytes, uint32_t& deadBytes) {
+  FsFile file;
+  if (!Storage.openFileForRead("PCK", packPath, file)) {
+    return false;
+  }
+
+  index.clear();
+  liveBytes = 0;
+  deadBytes = 0;
+  const uint32_t fileSize = file.size();
+  uint32_t offset = 0;
+  {
+    serialization::BufferedReader reader(file);
+    uint32_t magic = 0;
+    if (reader.read(&magic, sizeof(magic)) && magic == PACK_MAGIC) {
+      offset = sizeof(magic);
+    } else {
+      LOG_ERR("PCK", "Bad pack header in %s", packPath.c_str());
+    }
+
+    RecordHeader header;
+    char name[MAX_NAME_LEN];
+    char otherName[MAX_NAME_LEN];
+    while (offset > 0 && offset + sizeof(RecordHeader) <= fileSize) {
+      if (!reader.seek(offset) || !reader.read(&header, sizeof(header))) {
+        break;
+      }
+      if ((header.state != RECORD_LIVE && header.state != RECORD_DEAD) || header.nameLen == 0 ||
+          header.nameLen > MAX_NAME_LEN || offset + recordLength(header) > fileSize) {
+        break;
+      }
+
+      if (header.state == RECORD_DEAD) {
+        deadBytes += recordLength(header);
+        offset += recordLength(header);
+        continue;
+      }
+      if (!reader.read(name, header.nameLen)) {
+        break;
+      }
+
+      // An earlier live record of the same name is one we were cut off before retiring
+      const uint32_t hash = hashName(name, header.nameLen);
+      IndexEntry* replaced = nullptr;
+      for (auto& entry : index) {
+        if (entry.nameHash == hash && reader.seek(entry.recordOffset + sizeof(RecordHeader)) &&
+            reader.read(otherName, header.nameLen) && memcmp(name, otherName, header.nameLen) == 0) {
+          replaced = &entry;
+          break;
+        }
+      }
+      if (replaced) {
+        const uint32_t replacedLength = sizeof(RecordHeader) + header.nameLen + replaced->size;
+        liveBytes -= replacedLength;
+        deadBytes += replacedLength;
+        replaced->recordOffset = offset;
+        replaced->size = header.size;
+      } else {
+        index.push_back({hash, offset, header.size});
+      }
+      liveBytes += recordLength(header);
+      offset += recordLength(header);
+    }
+  }
+  Storage.close(file);
+
+  if (offset < fileSize) {
+    LOG_ERR("PCK", "Dropping %lu bytes of unreadable records from %s", static_cast<unsigned long>(fileSize - offset),
+            packPath.c_str());
+    FsFile rw = Storage.open(packPath.c_str(), O_RDWR);
+    if (!rw || !rw.truncate(offset)) {
+      LOG_ERR("PCK", "Failed to truncate %s", packPath.c_str());
+      index.clear();
+      return false;
+    }
+    Storage.close(rw);
+  }
+  return true;
+}
+
+bool CachePack::compact(const std::string& dir) {
+  const std::string packPath = dir + PACK_FILE;
+  const std::string tmpPath = dir + PACK_TMP_FILE;
+  FsFile in, out;
+  if (!Storage.openFileForRead("PCK", packPath, in)) {
+    return false;
+  }
+  if (!Storage.openFileForWrite("PCK", tmpPath, out)) {
+    Storage.close(in);
+    return false;
+  }
+  auto* buffer = static_cast<uint8_t*>(malloc(COPY_CHUNK_SIZE));
+  if (!buffer) {
+    LOG_ERR("PCK", "Failed to allocate compaction buffer");
+    Storage.close(out);
+    Storage.close(in);
+    Storage.remove(tmpPath.c_str());
+    return false;
+  }
+
+  // Copy the live records the scan found into a new pack, in file order so the old one is read front to back. The
+  // old pack stays untouched until the new one is complete, so a compaction cut short loses nothing.
+  std::sort(index.begin(), index.end(),
+            [](const IndexEntry& a, const IndexEntry& b) { return a.recordOffset < b.recordOffset; });
+  bool ok = Storage.write(out, &PACK_MAGIC, sizeof(PACK_MAGIC)) == sizeof(PACK_MAGIC);
+  uint32_t writePos = sizeof(PACK_MAGIC);
+  for (auto& entry : index) {
+    RecordHeader header;
+    ok = ok && Storage.seek(in, entry.recordOffset) && Storage.read(in, &header, sizeof(header)) == sizeof(header) &&
+         Storage.write(out, &header, sizeof(header)) == sizeof(header);
+    if (!ok) {
+      break;
+    }
+    const uint32_t length = recordLength(header) - sizeof(RecordHeader);
+    for (uint32_t done = 0; ok && done < length;) {
+      const size_t n = std::min<size_t>(COPY_CHUNK_SIZE, length - done);
+      ok = Storage.read(in, buffer, n) == static_cast<int>(n) && Storage.write(out, buffer, n) == n;
+      done += n;
+    }
+    entry.recordOffset = writePos;
+    writePos += recordLength(header);
+  }
+  free(buffer);
+  Storage.close(in);
+
+  ok = Storage.close(out) && ok;
+  if (!ok || !Storage.replace(tmpPath.c_str(), packPath.c_str())) {
+    LOG_ERR("PCK", "Failed to compact %s", packPath.c_str());
+    Storage.remove(tmpPath.c_str());
+    return false;
+  }
+  LOG_DBG("PCK", "Compacted %s to %lu bytes", packPath.c_str(), static_cast<unsigned long>(writePos));
+  return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <HalStorage.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A book's extracted images and their pixel caches, kept in one append-only file in the book's cache directory
+// instead of a FAT file each. Image-heavy books otherwise leave hundreds of small files behind: every open scans
+// the directory, every file wastes most of a cluster, and clearing the cache deletes them one by one.
+//
+// Callers keep using the paths the loose files had ("<cache dir>/img_3_0.jpg"): the directory picks the pack, the
+// file name is the entry name. Writing an entry appends a record and marks an older record of the same name dead in
+// place. A pack whose dead records outweigh its live ones is compacted when its book is opened: the live records are
+// copied into images.pack.tmp, which replaces the pack once it is complete.
+//
+// The index of the most recently used pack is kept in RAM, 12 bytes per entry. Packs are only touched from the
+// render task, and from open() before a book's first render.
+class CachePack {
+ public:
+  // One entry, read like a file of its own
+  class Entry {
+   public:
+    int read(void* buffer, size_t count);
+    bool seek(uint32_t position);
+    uint32_t position() const { return pos; }
+    uint32_t size() const { return length; }
+    void close();
+    explicit operator bool() const { return static_cast<bool>(file); }
+
+   private:
+    friend class CachePack;
+    FsFile file;
+    uint32_t dataOffset = 0;
+    uint32_t length = 0;
+    uint32_t pos = 0;
+  };
+
+  // Appends one entry. It replaces an older entry of the same name on commit(); without a commit it is dropped.
+  class Writer final : public Print {
+   public:
+    Writer() = default;
+    ~Writer() override;
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    using Print::write;
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    bool commit();
+
+   private:
+    friend class CachePack;
+    FsFile file;
+    std::string packDir;
+    std::string name;
+    uint32_t recordOffset = 0;
+    uint32_t length = 0;
+    bool failed = false;
+
+    void abort();
+  };
+
+  // Loads the index of the pack in `cacheDir`, compacting the pack first if it needs it. Call when the book is
+  // opened; entry lookups load a pack too, but never compact it, so a page render doesn't pay for it.
+  static bool open(const std::string& cacheDir);
+  static bool exists(const std::string& path);
+  static bool openEntry(const std::string& path, Entry& entry);
+  static bool beginEntry(const std::string& path, Writer& writer);
+  // Drops the in-RAM index if it belongs to `cacheDir`; call before deleting the directory
+  static void release(const std::string& cacheDir);
+
+ private:
+  struct IndexEntry {
+    uint32_t nameHash;
+    uint32_t recordOffset;
+    uint32_t size;
+  };
+
+  static std::string loadedDir;
+  static std::vector<IndexEntry> index;
+
+  static bool load(const std::string& dir, bool compactDead);
+  static bool scan(const std::string& packPath, uint32_t& liveBytes, uint32_t& deadBytes);
+  // Rewrites the pack in `dir` with only the records in the index, and points the index at their new offsets
+  static bool compact(const std::string& dir);
+  static bool findRecord(FsFile& file, const std::string& name, IndexEntry** found);
+};
@@ -1,5 +1,6 @@
 #include "Page.h"
 
+#include <GfxRenderer.h>
 #include <Logging.h>
 #include <Serialization.h>
 
@@ -7,7 +8,11 @@ void PageLine::render(GfxRenderer& renderer, const int fontId, const int xOffset
   block->render(renderer, fontId, xPos + xOffset, yPos + yOffset);
 }
 
-bool PageLine::serialize(FsFile& file) {
+void PageLine::collectGlyphs(const GfxRenderer& renderer, const int fontId, FontDecompressor::PrewarmSet& set) const {
+  block->collectGlyphs(renderer, fontId, set);
+}
+
+bool PageLine::serialize(serialization::BufferedWriter& file) {
   serialization::writePod(file, xPos);
   serialization::writePod(file, yPos);
 
@@ -15,13 +20,16 @@ bool PageLine::serialize(FsFile& file) {
   return block->serialize(file);
 }
 
-std::unique_ptr<PageLine> PageLine::deserialize(FsFile& file) {
+std::unique_ptr<PageLine> PageLine::deserialize(serialization::BufferedReader& file) {
   int16_t xPos;
   int16_t yPos;
   serialization::readPod(file, xPos);
   serialization::readPod(file, yPos);
 
   auto tb = TextBlock::deserialize(file);
+  if (!tb) {
+    return nullptr;
+  }
   return std::unique_ptr<PageLine>(new PageLine(std::move(tb), xPos, yPos));
 }
 
@@ -30,7 +38,7 @@ void PageImage::render(GfxRenderer& renderer, const int fontId, const int xOffse
   imageBlock->render(renderer, xPos + xOffset, yPos + yOffset);
 }
 
-bool PageImage::serialize(FsFile& file) {
+bool PageImage::serialize(serialization::BufferedWriter& file) {
   serialization::writePod(file, xPos);
   serialization::writePod(file, yPos);
 
@@ -38,7 +46,7 @@ bool PageImage::serialize(FsFile& file) {
   return imageBlock->serialize(file);
 }
 
-std::unique_ptr<PageImage> PageImage::deserialize(FsFile& file) {
+std::unique_ptr<PageImage> PageImage::deserialize(serialization::BufferedReader& file) {
   int16_t xPos;
   int16_t yPos;
   serialization::readPod(file, xPos);
@@ -54,7 +62,31 @@ void Page::render(GfxRenderer& renderer, const int fontId, const int xOffset, co
   }
 }
 
-bool Page::serialize(FsFile& file) const {
+void Page::renderImages(GfxRenderer& renderer, const int xOffset, const int yOffset) const {
+  for (auto& element : elements) {
+    if (element->getTag() == TAG_PageImage) {
+      element->render(renderer, 0, xOffset, yOffset);
+    }
+  }
+}
+
+uint16_t Page::prewarmGlyphs(const GfxRenderer& renderer, const int fontId) const {
+  FontDecompressor::PrewarmSet set;
+  for (const auto& element : elements) {
+    element->collectGlyphs(renderer, fontId, set);
+  }
+  return renderer.prewarmFontCache(set);
+}
+
+size_t Page::glyphCount() const {
+  size_t count = 0;
+  for (const auto& element : elements) {
+    count += element->glyphCount();
+  }
+  return count;
+}
+
+bool Page::serialize(serialization::BufferedWriter& file) const {
   const uint16_t count = elements.size();
   serialization::writePod(file, count);
 
@@ -70,7 +102,7 @@ bool Page::serialize(FsFile& file) const {
   return true;
 }
 
-std::unique_ptr<Page> Page::deserialize(FsFile& file) {
+std::unique_ptr<Page> Page::deserialize(serialization::BufferedReader& file) {
   auto page = std::unique_ptr<Page>(new Page());
 
   uint16_t count;
@@ -82,6 +114,10 @@ std::unique_ptr<Page> Page::deserialize(FsFile& file) {
 
     if (tag == TAG_PageLine) {
       auto pl = PageLine::deserialize(file);
+      if (!pl) {
+        LOG_ERR("PGE", "Deserialization failed: Invalid text line");
+        return nullptr;
+      }
       page->elements.push_back(std::move(pl));
     } else if (tag == TAG_PageImage) {
       auto pi = PageImage::deserialize(file);
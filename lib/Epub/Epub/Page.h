@@ -1,5 +1,5 @@
 #pragma once
-#include <HalStorage.h>
+#include <Serialization.h>
 
 #include <algorithm>
 #include <utility>
@@ -21,7 +21,9 @@ class PageElement {
   explicit PageElement(const int16_t xPos, const int16_t yPos) : xPos(xPos), yPos(yPos) {}
   virtual ~PageElement() = default;
   virtual void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) = 0;
-  virtual bool serialize(FsFile& file) = 0;
+  virtual void collectGlyphs(const GfxRenderer& renderer, int fontId, FontDecompressor::PrewarmSet& set) const {}
+  virtual size_t glyphCount() const { return 0; }
+  virtual bool serialize(serialization::BufferedWriter& file) = 0;
   virtual PageElementTag getTag() const = 0;  // Add type identification
 };
 
@@ -33,9 +35,11 @@ class PageLine final : public PageElement {
   PageLine(std::shared_ptr<TextBlock> block, const int16_t xPos, const int16_t yPos)
       : PageElement(xPos, yPos), block(std::move(block)) {}
   void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) override;
-  bool serialize(FsFile& file) override;
+  void collectGlyphs(const GfxRenderer& renderer, int fontId, FontDecompressor::PrewarmSet& set) const override;
+  size_t glyphCount() const override { return block->glyphCount(); }
+  bool serialize(serialization::BufferedWriter& file) override;
   PageElementTag getTag() const override { return TAG_PageLine; }
-  static std::unique_ptr<PageLine> deserialize(FsFile& file);
+  static std::unique_ptr<PageLine> deserialize(serialization::BufferedReader& file);
 };
 
 // New PageImage class
@@ -46,9 +50,9 @@ class PageImage final : public PageElement {
   PageImage(std::shared_ptr<ImageBlock> block, const int16_t xPos, const int16_t yPos)
       : PageElement(xPos, yPos), imageBlock(std::move(block)) {}
   void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) override;
-  bool serialize(FsFile& file) override;
+  bool serialize(serialization::BufferedWriter& file) override;
   PageElementTag getTag() const override { return TAG_PageImage; }
-  static std::unique_ptr<PageImage> deserialize(FsFile& file);
+  static std::unique_ptr<PageImage> deserialize(serialization::BufferedReader& file);
   const ImageBlock& getImageBlock() const { return *imageBlock; }
 };
 
@@ -57,8 +61,15 @@ class Page {
   // the list of block index and line numbers on this page
   std::vector<std::shared_ptr<PageElement>> elements;
   void render(GfxRenderer& renderer, int fontId, int xOffset, int yOffset) const;
-  bool serialize(FsFile& file) const;
-  static std::unique_ptr<Page> deserialize(FsFile& file);
+  // Draw only the image elements, for planes whose text is replayed from a GlyphDisplayList
+  void renderImages(GfxRenderer& renderer, int xOffset, int yOffset) const;
+  // Warm the font decompressor with every glyph group the page's text needs, before the first render pass.
+  // Returns the number of expected cache misses while drawing (0 when the whole set fits).
+  uint16_t prewarmGlyphs(const GfxRenderer& renderer, int fontId) const;
+  // Glyphs render() draws, for sizing a GlyphDisplayList up front
+  size_t glyphCount() const;
+  bool serialize(serialization::BufferedWriter& file) const;
+  static std::unique_ptr<Page> deserialize(serialization::BufferedReader& file);
 
   // Check if page contains any images (used to force full refresh)
   bool hasImages() const {
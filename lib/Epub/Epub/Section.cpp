@@ -3,6 +3,7 @@
 #include <HalStorage.h>
 #include <Logging.h>
 #include <Serialization.h>
+#include <StorageStats.h>
 
 #include "Epub/css/CssParser.h"
 #include "Page.h"
@@ -10,20 +11,23 @@
 #include "parsers/ChapterHtmlSlimParser.h"
 
 namespace {
-constexpr uint8_t SECTION_FILE_VERSION = 13;
+constexpr uint8_t SECTION_FILE_VERSION = 17;
+// Section files come out larger than the chapter's XHTML (positions and glyph runs for every word); the reserve
+// errs high so most builds stay inside their contiguous run
+constexpr uint32_t SECTION_BYTES_PER_HTML_BYTE = 3;
 constexpr uint32_t HEADER_SIZE = sizeof(uint8_t) + sizeof(int) + sizeof(float) + sizeof(bool) + sizeof(uint8_t) +
                                  sizeof(uint16_t) + sizeof(uint16_t) + sizeof(uint16_t) + sizeof(bool) + sizeof(bool) +
                                  sizeof(uint32_t);
 }  // namespace
 
-uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
+uint32_t Section::onPageComplete(serialization::BufferedWriter& writer, std::unique_ptr<Page> page) {
   if (!file) {
     LOG_ERR("SCT", "File not open for writing page %d", pageCount);
     return 0;
   }
 
-  const uint32_t position = file.position();
-  if (!page->serialize(file)) {
+  const uint32_t position = writer.position();
+  if (!page->serialize(writer)) {
     LOG_ERR("SCT", "Failed to serialize page %d", pageCount);
     return 0;
   }
@@ -33,7 +37,8 @@ uint32_t Section::onPageComplete(std::unique_ptr<Page> page) {
   return position;
 }
 
-void Section::writeSectionFileHeader(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
+void Section::writeSectionFileHeader(serialization::BufferedWriter& writer, const int fontId,
+                                     const float lineCompression, const bool extraParagraphSpacing,
                                      const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                      const uint16_t viewportHeight, const bool hyphenationEnabled,
                                      const bool embeddedStyle) {
@@ -46,17 +51,17 @@ void Section::writeSectionFileHeader(const int fontId, const float lineCompressi
                                    sizeof(viewportHeight) + sizeof(pageCount) + sizeof(hyphenationEnabled) +
                                    sizeof(embeddedStyle) + sizeof(uint32_t),
                 "Header size mismatch");
-  serialization::writePod(file, SECTION_FILE_VERSION);
-  serialization::writePod(file, fontId);
-  serialization::writePod(file, lineCompression);
-  serialization::writePod(file, extraParagraphSpacing);
-  serialization::writePod(file, paragraphAlignment);
-  serialization::writePod(file, viewportWidth);
-  serialization::writePod(file, viewportHeight);
-  serialization::writePod(file, hyphenationEnabled);
-  serialization::writePod(file, embeddedStyle);
-  serialization::writePod(file, pageCount);  // Placeholder for page count (will be initially 0 when written)
-  serialization::writePod(file, static_cast<uint32_t>(0));  // Placeholder for LUT offset
+  serialization::writePod(writer, SECTION_FILE_VERSION);
+  serialization::writePod(writer, fontId);
+  serialization::writePod(writer, lineCompression);
+  serialization::writePod(writer, extraParagraphSpacing);
+  serialization::writePod(writer, paragraphAlignment);
+  serialization::writePod(writer, viewportWidth);
+  serialization::writePod(writer, viewportHeight);
+  serialization::writePod(writer, hyphenationEnabled);
+  serialization::writePod(writer, embeddedStyle);
+  serialization::writePod(writer, pageCount);  // Placeholder for page count (will be initially 0 when written)
+  serialization::writePod(writer, static_cast<uint32_t>(0));  // Placeholder for LUT offset
 }
 
 bool Section::loadSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
@@ -65,11 +70,12 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
   if (!Storage.openFileForRead("SCT", filePath, file)) {
     return false;
   }
+  serialization::BufferedReader reader(file);
 
   // Match parameters
   {
     uint8_t version;
-    serialization::readPod(file, version);
+    serialization::readPod(reader, version);
     if (version != SECTION_FILE_VERSION) {
       file.close();
       LOG_ERR("SCT", "Deserialization failed: Unknown version %u", version);
@@ -84,14 +90,14 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
     uint8_t fileParagraphAlignment;
     bool fileHyphenationEnabled;
     bool fileEmbeddedStyle;
-    serialization::readPod(file, fileFontId);
-    serialization::readPod(file, fileLineCompression);
-    serialization::readPod(file, fileExtraParagraphSpacing);
-    serialization::readPod(file, fileParagraphAlignment);
-    serialization::readPod(file, fileViewportWidth);
-    serialization::readPod(file, fileViewportHeight);
-    serialization::readPod(file, fileHyphenationEnabled);
-    serialization::readPod(file, fileEmbeddedStyle);
+    serialization::readPod(reader, fileFontId);
+    serialization::readPod(reader, fileLineCompression);
+    serialization::readPod(reader, fileExtraParagraphSpacing);
+    serialization::readPod(reader, fileParagraphAlignment);
+    serialization::readPod(reader, fileViewportWidth);
+    serialization::readPod(reader, fileViewportHeight);
+    serialization::readPod(reader, fileHyphenationEnabled);
+    serialization::readPod(reader, fileEmbeddedStyle);
 
     if (fontId != fileFontId || lineCompression != fileLineCompression ||
         extraParagraphSpacing != fileExtraParagraphSpacing || paragraphAlignment != fileParagraphAlignment ||
@@ -104,7 +110,24 @@ bool Section::loadSectionFile(const int fontId, const float lineCompression, con
     }
   }
 
-  serialization::readPod(file, pageCount);
+  serialization::readPod(reader, pageCount);
+  uint32_t lutOffset;
+  serialization::readPod(reader, lutOffset);
+
+  // Builds only ever land here complete; the trailer catches a file damaged after that before loadPage trusts the LUT
+  const uint64_t lutEnd = static_cast<uint64_t>(lutOffset) + sizeof(uint32_t) * pageCount;
+  uint32_t sealedCrc = 0;
+  uint32_t crc = 0;
+  if (!serialization::readTrailer(file, sealedCrc) || lutOffset < HEADER_SIZE ||
+      lutEnd + sizeof(serialization::Trailer) != file.size() || !serialization::crc32(file, 0, HEADER_SIZE, crc) ||
+      !serialization::crc32(file, lutOffset, lutEnd - lutOffset, crc) || crc != sealedCrc) {
+    file.close();
+    LOG_ERR("SCT", "Deserialization failed: Section file is damaged");
+    pageCount = 0;
+    clearCache();
+    return false;
+  }
+
   file.close();
   LOG_DBG("SCT", "Deserialization succeeded: %d pages", pageCount);
   return true;
@@ -129,7 +152,9 @@ bool Section::clearCache() const {
 bool Section::createSectionFile(const int fontId, const float lineCompression, const bool extraParagraphSpacing,
                                 const uint8_t paragraphAlignment, const uint16_t viewportWidth,
                                 const uint16_t viewportHeight, const bool hyphenationEnabled, const bool embeddedStyle,
-                                const std::function<void()>& popupFn) {
+                                const std::function<void()>& popupFn,
+                                const std::function<bool()>& cancelFn) {
+  StorageStats::Scope ioScope(StorageStats::Tag::SectionBuild);
   const auto localPath = epub->getSpineItem(spineIndex).href;
   const auto tmpHtmlPath = epub->getCachePath() + "/.tmp_" + std::to_string(spineIndex) + ".html";
 
@@ -139,6 +164,11 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     Storage.mkdir(sectionsDir.c_str());
   }
 
+  size_t itemSize = 0;
+  if (!epub->getItemSize(localPath, &itemSize)) {
+    itemSize = 0;
+  }
+
   // Retry logic for SD card timing issues
   bool success = false;
   uint32_t fileSize = 0;
@@ -157,8 +187,11 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
     if (!Storage.openFileForWrite("SCT", tmpHtmlPath, tmpHtml)) {
       continue;
     }
+    // One contiguous run keeps the parse below a sequential read
+    Storage.preAllocate(tmpHtml, itemSize);
     success = epub->readItemContentsToStream(localPath, tmpHtml, 1024);
-    fileSize = tmpHtml.size();
+    fileSize = tmpHtml.position();
+    success = success && Storage.truncate(tmpHtml, fileSize);
     tmpHtml.close();
 
     // If streaming failed, remove the incomplete file immediately
@@ -175,10 +208,18 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
 
   LOG_DBG("SCT", "Streamed temp HTML to %s (%d bytes)", tmpHtmlPath.c_str(), fileSize);
 
-  if (!Storage.openFileForWrite("SCT", filePath, file)) {
+  // Built under a temporary name so a reset mid-build never leaves a partial section file at filePath
+  const auto tmpFilePath = filePath + ".tmp";
+  if (!Storage.openFileForWrite("SCT", tmpFilePath, file)) {
     return false;
   }
-  writeSectionFileHeader(fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
+  // Page reads seek all over the section file; in one contiguous run they don't have to walk a cluster chain
+  const bool preAllocated = Storage.preAllocate(file, static_cast<uint64_t>(fileSize) * SECTION_BYTES_PER_HTML_BYTE);
+  if (!preAllocated) {
+    LOG_DBG("SCT", "No contiguous run for section file, allocating as it grows");
+  }
+  serialization::BufferedWriter writer(file);
+  writeSectionFileHeader(writer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
                          viewportHeight, hyphenationEnabled, embeddedStyle);
   std::vector<uint32_t> lut = {};
 
@@ -200,8 +241,10 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   ChapterHtmlSlimParser visitor(
       epub, tmpHtmlPath, renderer, fontId, lineCompression, extraParagraphSpacing, paragraphAlignment, viewportWidth,
       viewportHeight, hyphenationEnabled,
-      [this, &lut](std::unique_ptr<Page> page) { lut.emplace_back(this->onPageComplete(std::move(page))); },
-      embeddedStyle, contentBase, imageBasePath, popupFn, cssParser);
+      [this, &lut, &writer](std::unique_ptr<Page> page) {
+        lut.emplace_back(this->onPageComplete(writer, std::move(page)));
+      },
+      embeddedStyle, contentBase, imageBasePath, popupFn, cssParser, cancelFn);
   Hyphenator::setPreferredLanguage(epub->getLanguage());
   success = visitor.parseAndBuildPages();
 
@@ -209,14 +252,14 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
   if (!success) {
     LOG_ERR("SCT", "Failed to parse XML and build pages");
     file.close();
-    Storage.remove(filePath.c_str());
+    Storage.remove(tmpFilePath.c_str());
     if (cssParser) {
       cssParser->clear();
     }
     return false;
   }
 
-  const uint32_t lutOffset = file.position();
+  const uint32_t lutOffset = writer.position();
   bool hasFailedLutRecords = false;
   // Write LUT
   for (const uint32_t& pos : lut) {
@@ -224,41 +267,59 @@ bool Section::createSectionFile(const int fontId, const float lineCompression, c
       hasFailedLutRecords = true;
       break;
     }
-    serialization::writePod(file, pos);
+    serialization::writePod(writer, pos);
   }
+  const uint32_t sectionSize = writer.position();
 
   if (hasFailedLutRecords) {
     LOG_ERR("SCT", "Failed to write LUT due to invalid page positions");
     file.close();
-    Storage.remove(filePath.c_str());
+    Storage.remove(tmpFilePath.c_str());
     return false;
   }
 
   // Go back and write LUT offset
-  file.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
-  serialization::writePod(file, pageCount);
-  serialization::writePod(file, lutOffset);
-  file.close();
+  writer.seek(HEADER_SIZE - sizeof(uint32_t) - sizeof(pageCount));
+  serialization::writePod(writer, pageCount);
+  serialization::writePod(writer, lutOffset);
+  uint32_t crc = 0;
+  const bool sealed = writer.flush() && (!preAllocated || Storage.truncate(file, sectionSize)) &&
+                      serialization::crc32(file, 0, HEADER_SIZE, crc) &&
+                      serialization::crc32(file, lutOffset, sectionSize - lutOffset, crc) &&
+                      serialization::writeTrailer(file, crc);
+  const bool closed = file.close();
+  if (!sealed || !closed || !Storage.replace(tmpFilePath.c_str(), filePath.c_str())) {
+    LOG_ERR("SCT", "Failed to write section file");
+    Storage.remove(tmpFilePath.c_str());
+    if (cssParser) {
+      cssParser->clear();
+    }
+    return false;
+  }
   if (cssParser) {
     cssParser->clear();
   }
   return true;
 }
 
-std::unique_ptr<Page> Section::loadPageFromSectionFile() {
+std::unique_ptr<Page> Section::loadPage(const int pageIndex) {
+  if (pageIndex < 0 || pageIndex >= pageCount) {
+    return nullptr;
+  }
   if (!Storage.openFileForRead("SCT", filePath, file)) {
     return nullptr;
   }
 
-  file.seek(HEADER_SIZE - sizeof(uint32_t));
+  serialization::BufferedReader reader(file);
+  reader.seek(HEADER_SIZE - sizeof(uint32_t));
   uint32_t lutOffset;
-  serialization::readPod(file, lutOffset);
-  file.seek(lutOffset + sizeof(uint32_t) * currentPage);
+  serialization::readPod(reader, lutOffset);
+  reader.seek(lutOffset + sizeof(uint32_t) * pageIndex);
   uint32_t pagePos;
-  serialization::readPod(file, pagePos);
-  file.seek(pagePos);
+  serialization::readPod(reader, pagePos);
+  reader.seek(pagePos);
 
-  auto page = Page::deserialize(file);
+  auto page = Page::deserialize(reader);
   file.close();
   return page;
 }
@@ -1,4 +1,6 @@
 #pragma once
+#include <Serialization.h>
+
 #include <functional>
 #include <memory>
 
@@ -14,10 +16,10 @@ class Section {
   std::string filePath;
   FsFile file;
 
-  void writeSectionFileHeader(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
-                              uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled,
-                              bool embeddedStyle);
-  uint32_t onPageComplete(std::unique_ptr<Page> page);
+  void writeSectionFileHeader(serialization::BufferedWriter& writer, int fontId, float lineCompression,
+                              bool extraParagraphSpacing, uint8_t paragraphAlignment, uint16_t viewportWidth,
+                              uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle);
+  uint32_t onPageComplete(serialization::BufferedWriter& writer, std::unique_ptr<Page> page);
 
  public:
   uint16_t pageCount = 0;
@@ -34,6 +36,8 @@ class Section {
   bool clearCache() const;
   bool createSectionFile(int fontId, float lineCompression, bool extraParagraphSpacing, uint8_t paragraphAlignment,
                          uint16_t viewportWidth, uint16_t viewportHeight, bool hyphenationEnabled, bool embeddedStyle,
-                         const std::function<void()>& popupFn = nullptr);
-  std::unique_ptr<Page> loadPageFromSectionFile();
+                         const std::function<void()>& popupFn = nullptr,
+                         const std::function<bool()>& cancelFn = nullptr);
+  std::unique_ptr<Page> loadPageFromSectionFile() { return loadPage(currentPage); }
+  std::unique_ptr<Page> loadPage(int pageIndex);
 };
@@ -5,6 +5,7 @@
 #include <SDCardManager.h>
 #include <Serialization.h>
 
+#include "../CachePack.h"
 #include "../converters/DitherUtils.h"
 #include "../converters/ImageDecoderFactory.h"
 
@@ -16,7 +17,7 @@
 ImageBlock::ImageBlock(const std::string& imagePath, int16_t width, int16_t height)
     : imagePath(imagePath), width(width), height(height) {}
 
-bool ImageBlock::imageExists() const { return Storage.exists(imagePath.c_str()); }
+bool ImageBlock::imageExists() const { return CachePack::exists(imagePath); }
 
 namespace {
 
@@ -31,8 +32,8 @@ std::string getCachePath(const std::string& imagePath) {
 
 bool renderFromCache(GfxRenderer& renderer, const std::string& cachePath, int x, int y, int expectedWidth,
                      int expectedHeight) {
-  FsFile cacheFile;
-  if (!Storage.openFileForRead("IMG", cachePath, cacheFile)) {
+  CachePack::Entry cacheFile;
+  if (!CachePack::openEntry(cachePath, cacheFile)) {
     return false;
   }
 
@@ -114,8 +115,8 @@ void ImageBlock::render(GfxRenderer& renderer, const int x, const int y) {
 
   // No cache - need to decode the image
   // Check if image file exists
-  FsFile file;
-  if (!Storage.openFileForRead("IMG", imagePath, file)) {
+  CachePack::Entry file;
+  if (!CachePack::openEntry(imagePath, file)) {
     LOG_ERR("IMG", "Image file not found: %s", imagePath.c_str());
     return;
   }
@@ -157,14 +158,14 @@ void ImageBlock::render(GfxRenderer& renderer, const int x, const int y) {
   LOG_DBG("IMG", "Decode successful");
 }
 
-bool ImageBlock::serialize(FsFile& file) {
+bool ImageBlock::serialize(serialization::BufferedWriter& file) {
   serialization::writeString(file, imagePath);
   serialization::writePod(file, width);
   serialization::writePod(file, height);
   return true;
 }
 
-std::unique_ptr<ImageBlock> ImageBlock::deserialize(FsFile& file) {
+std::unique_ptr<ImageBlock> ImageBlock::deserialize(serialization::BufferedReader& file) {
   std::string path;
   serialization::readString(file, path);
   int16_t w, h;
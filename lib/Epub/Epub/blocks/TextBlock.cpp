@@ -41,7 +41,28 @@ void TextBlock::render(const GfxRenderer& renderer, const int fontId, const int
   }
 }
 
-bool TextBlock::serialize(FsFile& file) const {
+void TextBlock::collectGlyphs(const GfxRenderer& renderer, const int fontId, FontDecompressor::PrewarmSet& set) const {
+  if (words.size() != wordStyles.size()) {
+    return;
+  }
+
+  for (size_t i = 0; i < words.size(); i++) {
+    renderer.collectTextGlyphs(fontId, words[i].c_str(), wordStyles[i], set);
+  }
+}
+
+size_t TextBlock::glyphCount() const {
+  // One glyph per codepoint: count the bytes that start one
+  size_t codepoints = 0;
+  for (const auto& word : words) {
+    for (const char c : word) {
+      codepoints += (static_cast<uint8_t>(c) & 0xC0) != 0x80;
+    }
+  }
+  return codepoints;
+}
+
+bool TextBlock::serialize(serialization::BufferedWriter& file) const {
   if (words.size() != wordXpos.size() || words.size() != wordStyles.size()) {
     LOG_ERR("TXB", "Serialization failed: size mismatch (words=%u, xpos=%u, styles=%u)\n", words.size(),
             wordXpos.size(), wordStyles.size());
@@ -71,7 +92,7 @@ bool TextBlock::serialize(FsFile& file) const {
   return true;
 }
 
-std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
+std::unique_ptr<TextBlock> TextBlock::deserialize(serialization::BufferedReader& file) {
   uint16_t wc;
   std::vector<std::string> words;
   std::vector<uint16_t> wordXpos;
@@ -109,6 +130,11 @@ std::unique_ptr<TextBlock> TextBlock::deserialize(FsFile& file) {
   serialization::readPod(file, blockStyle.textIndent);
   serialization::readPod(file, blockStyle.textIndentDefined);
 
+  if (!file.ok()) {
+    LOG_ERR("TXB", "Deserialization failed: block runs past the end of the file");
+    return nullptr;
+  }
+
   return std::unique_ptr<TextBlock>(
       new TextBlock(std::move(words), std::move(wordXpos), std::move(wordStyles), blockStyle));
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <EpdFontFamily.h>
-#include <HalStorage.h>
+#include <FontDecompressor.h>
+#include <Serialization.h>
 
 #include <memory>
 #include <string>
@@ -30,7 +31,10 @@ class TextBlock final : public Block {
   bool isEmpty() override { return words.empty(); }
   // given a renderer works out where to break the words into lines
   void render(const GfxRenderer& renderer, int fontId, int x, int y) const;
+  void collectGlyphs(const GfxRenderer& renderer, int fontId, FontDecompressor::PrewarmSet& set) const;
+  // Glyphs render() draws, one per codepoint
+  size_t glyphCount() const;
   BlockType getType() override { return TEXT_BLOCK; }
-  bool serialize(FsFile& file) const;
-  static std::unique_ptr<TextBlock> deserialize(FsFile& file);
+  bool serialize(serialization::BufferedWriter& file) const;
+  static std::unique_ptr<TextBlock> deserialize(serialization::BufferedReader& file);
 };
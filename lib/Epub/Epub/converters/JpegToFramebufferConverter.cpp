@@ -9,20 +9,21 @@
 #include <cstdio>
 #include <cstring>
 
+#include "../CachePack.h"
 #include "DitherUtils.h"
 #include "PixelCache.h"
 
 struct JpegContext {
-  FsFile& file;
+  CachePack::Entry& file;
   uint8_t buffer[512];
   size_t bufferPos;
   size_t bufferFilled;
-  JpegContext(FsFile& f) : file(f), bufferPos(0), bufferFilled(0) {}
+  JpegContext(CachePack::Entry& f) : file(f), bufferPos(0), bufferFilled(0) {}
 };
 
 bool JpegToFramebufferConverter::getDimensionsStatic(const std::string& imagePath, ImageDimensions& out) {
-  FsFile file;
-  if (!Storage.openFileForRead("JPG", imagePath, file)) {
+  CachePack::Entry file;
+  if (!CachePack::openEntry(imagePath, file)) {
     LOG_ERR("JPG", "Failed to open file for dimensions: %s", imagePath.c_str());
     return false;
   }
@@ -48,8 +49,8 @@ bool JpegToFramebufferConverter::decodeToFramebuffer(const std::string& imagePat
                                                      const RenderConfig& config) {
   LOG_DBG("JPG", "Decoding JPEG: %s", imagePath.c_str());
 
-  FsFile file;
-  if (!Storage.openFileForRead("JPG", imagePath, file)) {
+  CachePack::Entry file;
+  if (!CachePack::openEntry(imagePath, file)) {
     LOG_ERR("JPG", "Failed to open file: %s", imagePath.c_str());
     return false;
   }
@@ -7,6 +7,8 @@
 #include <cstring>
 #include <string>
 
+#include "../CachePack.h"
+
 // Cache buffer for storing 2-bit pixels (4 levels) during decode.
 // Packs 4 pixels per byte, MSB first.
 struct PixelCache {
@@ -56,18 +58,20 @@ struct PixelCache {
   bool writeToFile(const std::string& cachePath) {
     if (!buffer) return false;
 
-    FsFile cacheFile;
-    if (!Storage.openFileForWrite("IMG", cachePath, cacheFile)) {
+    CachePack::Writer cacheFile;
+    if (!CachePack::beginEntry(cachePath, cacheFile)) {
       LOG_ERR("IMG", "Failed to open cache file for writing: %s", cachePath.c_str());
       return false;
     }
 
     uint16_t w = width;
     uint16_t h = height;
-    cacheFile.write(&w, 2);
-    cacheFile.write(&h, 2);
+    cacheFile.write(reinterpret_cast<const uint8_t*>(&w), 2);
+    cacheFile.write(reinterpret_cast<const uint8_t*>(&h), 2);
     cacheFile.write(buffer, bytesPerRow * height);
-    cacheFile.close();
+    if (!cacheFile.commit()) {
+      return false;
+    }
 
     LOG_DBG("IMG", "Cache written: %s (%dx%d, %d bytes)", cachePath.c_str(), width, height, 4 + bytesPerRow * height);
     return true;
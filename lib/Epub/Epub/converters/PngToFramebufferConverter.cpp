@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <new>
 
+#include "../CachePack.h"
 #include "DitherUtils.h"
 #include "PixelCache.h"
 
@@ -16,7 +17,7 @@ namespace {
 
 // Context struct passed through PNGdec callbacks to avoid global mutable state.
 // The draw callback receives this via pDraw->pUser (set by png.decode()).
-// The file I/O callbacks receive the FsFile* via pFile->fHandle (set by pngOpen()).
+// The file I/O callbacks receive the CachePack::Entry* via pFile->fHandle (set by pngOpen()).
 struct PngContext {
   GfxRenderer* renderer;
   const RenderConfig* config;
@@ -51,11 +52,11 @@ struct PngContext {
         grayLineBuffer(nullptr) {}
 };
 
-// File I/O callbacks use pFile->fHandle to access the FsFile*,
+// File I/O callbacks use pFile->fHandle to access the CachePack::Entry*,
 // avoiding the need for global file state.
 void* pngOpenWithHandle(const char* filename, int32_t* size) {
-  FsFile* f = new FsFile();
-  if (!Storage.openFileForRead("PNG", std::string(filename), *f)) {
+  auto* f = new CachePack::Entry();
+  if (!CachePack::openEntry(std::string(filename), *f)) {
     delete f;
     return nullptr;
   }
@@ -64,7 +65,7 @@ void* pngOpenWithHandle(const char* filename, int32_t* size) {
 }
 
 void pngCloseWithHandle(void* handle) {
-  FsFile* f = reinterpret_cast<FsFile*>(handle);
+  auto* f = reinterpret_cast<CachePack::Entry*>(handle);
   if (f) {
     f->close();
     delete f;
@@ -72,13 +73,13 @@ void pngCloseWithHandle(void* handle) {
 }
 
 int32_t pngReadWithHandle(PNGFILE* pFile, uint8_t* pBuf, int32_t len) {
-  FsFile* f = reinterpret_cast<FsFile*>(pFile->fHandle);
+  auto* f = reinterpret_cast<CachePack::Entry*>(pFile->fHandle);
   if (!f) return 0;
   return f->read(pBuf, len);
 }
 
 int32_t pngSeekWithHandle(PNGFILE* pFile, int32_t pos) {
-  FsFile* f = reinterpret_cast<FsFile*>(pFile->fHandle);
+  auto* f = reinterpret_cast<CachePack::Entry*>(pFile->fHandle);
   if (!f) return -1;
   return f->seek(pos);
 }
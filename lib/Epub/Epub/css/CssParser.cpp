@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include <Logging.h>
+#include <Serialization.h>
 
 #include <algorithm>
 #include <array>
@@ -637,6 +638,7 @@ CssStyle CssParser::parseInlineStyle(const std::string& styleValue) { return par
 
 // Cache file name (version is CssParser::CSS_CACHE_VERSION)
 constexpr char rulesCache[] = "/css_rules.cache";
+constexpr char tmpRulesCache[] = "/css_rules.cache.tmp";
 
 bool CssParser::hasCache() const { return Storage.exists((cachePath + rulesCache).c_str()); }
 
@@ -650,7 +652,7 @@ bool CssParser::saveToCache() const {
   }
 
   FsFile file;
-  if (!Storage.openFileForWrite("CSS", cachePath + rulesCache, file)) {
+  if (!Storage.openFileForWrite("CSS", cachePath + tmpRulesCache, file)) {
     return false;
   }
 
@@ -713,8 +715,17 @@ bool CssParser::saveToCache() const {
     file.write(reinterpret_cast<const uint8_t*>(&definedBits), sizeof(definedBits));
   }
 
+  // Sealed over the whole file, which loadFromCache reads through anyway
+  uint32_t crc = 0;
+  const bool sealed = serialization::crc32(file, 0, file.size(), crc) && serialization::writeTrailer(file, crc);
+  const bool closed = file.close();
+  if (!sealed || !closed || !Storage.replace((cachePath + tmpRulesCache).c_str(), (cachePath + rulesCache).c_str())) {
+    LOG_ERR("CSS", "Failed to write rules cache");
+    Storage.remove((cachePath + tmpRulesCache).c_str());
+    return false;
+  }
+
   LOG_DBG("CSS", "Saved %u rules to cache", ruleCount);
-  file.close();
   return true;
 }
 
@@ -731,6 +742,17 @@ bool CssParser::loadFromCache() {
   // Clear existing rules
   clear();
 
+  uint32_t sealedCrc = 0;
+  uint32_t crc = 0;
+  if (!serialization::readTrailer(file, sealedCrc) ||
+      !serialization::crc32(file, 0, file.size() - sizeof(serialization::Trailer), crc) || crc != sealedCrc ||
+      !Storage.seek(file, 0)) {
+    LOG_DBG("CSS", "Cache file is damaged, removing it for rebuild");
+    file.close();
+    Storage.remove((cachePath + rulesCache).c_str());
+    return false;
+  }
+
   // Read and verify version
   uint8_t version = 0;
   if (file.read(&version, 1) != 1 || version != CssParser::CSS_CACHE_VERSION) {
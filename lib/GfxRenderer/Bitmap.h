@@ -1,6 +1,7 @@
 #pragma once
 
 #include <HalStorage.h>
+#include <Serialization.h>
 
 #include <cstdint>
 
@@ -68,6 +69,8 @@ class Bitmap {
   ~Bitmap();
   BmpReaderError parseHeaders();
   BmpReaderError readNextRow(uint8_t* data, uint8_t* rowBuffer) const;
+  // Move past the next row without decoding it. Error-diffusion dithering simply carries on with the next row read.
+  BmpReaderError skipNextRow() const;
   BmpReaderError rewindToData() const;
   int getWidth() const { return width; }
   int getHeight() const { return height; }
@@ -76,12 +79,18 @@ class Bitmap {
   int getRowBytes() const { return rowBytes; }
   bool is1Bit() const { return bpp == 1; }
   uint16_t getBpp() const { return bpp; }
+  bool isDithered() const { return dithering; }
+  uint32_t getFileSize() const { return file.fileSize(); }
+  // FAT modify date << 16 | time, 0 when the file system doesn't say
+  uint32_t getModifiedStamp() const;
 
  private:
-  static uint16_t readLE16(FsFile& f);
-  static uint32_t readLE32(FsFile& f);
+  static uint16_t readLE16(serialization::BufferedReader& f);
+  static uint32_t readLE32(serialization::BufferedReader& f);
 
   FsFile& file;
+  // Rows are mostly far smaller than a sector, so they are read through a buffer. Allocated by parseHeaders().
+  mutable serialization::BufferedReader* reader = nullptr;
   bool dithering = false;
   int width = 0;
   int height = 0;
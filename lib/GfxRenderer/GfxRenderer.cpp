@@ -3,6 +3,8 @@
 #include <Logging.h>
 #include <Utf8.h>
 
+#include <cstring>
+
 const uint8_t* GfxRenderer::getGlyphBitmap(const EpdFontData* fontData, const EpdGlyph* glyph) const {
   if (fontData->groups != nullptr) {
     if (!fontDecompressor) {
@@ -23,7 +25,10 @@ void GfxRenderer::begin() {
   }
 }
 
-void GfxRenderer::insertFont(const int fontId, EpdFontFamily font) { fontMap.insert({fontId, font}); }
+void GfxRenderer::insertFont(const int fontId, EpdFontFamily font) {
+  fontMap.insert({fontId, font});
+  truncatedTextCache.clear();
+}
 
 // Translate logical (x,y) coordinates to physical panel coordinates based on current orientation
 // This should always be inlined for better performance
@@ -59,25 +64,332 @@ static inline void rotateCoordinates(const GfxRenderer::Orientation orientation,
   }
 }
 
+// Inverse of rotateCoordinates: physical panel coordinates back to logical ones
+static inline void unrotateCoordinates(const GfxRenderer::Orientation orientation, const int phyX, const int phyY,
+                                       int* x, int* y) {
+  switch (orientation) {
+    case GfxRenderer::Portrait:
+      *x = HalDisplay::DISPLAY_HEIGHT - 1 - phyY;
+      *y = phyX;
+      break;
+    case GfxRenderer::LandscapeClockwise:
+      *x = HalDisplay::DISPLAY_WIDTH - 1 - phyX;
+      *y = HalDisplay::DISPLAY_HEIGHT - 1 - phyY;
+      break;
+    case GfxRenderer::PortraitInverted:
+      *x = phyY;
+      *y = HalDisplay::DISPLAY_WIDTH - 1 - phyX;
+      break;
+    case GfxRenderer::LandscapeCounterClockwise:
+      *x = phyX;
+      *y = phyY;
+      break;
+  }
+}
+
+// Panel rectangle (inclusive) in whole frame buffer bytes per row; bits outside left..right on the edge bytes
+// belong to the neighbours and are masked off when the bytes are written back
+struct PhysicalRect {
+  int left;
+  int top;
+  int right;
+  int bottom;
+
+  int byteX() const { return left / 8; }
+  int widthBytes() const { return right / 8 - left / 8 + 1; }
+  int rows() const { return bottom - top + 1; }
+  size_t size() const { return static_cast<size_t>(widthBytes()) * rows(); }
+  bool fullWidth() const { return left == 0 && right == HalDisplay::DISPLAY_WIDTH - 1; }
+  uint8_t firstMask() const { return 0xFF >> (left & 7); }
+  uint8_t lastMask() const { return 0xFF << (7 - (right & 7)); }
+};
+
+// Bounding box on the panel of a logical rectangle, clipped to the panel; false if nothing is left
+static bool toPhysicalRect(const GfxRenderer::Orientation orientation, const int x, const int y, const int width,
+                           const int height, PhysicalRect* out) {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  // Map two opposite corners to the panel and take their bounding box
+  int phyX1 = 0, phyY1 = 0, phyX2 = 0, phyY2 = 0;
+  rotateCoordinates(orientation, x, y, &phyX1, &phyY1);
+  rotateCoordinates(orientation, x + width - 1, y + height - 1, &phyX2, &phyY2);
+  out->left = std::max(0, std::min(phyX1, phyX2));
+  out->top = std::max(0, std::min(phyY1, phyY2));
+  out->right = std::min<int>(HalDisplay::DISPLAY_WIDTH - 1, std::max(phyX1, phyX2));
+  out->bottom = std::min<int>(HalDisplay::DISPLAY_HEIGHT - 1, std::max(phyY1, phyY2));
+  return out->left <= out->right && out->top <= out->bottom;
+}
+
+// Write one row of a PhysicalRect back, keeping the neighbours' bits of the edge bytes
+static void mergeRectRow(uint8_t* dst, const uint8_t* row, const PhysicalRect& rect) {
+  const int widthBytes = rect.widthBytes();
+  if (widthBytes == 1) {
+    const uint8_t mask = rect.firstMask() & rect.lastMask();
+    dst[0] = (dst[0] & ~mask) | (row[0] & mask);
+    return;
+  }
+  dst[0] = (dst[0] & ~rect.firstMask()) | (row[0] & rect.firstMask());
+  memcpy(dst + 1, row + 1, widthBytes - 2);
+  dst[widthBytes - 1] = (dst[widthBytes - 1] & ~rect.lastMask()) | (row[widthBytes - 1] & rect.lastMask());
+}
+
 enum class TextRotation { None, Rotated90CW };
 
+// Span blitter for upright glyphs that are fully on screen.
+// Each glyph row is decoded into a 1bpp mask of the pixels to touch (already filtered for the render mode), then
+// written straight into the framebuffer: whole bytes in the landscape orientations, where a glyph row is a panel row,
+// and one precomputed bit stepped along a panel column in the portrait orientations. No per-pixel rotation or bounds
+// checks, and the resulting framebuffer is identical to the drawPixel path.
+namespace {
+constexpr int GLYPH_ROW_MASK_BYTES = 32;  // EpdGlyph::width is a uint8_t
+
+// Packed 2-bit font byte (4 pixels) -> 4-bit mask of the pixels each render mode draws, MSB first.
+// Raw font value: 0 -> white, 1 -> light gray, 2 -> dark gray, 3 -> black (see renderGlyphImpl).
+struct TwoBitRowLut {
+  uint8_t nibble[3][256];
+};
+
+constexpr TwoBitRowLut makeTwoBitRowLut() {
+  TwoBitRowLut lut{};
+  for (int mode = 0; mode < 3; mode++) {
+    for (int packed = 0; packed < 256; packed++) {
+      uint8_t nibble = 0;
+      for (int p = 0; p < 4; p++) {
+        const int raw = (packed >> ((3 - p) * 2)) & 0x3;
+        const bool draw = mode == GfxRenderer::BW              ? raw != 0
+                          : mode == GfxRenderer::GRAYSCALE_MSB ? (raw == 1 || raw == 2)
+                                                               : raw == 2;
+        if (draw) nibble |= 0x8 >> p;
+      }
+      lut.nibble[mode][packed] = nibble;
+    }
+  }
+  return lut;
+}
+
+constexpr TwoBitRowLut TWO_BIT_ROW_LUT = makeTwoBitRowLut();
+
+inline uint8_t reverseBits(uint8_t b) {
+  b = static_cast<uint8_t>((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+  b = static_cast<uint8_t>((b & 0xCC) >> 2 | (b & 0x33) << 2);
+  return static_cast<uint8_t>((b & 0xAA) >> 1 | (b & 0x55) << 1);
+}
+
+// Decode one glyph row into `mask`, MSB first. Bits past `width` are zero. Returns false if the row is empty.
+template <bool is2Bit>
+bool decodeGlyphRow(const uint8_t* bitmap, const int pixelPosition, const int width, const GfxRenderer::RenderMode mode,
+                    uint8_t* mask) {
+  uint8_t any = 0;
+  if constexpr (is2Bit) {
+    const uint8_t* lut = TWO_BIT_ROW_LUT.nibble[mode];
+    const uint8_t* src = bitmap + (pixelPosition >> 2);
+    const int shift = (pixelPosition & 3) * 2;
+    for (int glyphX = 0; glyphX < width; glyphX += 4, src++) {
+      const int remaining = width - glyphX;
+      uint8_t packed = static_cast<uint8_t>(src[0] << shift);
+      // Only touch the next byte when this group of 4 actually spills into it
+      if (shift && remaining > 4 - shift / 2) packed |= src[1] >> (8 - shift);
+      uint8_t nibble = lut[packed];
+      if (remaining < 4) nibble &= static_cast<uint8_t>(0xF << (4 - remaining));
+      if (glyphX & 4) {
+        mask[glyphX >> 3] |= nibble;
+      } else {
+        mask[glyphX >> 3] = static_cast<uint8_t>(nibble << 4);
+      }
+      any |= nibble;
+    }
+  } else {
+    const uint8_t* src = bitmap + (pixelPosition >> 3);
+    const int shift = pixelPosition & 7;
+    for (int glyphX = 0; glyphX < width; glyphX += 8, src++) {
+      const int remaining = width - glyphX;
+      uint8_t bits = static_cast<uint8_t>(src[0] << shift);
+      if (shift && remaining > 8 - shift) bits |= src[1] >> (8 - shift);
+      if (remaining < 8) bits &= static_cast<uint8_t>(0xFF << (8 - remaining));
+      mask[glyphX >> 3] = bits;
+      any |= bits;
+    }
+  }
+  return any != 0;
+}
+
+// Mirror a decoded row mask in place, so bit 0 becomes bit width - 1
+void reverseRowMask(uint8_t* mask, const int width) {
+  const int bytes = (width + 7) >> 3;
+  const int pad = (bytes << 3) - width;
+  for (int i = 0, j = bytes - 1; i < j; i++, j--) {
+    const uint8_t tmp = reverseBits(mask[i]);
+    mask[i] = reverseBits(mask[j]);
+    mask[j] = tmp;
+  }
+  if (bytes & 1) mask[bytes >> 1] = reverseBits(mask[bytes >> 1]);
+  if (pad) {
+    // The padding bits ended up in front; shift the whole row left to drop them
+    for (int i = 0; i < bytes; i++) {
+      const uint8_t next = i + 1 < bytes ? mask[i + 1] : 0;
+      mask[i] = static_cast<uint8_t>(mask[i] << pad | next >> (8 - pad));
+    }
+  }
+}
+
+// OR (set) or AND-NOT (clear) a row mask into a panel row starting at physical bit `phyX`
+template <bool set>
+void writeRowSpan(uint8_t* row, const int phyX, const uint8_t* mask, const int width) {
+  const int shift = phyX & 7;
+  uint8_t* dst = row + (phyX >> 3);
+  const int bytes = (width + 7) >> 3;
+  for (int i = 0; i < bytes; i++) {
+    const uint8_t m = mask[i];
+    if (!m) continue;
+    const uint8_t hi = m >> shift;
+    const uint8_t lo = shift ? static_cast<uint8_t>(m << (8 - shift)) : 0;
+    if constexpr (set) {
+      dst[i] |= hi;
+      if (lo) dst[i + 1] |= lo;
+    } else {
+      dst[i] &= ~hi;
+      if (lo) dst[i + 1] &= ~lo;
+    }
+  }
+}
+
+// Write a row mask down a panel column, one bit per row, stepping `stride` bytes per logical pixel
+template <bool set>
+void writeColumnSpan(uint8_t* first, const uint8_t bit, const int stride, const uint8_t* mask, const int width) {
+  for (int glyphX = 0; glyphX < width; glyphX += 8) {
+    const uint8_t m = mask[glyphX >> 3];
+    if (!m) continue;
+    int offset = glyphX * stride;
+    for (uint8_t probe = 0x80; probe; probe >>= 1, offset += stride) {
+      if (!(m & probe)) continue;
+      if constexpr (set) {
+        first[offset] |= bit;
+      } else {
+        first[offset] &= ~bit;
+      }
+    }
+  }
+}
+
+template <GfxRenderer::Orientation orientation, bool is2Bit, bool set>
+void blitGlyph(uint8_t* frameBuffer, const uint8_t* bitmap, const int width, const int height, const int x0,
+               const int y0, const GfxRenderer::RenderMode mode) {
+  constexpr int W = HalDisplay::DISPLAY_WIDTH;
+  constexpr int H = HalDisplay::DISPLAY_HEIGHT;
+  constexpr int WB = HalDisplay::DISPLAY_WIDTH_BYTES;
+  constexpr bool reverse = orientation == GfxRenderer::LandscapeClockwise;
+  uint8_t mask[GLYPH_ROW_MASK_BYTES];
+
+  for (int glyphY = 0; glyphY < height; glyphY++) {
+    if (!decodeGlyphRow<is2Bit>(bitmap, glyphY * width, width, mode, mask)) {
+      continue;
+    }
+    if constexpr (reverse) {
+      reverseRowMask(mask, width);
+    }
+    const int y = y0 + glyphY;
+    if constexpr (orientation == GfxRenderer::LandscapeCounterClockwise) {
+      writeRowSpan<set>(frameBuffer + y * WB, x0, mask, width);
+    } else if constexpr (orientation == GfxRenderer::LandscapeClockwise) {
+      writeRowSpan<set>(frameBuffer + (H - 1 - y) * WB, W - x0 - width, mask, width);
+    } else if constexpr (orientation == GfxRenderer::Portrait) {
+      // phyX = y, phyY = H - 1 - x: each glyph pixel moves one panel row up
+      writeColumnSpan<set>(frameBuffer + (H - 1 - x0) * WB + (y >> 3), 0x80 >> (y & 7), -WB, mask, width);
+    } else {
+      // PortraitInverted: phyX = W - 1 - y, phyY = x: each glyph pixel moves one panel row down
+      const int phyX = W - 1 - y;
+      writeColumnSpan<set>(frameBuffer + x0 * WB + (phyX >> 3), 0x80 >> (phyX & 7), WB, mask, width);
+    }
+  }
+}
+
+// Write a row mask (MSB first) that covers logical pixels x0 .. x0 + width - 1 of logical row y, all on screen
+template <bool set>
+void writeLogicalRow(uint8_t* frameBuffer, const GfxRenderer::Orientation orientation, const int x0, const int y,
+                     uint8_t* mask, const int width) {
+  constexpr int W = HalDisplay::DISPLAY_WIDTH;
+  constexpr int H = HalDisplay::DISPLAY_HEIGHT;
+  constexpr int WB = HalDisplay::DISPLAY_WIDTH_BYTES;
+  switch (orientation) {
+    case GfxRenderer::LandscapeCounterClockwise:
+      writeRowSpan<set>(frameBuffer + y * WB, x0, mask, width);
+      break;
+    case GfxRenderer::LandscapeClockwise:
+      reverseRowMask(mask, width);
+      writeRowSpan<set>(frameBuffer + (H - 1 - y) * WB, W - x0 - width, mask, width);
+      break;
+    case GfxRenderer::Portrait:
+      writeColumnSpan<set>(frameBuffer + (H - 1 - x0) * WB + (y >> 3), 0x80 >> (y & 7), -WB, mask, width);
+      break;
+    case GfxRenderer::PortraitInverted: {
+      const int phyX = W - 1 - y;
+      writeColumnSpan<set>(frameBuffer + x0 * WB + (phyX >> 3), 0x80 >> (phyX & 7), WB, mask, width);
+      break;
+    }
+  }
+}
+
+template <GfxRenderer::Orientation orientation>
+void blitGlyphForOrientation(uint8_t* frameBuffer, const uint8_t* bitmap, const bool is2Bit, const bool set,
+                             const int width, const int height, const int x0, const int y0,
+                             const GfxRenderer::RenderMode mode) {
+  if (is2Bit) {
+    set ? blitGlyph<orientation, true, true>(frameBuffer, bitmap, width, height, x0, y0, mode)
+        : blitGlyph<orientation, true, false>(frameBuffer, bitmap, width, height, x0, y0, mode);
+  } else {
+    set ? blitGlyph<orientation, false, true>(frameBuffer, bitmap, width, height, x0, y0, mode)
+        : blitGlyph<orientation, false, false>(frameBuffer, bitmap, width, height, x0, y0, mode);
+  }
+}
+}  // namespace
+
+// Returns false if the glyph isn't fully on screen, in which case the caller falls back to drawPixel
+static bool blitUprightGlyph(const GfxRenderer& renderer, const GfxRenderer::RenderMode renderMode,
+                             const uint8_t* bitmap, const bool is2Bit, const bool pixelState, const int width,
+                             const int height, const int x0, const int y0) {
+  if (x0 < 0 || y0 < 0 || x0 + width > renderer.getScreenWidth() || y0 + height > renderer.getScreenHeight()) {
+    return false;
+  }
+
+  // drawPixel(state=true) clears the bit (black). Grayscale planes always flag pixels by setting bits, while 1-bit
+  // glyphs keep the caller's pixel state in every mode.
+  const bool set = is2Bit ? (renderMode != GfxRenderer::BW || !pixelState) : !pixelState;
+  uint8_t* frameBuffer = renderer.getFrameBuffer();
+
+  switch (renderer.getOrientation()) {
+    case GfxRenderer::Portrait:
+      blitGlyphForOrientation<GfxRenderer::Portrait>(frameBuffer, bitmap, is2Bit, set, width, height, x0, y0,
+                                                     renderMode);
+      break;
+    case GfxRenderer::LandscapeClockwise:
+      blitGlyphForOrientation<GfxRenderer::LandscapeClockwise>(frameBuffer, bitmap, is2Bit, set, width, height, x0,
+                                                               y0, renderMode);
+      break;
+    case GfxRenderer::PortraitInverted:
+      blitGlyphForOrientation<GfxRenderer::PortraitInverted>(frameBuffer, bitmap, is2Bit, set, width, height, x0, y0,
+                                                             renderMode);
+      break;
+    case GfxRenderer::LandscapeCounterClockwise:
+      blitGlyphForOrientation<GfxRenderer::LandscapeCounterClockwise>(frameBuffer, bitmap, is2Bit, set, width,
+                                                                      height, x0, y0, renderMode);
+      break;
+  }
+  return true;
+}
+
 // Shared glyph rendering logic for normal and rotated text.
 // Coordinate mapping and cursor advance direction are selected at compile time via the template parameter.
 template <TextRotation rotation>
-static void renderCharImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode renderMode,
-                           const EpdFontFamily& fontFamily, const uint32_t cp, int* cursorX, int* cursorY,
-                           const bool pixelState, const EpdFontFamily::Style style) {
-  const EpdGlyph* glyph = fontFamily.getGlyph(cp, style);
-  if (!glyph) {
-    glyph = fontFamily.getGlyph(REPLACEMENT_GLYPH, style);
-  }
-
-  if (!glyph) {
-    LOG_ERR("GFX", "No glyph for codepoint %d", cp);
-    return;
+static void renderGlyphImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode renderMode,
+                            const EpdFontData* fontData, const EpdGlyph* glyph, int* cursorX, int* cursorY,
+                            const bool pixelState, const bool advance) {
+  if constexpr (rotation == TextRotation::None) {
+    if (GlyphDisplayList* capture = renderer.getGlyphCapture()) {
+      capture->add(fontData, glyph, *cursorX, *cursorY, pixelState);
+    }
   }
 
-  const EpdFontData* fontData = fontFamily.getData(style);
   const bool is2Bit = fontData->is2Bit;
   const uint8_t width = glyph->width;
   const uint8_t height = glyph->height;
@@ -98,7 +410,10 @@ static void renderCharImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode
       innerBase = *cursorX + left;  // screenX = innerBase + glyphX
     }
 
-    if (is2Bit) {
+    if (rotation == TextRotation::None &&
+        blitUprightGlyph(renderer, renderMode, bitmap, is2Bit, pixelState, width, height, innerBase, outerBase)) {
+      // Fast path done
+    } else if (is2Bit) {
       int pixelPosition = 0;
       for (int glyphY = 0; glyphY < height; glyphY++) {
         const int outerCoord = outerBase + glyphY;
@@ -157,7 +472,7 @@ static void renderCharImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode
     }
   }
 
-  if (!utf8IsCombiningMark(cp)) {
+  if (advance) {
     if constexpr (rotation == TextRotation::Rotated90CW) {
       *cursorY -= glyph->advanceX;
     } else {
@@ -166,6 +481,24 @@ static void renderCharImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode
   }
 }
 
+template <TextRotation rotation>
+static void renderCharImpl(const GfxRenderer& renderer, GfxRenderer::RenderMode renderMode,
+                           const EpdFontFamily& fontFamily, const uint32_t cp, int* cursorX, int* cursorY,
+                           const bool pixelState, const EpdFontFamily::Style style) {
+  const EpdGlyph* glyph = fontFamily.getGlyph(cp, style);
+  if (!glyph) {
+    glyph = fontFamily.getGlyph(REPLACEMENT_GLYPH, style);
+  }
+
+  if (!glyph) {
+    LOG_ERR("GFX", "No glyph for codepoint %d", cp);
+    return;
+  }
+
+  renderGlyphImpl<rotation>(renderer, renderMode, fontFamily.getData(style), glyph, cursorX, cursorY, pixelState,
+                            !utf8IsCombiningMark(cp));
+}
+
 // IMPORTANT: This function is in critical rendering path and is called for every pixel. Please keep it as simple and
 // efficient as possible.
 void GfxRenderer::drawPixel(const int x, const int y, const bool state) const {
@@ -272,21 +605,72 @@ void GfxRenderer::drawText(const int fontId, const int x, const int y, const cha
   }
 }
 
+void GfxRenderer::beginGlyphCapture(GlyphDisplayList& list, const size_t expectedGlyphs) {
+  list.clear();
+  list.reserve(expectedGlyphs);
+  glyphCapture = &list;
+}
+
+void GfxRenderer::endGlyphCapture() {
+  if (glyphCapture) {
+    glyphCapture->sortForReplay();
+    glyphCapture = nullptr;
+  }
+}
+
+bool GfxRenderer::replayGlyphs(const GlyphDisplayList& list) const {
+  if (!list.isComplete()) {
+    return false;
+  }
+  for (const auto& entry : list.entries) {
+    const EpdFontData* fontData = list.fonts[entry.fontSlot];
+    int cursorX = entry.cursorX;
+    int cursorY = entry.cursorY;
+    renderGlyphImpl<TextRotation::None>(*this, renderMode, fontData, &fontData->glyph[entry.glyphIndex], &cursorX,
+                                        &cursorY, entry.pixelState, false);
+  }
+  return true;
+}
+
+void GfxRenderer::collectTextGlyphs(const int fontId, const char* text, const EpdFontFamily::Style style,
+                                    FontDecompressor::PrewarmSet& set) const {
+  if (text == nullptr || *text == '\0') {
+    return;
+  }
+
+  const auto fontIt = fontMap.find(fontId);
+  if (fontIt == fontMap.end()) {
+    return;
+  }
+  const auto& font = fontIt->second;
+  const EpdFontData* fontData = font.getData(style);
+  if (!fontData->groups) {
+    return;
+  }
+
+  uint32_t cp;
+  while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&text)))) {
+    const EpdGlyph* glyph = font.getGlyph(cp, style);
+    if (!glyph) {
+      glyph = font.getGlyph(REPLACEMENT_GLYPH, style);
+    }
+    if (glyph) {
+      set.addGlyph(fontData, glyph);
+    }
+  }
+}
+
 void GfxRenderer::drawLine(int x1, int y1, int x2, int y2, const bool state) const {
   if (x1 == x2) {
     if (y2 < y1) {
       std::swap(y1, y2);
     }
-    for (int y = y1; y <= y2; y++) {
-      drawPixel(x1, y, state);
-    }
+    fillPattern(x1, y1, 1, y2 - y1 + 1, state ? Color::Black : Color::White);
   } else if (y1 == y2) {
     if (x2 < x1) {
       std::swap(x1, x2);
     }
-    for (int x = x1; x <= x2; x++) {
-      drawPixel(x, y1, state);
-    }
+    fillPattern(x1, y1, x2 - x1 + 1, 1, state ? Color::Black : Color::White);
   } else {
     // Bresenham's line algorithm — integer arithmetic only
     int dx = x2 - x1;
@@ -314,6 +698,10 @@ void GfxRenderer::drawLine(int x1, int y1, int x2, int y2, const bool state) con
 }
 
 void GfxRenderer::drawLine(int x1, int y1, int x2, int y2, const int lineWidth, const bool state) const {
+  if (y1 == y2 && lineWidth > 0) {
+    fillRect(std::min(x1, x2), y1, std::abs(x2 - x1) + 1, lineWidth, state);
+    return;
+  }
   for (int i = 0; i < lineWidth; i++) {
     drawLine(x1, y1 + i, x2, y2 + i, state);
   }
@@ -337,23 +725,53 @@ void GfxRenderer::drawRect(const int x, const int y, const int width, const int
   }
 }
 
+const GfxRenderer::CornerSpans& GfxRenderer::getCornerSpans(const int outerRadius, const int innerRadius) const {
+  for (const auto& corner : cornerCache) {
+    if (corner.outerRadius == outerRadius && corner.innerRadius == innerRadius) {
+      return corner;
+    }
+  }
+
+  // Rows of a quarter ring are single runs of dx, since dx² + dy² grows with dx
+  CornerSpans& corner = cornerCache[nextCornerSlot];
+  nextCornerSlot = (nextCornerSlot + 1) % CORNER_CACHE_SIZE;
+  corner.outerRadius = outerRadius;
+  corner.innerRadius = innerRadius;
+  corner.spans.resize(outerRadius + 1);
+  const int outerRadiusSq = outerRadius * outerRadius;
+  const int innerRadiusSq = innerRadius * innerRadius;
+  int last = outerRadius;
+  for (int dy = 0; dy <= outerRadius; ++dy) {
+    while (last >= 0 && last * last + dy * dy > outerRadiusSq) {
+      last--;
+    }
+    int first = 0;
+    while (first <= last && first * first + dy * dy < innerRadiusSq) {
+      first++;
+    }
+    corner.spans[dy] = {static_cast<int16_t>(first), static_cast<int16_t>(last)};
+  }
+  return corner;
+}
+
+void GfxRenderer::fillCorner(const int outerRadius, const int innerRadius, const int cx, const int cy, const int xDir,
+                             const int yDir, const Color color) const {
+  const CornerSpans& corner = getCornerSpans(outerRadius, innerRadius);
+  for (int dy = 0; dy <= outerRadius; ++dy) {
+    const auto& span = corner.spans[dy];
+    if (span.first > span.last) {
+      continue;
+    }
+    const int left = xDir > 0 ? cx + span.first : cx - span.last;
+    fillPattern(left, cy + yDir * dy, span.last - span.first + 1, 1, color);
+  }
+}
+
 void GfxRenderer::drawArc(const int maxRadius, const int cx, const int cy, const int xDir, const int yDir,
                           const int lineWidth, const bool state) const {
   const int stroke = std::min(lineWidth, maxRadius);
   const int innerRadius = std::max(maxRadius - stroke, 0);
-  const int outerRadiusSq = maxRadius * maxRadius;
-  const int innerRadiusSq = innerRadius * innerRadius;
-  for (int dy = 0; dy <= maxRadius; ++dy) {
-    for (int dx = 0; dx <= maxRadius; ++dx) {
-      const int distSq = dx * dx + dy * dy;
-      if (distSq > outerRadiusSq || distSq < innerRadiusSq) {
-        continue;
-      }
-      const int px = cx + xDir * dx;
-      const int py = cy + yDir * dy;
-      drawPixel(px, py, state);
-    }
-  }
+  fillCorner(maxRadius, innerRadius, cx, cy, xDir, yDir, state ? Color::Black : Color::White);
 };
 
 // Border is inside the rectangle, rounded corners
@@ -415,72 +833,78 @@ void GfxRenderer::drawRoundedRect(const int x, const int y, const int width, con
 }
 
 void GfxRenderer::fillRect(const int x, const int y, const int width, const int height, const bool state) const {
-  for (int fillY = y; fillY < y + height; fillY++) {
-    drawLine(x, fillY, x + width - 1, fillY, state);
-  }
-}
-
-// NOTE: Those are in critical path, and need to be templated to avoid runtime checks for every pixel.
-// Any branching must be done outside the loops to avoid performance degradation.
-template <>
-void GfxRenderer::drawPixelDither<Color::Clear>(const int x, const int y) const {
-  // Do nothing
-}
-
-template <>
-void GfxRenderer::drawPixelDither<Color::Black>(const int x, const int y) const {
-  drawPixel(x, y, true);
-}
-
-template <>
-void GfxRenderer::drawPixelDither<Color::White>(const int x, const int y) const {
-  drawPixel(x, y, false);
+  fillPattern(x, y, width, height, state ? Color::Black : Color::White);
 }
 
-template <>
-void GfxRenderer::drawPixelDither<Color::LightGray>(const int x, const int y) const {
-  drawPixel(x, y, x % 2 == 0 && y % 2 == 0);
-}
+// Fills work on physical panel rows: the logical rectangle maps to a physical one in every orientation, and each of
+// its rows is a run of whole bytes plus two masked edge bytes. Dither patterns repeat every two pixels on both axes,
+// so each physical row needs just one byte of ink, picked by row parity.
+void GfxRenderer::fillPattern(const int x, const int y, const int width, const int height, const Color color) const {
+  if (width <= 0 || height <= 0) {
+    return;
+  }
+  uint8_t rowInk[2];
+  if (!getDitherRowInk(color, rowInk)) {
+    return;
+  }
 
-template <>
-void GfxRenderer::drawPixelDither<Color::DarkGray>(const int x, const int y) const {
-  drawPixel(x, y, (x + y) % 2 == 0);  // TODO: maybe find a better pattern?
-}
+  int phyX1 = 0, phyY1 = 0, phyX2 = 0, phyY2 = 0;
+  rotateCoordinates(orientation, x, y, &phyX1, &phyY1);
+  rotateCoordinates(orientation, x + width - 1, y + height - 1, &phyX2, &phyY2);
+  const int left = std::max(0, std::min(phyX1, phyX2));
+  const int top = std::max(0, std::min(phyY1, phyY2));
+  const int right = std::min<int>(HalDisplay::DISPLAY_WIDTH - 1, std::max(phyX1, phyX2));
+  const int bottom = std::min<int>(HalDisplay::DISPLAY_HEIGHT - 1, std::max(phyY1, phyY2));
+  if (left > right || top > bottom) {
+    return;
+  }
 
-void GfxRenderer::fillRectDither(const int x, const int y, const int width, const int height, Color color) const {
-  if (color == Color::Clear) {
-  } else if (color == Color::Black) {
-    fillRect(x, y, width, height, true);
-  } else if (color == Color::White) {
-    fillRect(x, y, width, height, false);
-  } else if (color == Color::LightGray) {
-    for (int fillY = y; fillY < y + height; fillY++) {
-      for (int fillX = x; fillX < x + width; fillX++) {
-        drawPixelDither<Color::LightGray>(fillX, fillY);
-      }
+  const int firstByte = left / 8;
+  const int lastByte = right / 8;
+  const uint8_t firstMask = 0xFF >> (left % 8);
+  const uint8_t lastMask = 0xFF << (7 - right % 8);
+  for (int row = top; row <= bottom; row++) {
+    uint8_t* line = frameBuffer + row * HalDisplay::DISPLAY_WIDTH_BYTES;
+    const uint8_t value = ~rowInk[row & 1];  // Bit cleared = black
+    if (firstByte == lastByte) {
+      const uint8_t mask = firstMask & lastMask;
+      line[firstByte] = (line[firstByte] & ~mask) | (value & mask);
+      continue;
     }
-  } else if (color == Color::DarkGray) {
-    for (int fillY = y; fillY < y + height; fillY++) {
-      for (int fillX = x; fillX < x + width; fillX++) {
-        drawPixelDither<Color::DarkGray>(fillX, fillY);
-      }
+    line[firstByte] = (line[firstByte] & ~firstMask) | (value & firstMask);
+    if (lastByte - firstByte > 1) {
+      memset(line + firstByte + 1, value, lastByte - firstByte - 1);
     }
+    line[lastByte] = (line[lastByte] & ~lastMask) | (value & lastMask);
   }
 }
 
-template <Color color>
-void GfxRenderer::fillArc(const int maxRadius, const int cx, const int cy, const int xDir, const int yDir) const {
-  const int radiusSq = maxRadius * maxRadius;
-  for (int dy = 0; dy <= maxRadius; ++dy) {
-    for (int dx = 0; dx <= maxRadius; ++dx) {
-      const int distSq = dx * dx + dy * dy;
-      const int px = cx + xDir * dx;
-      const int py = cy + yDir * dy;
-      if (distSq <= radiusSq) {
-        drawPixelDither<color>(px, py);
+// Ink byte for even and odd physical rows. The patterns are defined on logical coordinates (light gray: even x and
+// even y; dark gray: even x + y), so they are evaluated at the logical position of the first two pixels of each row.
+bool GfxRenderer::getDitherRowInk(const Color color, uint8_t rowInk[2]) const {
+  if (color == Color::Black || color == Color::White) {
+    rowInk[0] = rowInk[1] = color == Color::Black ? 0xFF : 0x00;
+    return true;
+  }
+  if (color != Color::LightGray && color != Color::DarkGray) {
+    return false;
+  }
+  for (int phyY = 0; phyY < 2; phyY++) {
+    rowInk[phyY] = 0;
+    for (int phyX = 0; phyX < 2; phyX++) {
+      int x = 0, y = 0;
+      unrotateCoordinates(orientation, phyX, phyY, &x, &y);
+      const bool ink = color == Color::LightGray ? (x % 2 == 0 && y % 2 == 0) : (x + y) % 2 == 0;
+      if (ink) {
+        rowInk[phyY] |= phyX == 0 ? 0xAA : 0x55;
       }
     }
   }
+  return true;
+}
+
+void GfxRenderer::fillRectDither(const int x, const int y, const int width, const int height, Color color) const {
+  fillPattern(x, y, width, height, color);
 }
 
 void GfxRenderer::fillRoundedRect(const int x, const int y, const int width, const int height, const int cornerRadius,
@@ -520,39 +944,20 @@ void GfxRenderer::fillRoundedRect(const int x, const int y, const int width, con
     fillRectDither(x + width - maxRadius - 1, rightFillTop, maxRadius + 1, rightFillBottom - rightFillTop + 1, color);
   }
 
-  auto fillArcTemplated = [this](int maxRadius, int cx, int cy, int xDir, int yDir, Color color) {
-    switch (color) {
-      case Color::Clear:
-        break;
-      case Color::Black:
-        fillArc<Color::Black>(maxRadius, cx, cy, xDir, yDir);
-        break;
-      case Color::White:
-        fillArc<Color::White>(maxRadius, cx, cy, xDir, yDir);
-        break;
-      case Color::LightGray:
-        fillArc<Color::LightGray>(maxRadius, cx, cy, xDir, yDir);
-        break;
-      case Color::DarkGray:
-        fillArc<Color::DarkGray>(maxRadius, cx, cy, xDir, yDir);
-        break;
-    }
-  };
-
   if (roundTopLeft) {
-    fillArcTemplated(maxRadius, x + maxRadius, y + maxRadius, -1, -1, color);
+    fillCorner(maxRadius, 0, x + maxRadius, y + maxRadius, -1, -1, color);
   }
 
   if (roundTopRight) {
-    fillArcTemplated(maxRadius, x + width - maxRadius - 1, y + maxRadius, 1, -1, color);
+    fillCorner(maxRadius, 0, x + width - maxRadius - 1, y + maxRadius, 1, -1, color);
   }
 
   if (roundBottomRight) {
-    fillArcTemplated(maxRadius, x + width - maxRadius - 1, y + height - maxRadius - 1, 1, 1, color);
+    fillCorner(maxRadius, 0, x + width - maxRadius - 1, y + height - maxRadius - 1, 1, 1, color);
   }
 
   if (roundBottomLeft) {
-    fillArcTemplated(maxRadius, x + maxRadius, y + height - maxRadius - 1, -1, 1, color);
+    fillCorner(maxRadius, 0, x + maxRadius, y + height - maxRadius - 1, -1, 1, color);
   }
 }
 
@@ -584,36 +989,113 @@ void GfxRenderer::drawIcon(const uint8_t bitmap[], const int x, const int y, con
 }
 
 void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, const int maxWidth, const int maxHeight,
-                             const float cropX, const float cropY) const {
+                             const float cropX, const float cropY, const BitmapScaling scaling) const {
   // For 1-bit bitmaps, use optimized 1-bit rendering path (no crop support for 1-bit)
   if (bitmap.is1Bit() && cropX == 0.0f && cropY == 0.0f) {
-    drawBitmap1Bit(bitmap, x, y, maxWidth, maxHeight);
+    blitBitmap(bitmap, x, y, maxWidth, maxHeight, 0, 0, scaling, true);
     return;
   }
+  blitBitmap(bitmap, x, y, maxWidth, maxHeight, cropX, cropY, scaling, false);
+}
+
+void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y, const int maxWidth,
+                                 const int maxHeight) const {
+  blitBitmap(bitmap, x, y, maxWidth, maxHeight, 0, 0, BitmapScaling::Nearest, true);
+}
+
+GfxRenderer::BitmapFit GfxRenderer::fitBitmap(const Bitmap& bitmap, const int maxWidth, const int maxHeight,
+                                               const float cropX, const float cropY) {
+  BitmapFit fit;
+  fit.cropPixX = std::floor(bitmap.getWidth() * cropX / 2.0f);
+  fit.cropPixY = std::floor(bitmap.getHeight() * cropY / 2.0f);
+  fit.srcWidth = bitmap.getWidth() - 2 * fit.cropPixX;
+  fit.srcHeight = bitmap.getHeight() - 2 * fit.cropPixY;
+  fit.dstWidth = fit.srcWidth;
+  fit.dstHeight = fit.srcHeight;
+  if (fit.srcWidth <= 0 || fit.srcHeight <= 0) {
+    return fit;
+  }
 
   float scale = 1.0f;
-  bool isScaled = false;
-  int cropPixX = std::floor(bitmap.getWidth() * cropX / 2.0f);
-  int cropPixY = std::floor(bitmap.getHeight() * cropY / 2.0f);
+  if (maxWidth > 0 && fit.srcWidth > maxWidth) {
+    scale = static_cast<float>(maxWidth) / static_cast<float>(fit.srcWidth);
+  }
+  if (maxHeight > 0 && fit.srcHeight > maxHeight) {
+    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>(fit.srcHeight));
+  }
+  if (scale < 1.0f) {
+    fit.dstWidth = std::max(1, static_cast<int>(std::lround(fit.srcWidth * scale)));
+    fit.dstHeight = std::max(1, static_cast<int>(std::lround(fit.srcHeight * scale)));
+    if (maxWidth > 0) fit.dstWidth = std::min(fit.dstWidth, maxWidth);
+    if (maxHeight > 0) fit.dstHeight = std::min(fit.dstHeight, maxHeight);
+  }
+  return fit;
+}
+
+// Scaled blit. The source (after cropping) maps onto a dstWidth x dstHeight box through integer sampling tables
+// built once per image, and every screen row is assembled as a 1bpp mask and written with the span writers, so no
+// pixel goes through drawPixel. At 1:1 the tables are the identity and the output matches per-pixel drawing.
+void GfxRenderer::blitBitmap(const Bitmap& bitmap, const int x, const int y, const int maxWidth, const int maxHeight,
+                             const float cropX, const float cropY, const BitmapScaling scaling,
+                             const bool oneBit) const {
+  const BitmapFit fit = fitBitmap(bitmap, maxWidth, maxHeight, cropX, cropY);
+  const int cropPixX = fit.cropPixX;
+  const int cropPixY = fit.cropPixY;
+  const int srcWidth = fit.srcWidth;
+  const int srcHeight = fit.srcHeight;
+  const int dstWidth = fit.dstWidth;
+  const int dstHeight = fit.dstHeight;
+  if (srcWidth <= 0 || srcHeight <= 0) {
+    return;
+  }
   LOG_DBG("GFX", "Cropping %dx%d by %dx%d pix, is %s", bitmap.getWidth(), bitmap.getHeight(), cropPixX, cropPixY,
           bitmap.isTopDown() ? "top-down" : "bottom-up");
-
-  if (maxWidth > 0 && (1.0f - cropX) * bitmap.getWidth() > maxWidth) {
-    scale = static_cast<float>(maxWidth) / static_cast<float>((1.0f - cropX) * bitmap.getWidth());
-    isScaled = true;
+  const bool averaging = scaling == BitmapScaling::AreaAverage && (dstWidth < srcWidth || dstHeight < srcHeight);
+  LOG_DBG("GFX", "Scaling %dx%d to %dx%d%s", srcWidth, srcHeight, dstWidth, dstHeight,
+          averaging ? " (area average)" : "");
+
+  // Visible part of the destination box
+  const int firstDx = std::max(0, -x);
+  const int lastDx = std::min(dstWidth, getScreenWidth() - x) - 1;
+  if (lastDx < firstDx) {
+    return;
   }
-  if (maxHeight > 0 && (1.0f - cropY) * bitmap.getHeight() > maxHeight) {
-    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>((1.0f - cropY) * bitmap.getHeight()));
-    isScaled = true;
+  const int visibleWidth = lastDx - firstDx + 1;
+
+  // 2-bit source value (0 black .. 3 white) -> drawn or not. 1-bit images always draw black; otherwise BW draws
+  // black where the value isn't white and the grayscale planes flag their gray levels.
+  bool draws[4];
+  for (int v = 0; v < 4; v++) {
+    draws[v] = oneBit || renderMode == BW ? v < 3 : renderMode == GRAYSCALE_MSB ? (v == 1 || v == 2) : v == 1;
+  }
+  const bool set = !oneBit && renderMode != BW;  // drawPixel(false) for the grayscale planes
+
+  // Sampling tables. Nearest: source column for each visible screen column. Area average: screen column for each
+  // source column, plus how many source columns land in each screen column.
+  std::vector<uint16_t> columnTable;
+  std::vector<uint32_t> columnSum;
+  std::vector<uint16_t> columnCount;
+  if (averaging) {
+    columnTable.resize(srcWidth);
+    columnSum.assign(visibleWidth, 0);
+    columnCount.assign(visibleWidth, 0);
+    for (int sx = 0; sx < srcWidth; sx++) {
+      const int dx = static_cast<int>(static_cast<int64_t>(sx) * dstWidth / srcWidth);
+      columnTable[sx] = static_cast<uint16_t>(dx);
+      if (dx >= firstDx && dx <= lastDx) {
+        columnCount[dx - firstDx]++;
+      }
+    }
+  } else {
+    columnTable.resize(visibleWidth);
+    for (int dx = firstDx; dx <= lastDx; dx++) {
+      columnTable[dx - firstDx] = static_cast<uint16_t>(cropPixX + static_cast<int64_t>(dx) * srcWidth / dstWidth);
+    }
   }
-  LOG_DBG("GFX", "Scaling by %f - %s", scale, isScaled ? "scaled" : "not scaled");
 
-  // Calculate output row size (2 bits per pixel, packed into bytes)
-  // IMPORTANT: Use int, not uint8_t, to avoid overflow for images > 1020 pixels wide
   const int outputRowSize = (bitmap.getWidth() + 3) / 4;
   auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
   auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
-
   if (!outputRow || !rowBytes) {
     LOG_ERR("GFX", "!! Failed to allocate BMP row buffers");
     free(outputRow);
@@ -621,130 +1103,249 @@ void GfxRenderer::drawBitmap(const Bitmap& bitmap, const int x, const int y, con
     return;
   }
 
-  for (int bmpY = 0; bmpY < (bitmap.getHeight() - cropPixY); bmpY++) {
-    // The BMP's (0, 0) is the bottom-left corner (if the height is positive, top-left if negative).
-    // Screen's (0, 0) is the top-left corner.
-    int screenY = -cropPixY + (bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY);
-    if (isScaled) {
-      screenY = std::floor(screenY * scale);
+  uint8_t mask[HalDisplay::DISPLAY_WIDTH / 8];
+  int averagedRows = 0;  // Source rows summed into columnSum so far
+  const auto emitRow = [&](const int dy) {
+    const int screenY = y + dy;
+    if (screenY < 0 || screenY >= getScreenHeight()) {
+      return;
     }
-    screenY += y;  // the offset should not be scaled
-    if (screenY >= getScreenHeight()) {
-      break;
+    std::fill(mask, mask + (visibleWidth + 7) / 8, 0);
+    bool any = false;
+    for (int i = 0; i < visibleWidth; i++) {
+      uint8_t v;
+      if (averaging) {
+        const int count = columnCount[i] * averagedRows;
+        if (count == 0) continue;
+        v = static_cast<uint8_t>((2 * columnSum[i] + count) / (2 * count));
+      } else {
+        const int sx = columnTable[i];
+        v = outputRow[sx >> 2] >> (6 - ((sx & 3) << 1)) & 0x3;
+      }
+      if (draws[v]) {
+        mask[i >> 3] |= 0x80 >> (i & 7);
+        any = true;
+      }
     }
+    if (any) {
+      set ? writeLogicalRow<true>(frameBuffer, orientation, x + firstDx, screenY, mask, visibleWidth)
+          : writeLogicalRow<false>(frameBuffer, orientation, x + firstDx, screenY, mask, visibleWidth);
+    }
+  };
 
-    if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      LOG_ERR("GFX", "Failed to read row %d from bitmap", bmpY);
-      free(outputRow);
-      free(rowBytes);
-      return;
+  // Rows arrive in file order: top to bottom for top-down images, bottom to top otherwise
+  int averagedDy = -1;
+  const auto flushAverage = [&]() {
+    if (averagedDy < 0) return;
+    emitRow(averagedDy);
+    std::fill(columnSum.begin(), columnSum.end(), 0);
+    averagedDy = -1;
+    averagedRows = 0;
+  };
+
+  for (int bmpY = 0; bmpY < bitmap.getHeight(); bmpY++) {
+    const int sy = (bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY) - cropPixY;
+    // Area averaging sums every source row into the screen row it falls in. Nearest sampling takes source row
+    // dy * srcHeight / dstHeight for screen row dy, like the column table; the first screen row at or below sy is the
+    // only candidate. Rows no screen row samples are skipped without decoding, as are cropped and off-screen rows.
+    int dy = -1;
+    if (sy >= 0 && sy < srcHeight) {
+      if (averaging) {
+        dy = static_cast<int>(static_cast<int64_t>(sy) * dstHeight / srcHeight);
+      } else {
+        dy = static_cast<int>((static_cast<int64_t>(sy) * dstHeight + srcHeight - 1) / srcHeight);
+        if (dy >= dstHeight || static_cast<int64_t>(dy) * srcHeight / dstHeight != sy) {
+          dy = -1;
+        }
+      }
     }
+    const bool needed = dy >= 0 && y + dy >= 0 && y + dy < getScreenHeight();
 
-    if (screenY < 0) {
+    const BmpReaderError err = needed ? bitmap.readNextRow(outputRow, rowBytes) : bitmap.skipNextRow();
+    if (err != BmpReaderError::Ok) {
+      LOG_ERR("GFX", "Failed to read row %d from bitmap", bmpY);
+      break;
+    }
+    if (!needed) {
       continue;
     }
 
-    if (bmpY < cropPixY) {
-      // Skip the row if it's outside the crop area
+    if (!averaging) {
+      emitRow(dy);
       continue;
     }
-
-    for (int bmpX = cropPixX; bmpX < bitmap.getWidth() - cropPixX; bmpX++) {
-      int screenX = bmpX - cropPixX;
-      if (isScaled) {
-        screenX = std::floor(screenX * scale);
-      }
-      screenX += x;  // the offset should not be scaled
-      if (screenX >= getScreenWidth()) {
-        break;
-      }
-      if (screenX < 0) {
-        continue;
-      }
-
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
-
-      if (renderMode == BW && val < 3) {
-        drawPixel(screenX, screenY);
-      } else if (renderMode == GRAYSCALE_MSB && (val == 1 || val == 2)) {
-        drawPixel(screenX, screenY, false);
-      } else if (renderMode == GRAYSCALE_LSB && val == 1) {
-        drawPixel(screenX, screenY, false);
-      }
+    if (dy != averagedDy) {
+      flushAverage();
+      averagedDy = dy;
+    }
+    averagedRows++;
+    for (int sx = 0; sx < srcWidth; sx++) {
+      const int i = columnTable[sx] - firstDx;
+      if (i < 0 || i >= visibleWidth) continue;
+      const int bx = cropPixX + sx;
+      columnSum[i] += outputRow[bx >> 2] >> (6 - ((bx & 3) << 1)) & 0x3;
     }
   }
+  if (averaging) {
+    flushAverage();
+  }
 
   free(outputRow);
   free(rowBytes);
 }
 
-void GfxRenderer::drawBitmap1Bit(const Bitmap& bitmap, const int x, const int y, const int maxWidth,
-                                 const int maxHeight) const {
-  float scale = 1.0f;
-  bool isScaled = false;
-  if (maxWidth > 0 && bitmap.getWidth() > maxWidth) {
-    scale = static_cast<float>(maxWidth) / static_cast<float>(bitmap.getWidth());
-    isScaled = true;
-  }
-  if (maxHeight > 0 && bitmap.getHeight() > maxHeight) {
-    scale = std::min(scale, static_cast<float>(maxHeight) / static_cast<float>(bitmap.getHeight()));
-    isScaled = true;
-  }
+namespace {
+// Framebuffer image cache file: this header, then the frame buffer bytes of physical rows top..bottom, byte columns
+// left / 8 .. right / 8. Bits outside left..right on the edge bytes are stored but never restored. Unlike the other
+// caches it carries no CRC trailer: the loader compares the whole header against the draw and the exact length, and
+// the pixels go straight into the frame buffer, where a bad CRC found at the end could no longer be undone.
+constexpr uint32_t IMAGE_CACHE_MAGIC = 0x32494246;  // "FBI2"
+
+struct ImageCacheHeader {
+  uint32_t magic;
+  // Everything up to the rectangle describes the draw; all of it has to match for the cache to be used. The
+  // modify stamp catches a BMP regenerated at the same size and dimensions.
+  uint32_t sourceSize;
+  uint32_t sourceModified;
+  uint16_t sourceWidth;
+  uint16_t sourceHeight;
+  uint16_t sourceBpp;
+  uint8_t dithered;
+  uint8_t orientation;
+  uint8_t renderMode;
+  uint8_t scaling;
+  int16_t x;
+  int16_t y;
+  int16_t maxWidth;
+  int16_t maxHeight;
+  float cropX;
+  float cropY;
+  // Physical rectangle covered by the image, inclusive
+  uint16_t left;
+  uint16_t top;
+  uint16_t right;
+  uint16_t bottom;
+};
 
-  // For 1-bit BMP, output is still 2-bit packed (for consistency with readNextRow)
-  const int outputRowSize = (bitmap.getWidth() + 3) / 4;
-  auto* outputRow = static_cast<uint8_t*>(malloc(outputRowSize));
-  auto* rowBytes = static_cast<uint8_t*>(malloc(bitmap.getRowBytes()));
+// Physical rectangle stored in a cache header
+PhysicalRect headerRect(const ImageCacheHeader& header) {
+  return {header.left, header.top, header.right, header.bottom};
+}
 
-  if (!outputRow || !rowBytes) {
-    LOG_ERR("GFX", "!! Failed to allocate 1-bit BMP row buffers");
-    free(outputRow);
-    free(rowBytes);
-    return;
+bool loadImageCache(uint8_t* frameBuffer, const std::string& path, const ImageCacheHeader& expected) {
+  if (!Storage.exists(path.c_str())) {
+    return false;
+  }
+  FsFile file;
+  if (!Storage.openFileForRead("GFX", path, file)) {
+    return false;
+  }
+  constexpr int WB = HalDisplay::DISPLAY_WIDTH_BYTES;
+  const PhysicalRect rect = headerRect(expected);
+  ImageCacheHeader header;
+  if (Storage.read(file, &header, sizeof(header)) != sizeof(header) ||
+      memcmp(&header, &expected, sizeof(header)) != 0 || file.fileSize() != sizeof(header) + rect.size()) {
+    LOG_DBG("GFX", "Image cache %s is stale, rebuilding", path.c_str());
+    Storage.close(file);
+    return false;
   }
 
-  for (int bmpY = 0; bmpY < bitmap.getHeight(); bmpY++) {
-    // Read rows sequentially using readNextRow
-    if (bitmap.readNextRow(outputRow, rowBytes) != BmpReaderError::Ok) {
-      LOG_ERR("GFX", "Failed to read row %d from 1-bit bitmap", bmpY);
-      free(outputRow);
-      free(rowBytes);
-      return;
-    }
-
-    // Calculate screen Y based on whether BMP is top-down or bottom-up
-    const int bmpYOffset = bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY;
-    int screenY = y + (isScaled ? static_cast<int>(std::floor(bmpYOffset * scale)) : bmpYOffset);
-    if (screenY >= getScreenHeight()) {
-      continue;  // Continue reading to keep row counter in sync
-    }
-    if (screenY < 0) {
-      continue;
-    }
-
-    for (int bmpX = 0; bmpX < bitmap.getWidth(); bmpX++) {
-      int screenX = x + (isScaled ? static_cast<int>(std::floor(bmpX * scale)) : bmpX);
-      if (screenX >= getScreenWidth()) {
+  bool ok = true;
+  if (rect.fullWidth()) {
+    // Full panel rows: one read straight into the frame buffer
+    ok = Storage.read(file, frameBuffer + rect.top * WB, rect.size()) == static_cast<int>(rect.size());
+  } else {
+    uint8_t row[WB];
+    for (int phyY = rect.top; phyY <= rect.bottom; phyY++) {
+      if (Storage.read(file, row, rect.widthBytes()) != rect.widthBytes()) {
+        ok = false;
         break;
       }
-      if (screenX < 0) {
-        continue;
-      }
-
-      // Get 2-bit value (result of readNextRow quantization)
-      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
+      mergeRectRow(frameBuffer + phyY * WB + rect.byteX(), row, rect);
+    }
+  }
+  Storage.close(file);
+  if (!ok) {
+    LOG_ERR("GFX", "Failed to read image cache %s", path.c_str());
+  }
+  return ok;
+}
 
-      // For 1-bit source: 0 or 1 -> map to black (0,1,2) or white (3)
-      // val < 3 means black pixel (draw it)
-      if (val < 3) {
-        drawPixel(screenX, screenY, true);
-      }
-      // White pixels (val == 3) are not drawn (leave background)
+// Written under a temporary name and moved into place, so a cut write never leaves a file of the right length
+void storeImageCache(const uint8_t* frameBuffer, const std::string& path, const ImageCacheHeader& header) {
+  const std::string tmpPath = path + ".tmp";
+  FsFile file;
+  if (!Storage.openFileForWrite("GFX", tmpPath, file)) {
+    LOG_ERR("GFX", "Could not create image cache %s", path.c_str());
+    return;
+  }
+  constexpr int WB = HalDisplay::DISPLAY_WIDTH_BYTES;
+  const PhysicalRect rect = headerRect(header);
+  bool ok = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header);
+  if (rect.widthBytes() == WB) {
+    ok = ok && file.write(frameBuffer + rect.top * WB, rect.size()) == rect.size();
+  } else {
+    for (int phyY = rect.top; ok && phyY <= rect.bottom; phyY++) {
+      ok = file.write(frameBuffer + phyY * WB + rect.byteX(), rect.widthBytes()) ==
+           static_cast<size_t>(rect.widthBytes());
     }
   }
+  file.close();
+  if (!ok || !Storage.replace(tmpPath.c_str(), path.c_str())) {
+    LOG_ERR("GFX", "Failed to write image cache %s", path.c_str());
+    Storage.remove(tmpPath.c_str());
+    return;
+  }
+  LOG_DBG("GFX", "Stored image cache %s (%d bytes x %d rows)", path.c_str(), rect.widthBytes(), rect.rows());
+}
+}  // namespace
+
+void GfxRenderer::drawBitmapCached(const Bitmap& bitmap, const std::string& bmpPath, const int x, const int y,
+                                   const int maxWidth, const int maxHeight, const float cropX, const float cropY,
+                                   const BitmapScaling scaling) const {
+  // Physical rectangle under the box the image ends up in
+  const BitmapFit fit = fitBitmap(bitmap, maxWidth, maxHeight, cropX, cropY);
+  PhysicalRect rect;
+  if (fit.srcWidth <= 0 || fit.srcHeight <= 0 ||
+      !toPhysicalRect(orientation, x, y, fit.dstWidth, fit.dstHeight, &rect)) {
+    return;
+  }
 
-  free(outputRow);
-  free(rowBytes);
+  ImageCacheHeader header;
+  memset(&header, 0, sizeof(header));  // Padding is compared too
+  header.magic = IMAGE_CACHE_MAGIC;
+  header.sourceSize = bitmap.getFileSize();
+  header.sourceModified = bitmap.getModifiedStamp();
+  header.sourceWidth = bitmap.getWidth();
+  header.sourceHeight = bitmap.getHeight();
+  header.sourceBpp = bitmap.getBpp();
+  header.dithered = bitmap.isDithered();
+  header.orientation = orientation;
+  header.renderMode = renderMode;
+  header.scaling = static_cast<uint8_t>(scaling);
+  header.x = x;
+  header.y = y;
+  header.maxWidth = maxWidth;
+  header.maxHeight = maxHeight;
+  header.cropX = cropX;
+  header.cropY = cropY;
+  header.left = rect.left;
+  header.top = rect.top;
+  header.right = rect.right;
+  header.bottom = rect.bottom;
+
+  std::string path = bmpPath;
+  if (path.size() > 4 && path.compare(path.size() - 4, 4, ".bmp") == 0) {
+    path.resize(path.size() - 4);
+  }
+  path += renderMode == BW ? ".bw.fb" : renderMode == GRAYSCALE_LSB ? ".lsb.fb" : ".msb.fb";
+
+  if (loadImageCache(frameBuffer, path, header)) {
+    LOG_DBG("GFX", "Drew %s from image cache", bmpPath.c_str());
+    return;
+  }
+  drawBitmap(bitmap, x, y, maxWidth, maxHeight, cropX, cropY, scaling);
+  storeImageCache(frameBuffer, path, header);
 }
 
 void GfxRenderer::fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state) const {
@@ -835,23 +1436,74 @@ void GfxRenderer::displayBuffer(const HalDisplay::RefreshMode refreshMode) const
   display.displayBuffer(refreshMode, fadingFix);
 }
 
+void GfxRenderer::displayChanges(const HalDisplay::RefreshMode refreshMode) const {
+  display.displayChanges(refreshMode, fadingFix);
+  const auto& stats = display.getLastRefreshStats();
+  LOG_DBG("GFX", "Changed-region refresh %ux%u at (%u,%u): %lu bytes in %lu ms", stats.width, stats.height, stats.x,
+          stats.y, static_cast<unsigned long>(stats.bytes), static_cast<unsigned long>(stats.timeMs));
+}
+
+HalDisplay::RefreshMode GfxRenderer::displayAdaptive(const int textPagesPerHalfRefresh, const bool wait) const {
+  auto elapsed = millis() - start_ms;
+  LOG_DBG("GFX", "Time = %lu ms from clearScreen to displayAdaptive", elapsed);
+  return display.displayAdaptive(textPagesPerHalfRefresh, fadingFix, wait);
+}
+
 std::string GfxRenderer::truncatedText(const int fontId, const char* text, const int maxWidth,
                                        const EpdFontFamily::Style style) const {
   if (!text || maxWidth <= 0) return "";
 
-  std::string item = text;
-  const char* ellipsis = "...";
-  int textWidth = getTextWidth(fontId, item.c_str(), style);
-  if (textWidth <= maxWidth) {
-    // Text fits, return as is
-    return item;
+  // Menus ask for the same few strings on every render
+  const size_t length = strlen(text);
+  const bool memoize = length <= TRUNCATED_TEXT_MAX_LENGTH;
+  if (memoize) {
+    for (const auto& entry : truncatedTextCache) {
+      if (entry.fontId == fontId && entry.maxWidth == maxWidth && entry.style == style && entry.text == text) {
+        return entry.result;
+      }
+    }
   }
 
-  while (!item.empty() && getTextWidth(fontId, (item + ellipsis).c_str(), style) >= maxWidth) {
-    utf8RemoveLastChar(item);
+  std::string result = text;
+  const char* ellipsis = "...";
+  if (getTextWidth(fontId, text, style) > maxWidth) {
+    // Longest prefix (in whole characters) that still fits with the ellipsis. Widths grow with the prefix, so
+    // binary search over the character boundaries instead of dropping one character at a time.
+    std::vector<size_t> boundaries;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+    const unsigned char* const begin = p;
+    while (*p) {
+      utf8NextCodepoint(&p);
+      boundaries.push_back(std::min<size_t>(p - begin, length));  // Don't run past a cut-off sequence
+      if (boundaries.back() == length) break;
+    }
+    std::string candidate;
+    int fitting = 0;  // Number of characters kept
+    int low = 1;
+    int high = static_cast<int>(boundaries.size());
+    while (low <= high) {
+      const int mid = (low + high) / 2;
+      candidate.assign(text, boundaries[mid - 1]);
+      candidate += ellipsis;
+      if (getTextWidth(fontId, candidate.c_str(), style) < maxWidth) {
+        fitting = mid;
+        low = mid + 1;
+      } else {
+        high = mid - 1;
+      }
+    }
+    result = fitting == 0 ? ellipsis : std::string(text, boundaries[fitting - 1]) + ellipsis;
   }
 
-  return item.empty() ? ellipsis : item + ellipsis;
+  if (memoize) {
+    if (truncatedTextCache.size() < TRUNCATED_TEXT_CACHE_SIZE) {
+      truncatedTextCache.push_back({fontId, maxWidth, style, text, result});
+    } else {
+      truncatedTextCache[nextTruncatedTextSlot] = {fontId, maxWidth, style, text, result};
+      nextTruncatedTextSlot = (nextTruncatedTextSlot + 1) % TRUNCATED_TEXT_CACHE_SIZE;
+    }
+  }
+  return result;
 }
 
 // Note: Internal driver treats screen in command orientation; this library exposes a logical orientation
@@ -1068,6 +1720,7 @@ bool GfxRenderer::storeBwBuffer() {
  * Uses chunked restoration to match chunked storage.
  */
 void GfxRenderer::restoreBwBuffer() {
+  display.waitForRefresh();  // Overwrites the framebuffer a queued refresh may still be reading
   // Check if all chunks are allocated
   bool missingChunks = false;
   for (const auto& bwBufferChunk : bwBufferChunks) {
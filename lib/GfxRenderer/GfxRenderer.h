@@ -5,8 +5,10 @@
 #include <HalDisplay.h>
 
 #include <map>
+#include <vector>
 
 #include "Bitmap.h"
+#include "GlyphDisplayList.h"
 
 // Color representation: uint8_t mapped to 4x4 Bayer matrix dithering levels
 // 0 = transparent, 1-16 = gray levels (white to black)
@@ -16,6 +18,12 @@ class GfxRenderer {
  public:
   enum RenderMode { BW, GRAYSCALE_LSB, GRAYSCALE_MSB };
 
+  // How drawBitmap shrinks images larger than the target box
+  enum class BitmapScaling : uint8_t {
+    Nearest,     // One source pixel per screen pixel; rows that aren't sampled are skipped without decoding
+    AreaAverage  // Average every source pixel under each screen pixel; slower, smoother for photos and covers
+  };
+
   // Logical screen orientation from the perspective of callers
   enum Orientation {
     Portrait,                  // 480x800 logical coordinates (current default)
@@ -38,13 +46,54 @@ class GfxRenderer {
   uint8_t* bwBufferChunks[BW_BUFFER_NUM_CHUNKS] = {nullptr};
   std::map<int, EpdFontFamily> fontMap;
   FontDecompressor* fontDecompressor = nullptr;
+  GlyphDisplayList* glyphCapture = nullptr;
+
+  // Rounded corners as one run of dx per row (dy = 0..outerRadius), cached by radii
+  struct CornerSpans {
+    struct Span {
+      int16_t first;
+      int16_t last;
+    };
+    int outerRadius = -1;
+    int innerRadius = -1;
+    std::vector<Span> spans;
+  };
+  static constexpr int CORNER_CACHE_SIZE = 4;
+  mutable CornerSpans cornerCache[CORNER_CACHE_SIZE];
+  mutable int nextCornerSlot = 0;
+
   void renderChar(const EpdFontFamily& fontFamily, uint32_t cp, int* x, int* y, bool pixelState,
                   EpdFontFamily::Style style) const;
+  // Recent truncatedText results
+  struct TruncatedTextEntry {
+    int fontId;
+    int maxWidth;
+    EpdFontFamily::Style style;
+    std::string text;
+    std::string result;
+  };
+  static constexpr size_t TRUNCATED_TEXT_CACHE_SIZE = 32;
+  static constexpr size_t TRUNCATED_TEXT_MAX_LENGTH = 160;
+  mutable std::vector<TruncatedTextEntry> truncatedTextCache;
+  mutable size_t nextTruncatedTextSlot = 0;
+
   void freeBwBufferChunks();
-  template <Color color>
-  void drawPixelDither(int x, int y) const;
-  template <Color color>
-  void fillArc(int maxRadius, int cx, int cy, int xDir, int yDir) const;
+  void fillPattern(int x, int y, int width, int height, Color color) const;
+  bool getDitherRowInk(Color color, uint8_t rowInk[2]) const;
+  const CornerSpans& getCornerSpans(int outerRadius, int innerRadius) const;
+  void fillCorner(int outerRadius, int innerRadius, int cx, int cy, int xDir, int yDir, Color color) const;
+  // Crop and scale drawBitmap applies: source rectangle (after cropping) and the size it is drawn at
+  struct BitmapFit {
+    int cropPixX;
+    int cropPixY;
+    int srcWidth;
+    int srcHeight;
+    int dstWidth;
+    int dstHeight;
+  };
+  static BitmapFit fitBitmap(const Bitmap& bitmap, int maxWidth, int maxHeight, float cropX, float cropY);
+  void blitBitmap(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight, float cropX, float cropY,
+                  BitmapScaling scaling, bool oneBit) const;
 
  public:
   explicit GfxRenderer(HalDisplay& halDisplay)
@@ -63,6 +112,13 @@ class GfxRenderer {
   void clearFontCache() {
     if (fontDecompressor) fontDecompressor->clearCache();
   }
+  // Glyph prefetch: gather the compressed groups `text` needs, then warm the cache once before drawing.
+  // prewarmFontCache returns the number of expected cache misses (0 if no decompressor is set).
+  void collectTextGlyphs(int fontId, const char* text, EpdFontFamily::Style style,
+                         FontDecompressor::PrewarmSet& set) const;
+  uint16_t prewarmFontCache(FontDecompressor::PrewarmSet& set) const {
+    return fontDecompressor ? fontDecompressor->prewarm(set) : 0;
+  }
 
   // Orientation control (affects logical width/height and coordinate transforms)
   void setOrientation(const Orientation o) { orientation = o; }
@@ -75,8 +131,16 @@ class GfxRenderer {
   int getScreenWidth() const;
   int getScreenHeight() const;
   void displayBuffer(HalDisplay::RefreshMode refreshMode = HalDisplay::FAST_REFRESH) const;
-  // EXPERIMENTAL: Windowed update - display only a rectangular region
-  // void displayWindow(int x, int y, int width, int height) const;
+  // Refresh only what changed since the last frame sent to the panel (see HalDisplay::displayChanges).
+  // Suited to menus, popups and other small updates; reports bytes sent and refresh time.
+  void displayChanges(HalDisplay::RefreshMode refreshMode = HalDisplay::FAST_REFRESH) const;
+  // Page display for readers: the refresh scheduler picks fast, half or full refresh from how much changed and the
+  // ghosting built up so far. `textPagesPerHalfRefresh` is the tolerance for ordinary text pages.
+  // With `wait` false the refresh runs in the background: don't draw until waitForRefresh() (clearScreen waits too).
+  HalDisplay::RefreshMode displayAdaptive(int textPagesPerHalfRefresh, bool wait = true) const;
+  // Returns how long the caller was blocked, in ms
+  uint32_t waitForRefresh() const { return display.waitForRefresh(); }
+  void requestHalfRefresh() const { display.requestHalfRefresh(); }
   void invertScreen() const;
   void clearScreen(uint8_t color = 0xFF) const;
   void getOrientedViewableTRBL(int* outTop, int* outRight, int* outBottom, int* outLeft) const;
@@ -98,9 +162,14 @@ class GfxRenderer {
                        bool roundBottomLeft, bool roundBottomRight, Color color) const;
   void drawImage(const uint8_t bitmap[], int x, int y, int width, int height) const;
   void drawIcon(const uint8_t bitmap[], int x, int y, int width, int height) const;
-  void drawBitmap(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight, float cropX = 0,
-                  float cropY = 0) const;
+  void drawBitmap(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight, float cropX = 0, float cropY = 0,
+                  BitmapScaling scaling = BitmapScaling::Nearest) const;
   void drawBitmap1Bit(const Bitmap& bitmap, int x, int y, int maxWidth, int maxHeight) const;
+  // drawBitmap that keeps the result as frame buffer bytes next to `bmpPath` (name.bw.fb, .lsb.fb, .msb.fb, one per
+  // render mode). The next draw of the same image into the same box and orientation reads those bytes straight into
+  // the frame buffer; any other draw rebuilds the cache. The image box is restored opaque, so draw on white.
+  void drawBitmapCached(const Bitmap& bitmap, const std::string& bmpPath, int x, int y, int maxWidth, int maxHeight,
+                        float cropX = 0, float cropY = 0, BitmapScaling scaling = BitmapScaling::Nearest) const;
   void fillPolygon(const int* xPoints, const int* yPoints, int numPoints, bool state = true) const;
 
   // Text
@@ -121,6 +190,14 @@ class GfxRenderer {
                            EpdFontFamily::Style style = EpdFontFamily::REGULAR) const;
   int getTextHeight(int fontId) const;
 
+  // Glyph display list: record the glyphs drawn between begin and end, then replay them in another render mode
+  // `expectedGlyphs` (an upper bound, such as Page::glyphCount) sizes the list before drawing starts
+  void beginGlyphCapture(GlyphDisplayList& list, size_t expectedGlyphs = 0);
+  void endGlyphCapture();
+  GlyphDisplayList* getGlyphCapture() const { return glyphCapture; }
+  // Returns false (drawing nothing) if the list is incomplete and the caller has to render the page instead
+  bool replayGlyphs(const GlyphDisplayList& list) const;
+
   // Grayscale functions
   void setRenderMode(const RenderMode mode) { this->renderMode = mode; }
   RenderMode getRenderMode() const { return renderMode; }
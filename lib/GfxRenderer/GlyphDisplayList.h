@@ -0,0 +1,93 @@
+#pragma once
+
+#include <EpdFontData.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Glyph placements recorded while rendering one plane, so the other planes of an anti-aliased page can be drawn
+// without walking the page, decoding UTF-8 or looking glyphs up again. Only upright text is recorded; anything else
+// (images, lines, rotated text) has to be drawn by the caller.
+class GlyphDisplayList {
+ public:
+  static constexpr size_t MAX_ENTRIES = 4096;  // 32KB worst case, roughly a full page of small text
+  static constexpr uint8_t MAX_FONTS = 8;
+
+  void clear() {
+    entries.clear();
+    fontCount = 0;
+    overflowed = false;
+    allTwoBit = true;
+  }
+
+  // Sizes the list for a page of `glyphs` in one allocation, rather than doubling its way up while the page is
+  // drawn. Capacity is kept across clear(); release() hands it back once the planes are drawn.
+  void reserve(const size_t glyphs) { entries.reserve(std::min(glyphs, MAX_ENTRIES)); }
+
+  // clear(), and frees the entries too, so the list holds no heap between pages
+  void release() {
+    clear();
+    std::vector<Entry>().swap(entries);
+  }
+
+  // False once anything could not be recorded; the list is then incomplete and must not be replayed
+  bool isComplete() const { return !overflowed; }
+  size_t size() const { return entries.size(); }
+
+  void add(const EpdFontData* fontData, const EpdGlyph* glyph, const int cursorX, const int cursorY,
+           const bool pixelState) {
+    if (overflowed) {
+      return;
+    }
+    uint8_t fontSlot = 0;
+    while (fontSlot < fontCount && fonts[fontSlot] != fontData) {
+      fontSlot++;
+    }
+    if (fontSlot == fontCount) {
+      if (fontCount == MAX_FONTS) {
+        overflowed = true;
+        return;
+      }
+      fonts[fontCount++] = fontData;
+    }
+    if (entries.size() >= MAX_ENTRIES || cursorX < INT16_MIN || cursorX > INT16_MAX || cursorY < INT16_MIN ||
+        cursorY > INT16_MAX) {
+      overflowed = true;
+      return;
+    }
+    allTwoBit = allTwoBit && fontData->is2Bit;
+    entries.push_back({static_cast<int16_t>(cursorX), static_cast<int16_t>(cursorY),
+                       static_cast<uint16_t>(glyph - fontData->glyph), fontSlot, pixelState});
+  }
+
+  // Order the entries by font and glyph index, so glyphs from the same compressed group are drawn back to back and
+  // each group is decompressed at most once per replay. Only done when every glyph is 2-bit: those only ever set
+  // bits in the grayscale planes, so drawing order cannot change the result there.
+  void sortForReplay() {
+    if (!allTwoBit) {
+      return;
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+      return a.fontSlot != b.fontSlot ? a.fontSlot < b.fontSlot : a.glyphIndex < b.glyphIndex;
+    });
+  }
+
+ private:
+  friend class GfxRenderer;
+
+  struct Entry {
+    int16_t cursorX;
+    int16_t cursorY;
+    uint16_t glyphIndex;
+    uint8_t fontSlot;
+    bool pixelState;
+  };
+  static_assert(sizeof(Entry) == 8, "GlyphDisplayList::Entry should stay compact");
+
+  std::vector<Entry> entries;
+  const EpdFontData* fonts[MAX_FONTS] = {};
+  uint8_t fontCount = 0;
+  bool overflowed = false;
+  bool allTwoBit = true;
+};
@@ -134,6 +134,7 @@ enum class StrId : uint16_t {
   STR_HIDE_BATTERY,
   STR_EXTRA_SPACING,
   STR_TEXT_AA,
+  STR_TEXT_AA_DELAY,
   STR_SHORT_PWR_BTN,
   STR_ORIENTATION,
   STR_FRONT_BTN_LAYOUT,
@@ -226,6 +227,10 @@ enum class StrId : uint16_t {
   STR_ALIGN_LEFT,
   STR_CENTER,
   STR_ALIGN_RIGHT,
+  STR_IMMEDIATE,
+  STR_SEC_HALF,
+  STR_SEC_1,
+  STR_SEC_2,
   STR_MIN_1,
   STR_MIN_5,
   STR_MIN_10,
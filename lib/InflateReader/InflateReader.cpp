@@ -1,11 +1,24 @@
 #include "InflateReader.h"
 
+#include <atomic>
 #include <cstring>
 #include <type_traits>
 
 namespace {
 constexpr size_t INFLATE_DICT_SIZE = 32768;
-}
+
+// Empty: nothing allocated. Free: reserved, waiting for a reader. Taken: a reader has it. Released: freed by
+// releaseWindows() while a reader had it, so that reader frees it when it gives it back.
+enum class WindowState : uint8_t { Empty, Free, Taken, Released };
+
+struct ReservedWindow {
+  uint8_t* ringBuffer = nullptr;
+  unsigned short* decodeTables = nullptr;
+  std::atomic<WindowState> state{WindowState::Empty};
+};
+
+ReservedWindow reservedWindows[InflateReader::MAX_RESERVED_WINDOWS];
+}  // namespace
 
 // Guarantee the cast pattern in the header comment is valid.
 static_assert(std::is_standard_layout<InflateReader>::value,
@@ -14,24 +27,125 @@ static_assert(std::is_standard_layout<InflateReader>::value,
 InflateReader::~InflateReader() { deinit(); }
 
 bool InflateReader::init(const bool streaming) {
-  deinit();  // free any previously allocated ring buffer and reset state
+  // Free any previously allocated ring buffer and reset state. The decode tables are kept, so a reader that inflates
+  // many small streams (font groups) allocates them once.
+  releaseRingBuffer();
+  memset(&decomp, 0, sizeof(decomp));
 
-  if (streaming) {
+  if (streaming && !takeReservedWindow()) {
     ringBuffer = static_cast<uint8_t*>(malloc(INFLATE_DICT_SIZE));
     if (!ringBuffer) return false;
+  }
+  if (ringBuffer) {
     memset(ringBuffer, 0, INFLATE_DICT_SIZE);
   }
 
+  if (!decodeTables) {
+    // Optional: without them uzlib falls back to decoding every code bit by bit
+    decodeTables = static_cast<unsigned short*>(malloc(UZLIB_FAST_TABLES_LEN * sizeof(unsigned short)));
+  }
+
   uzlib_uncompress_init(&decomp, ringBuffer, ringBuffer ? INFLATE_DICT_SIZE : 0);
+  uzlib_uncompress_set_fast_tables(&decomp, decodeTables);
   return true;
 }
 
 void InflateReader::deinit() {
+  releaseRingBuffer();
+  if (decodeTables) {
+    free(decodeTables);
+    decodeTables = nullptr;
+  }
+  memset(&decomp, 0, sizeof(decomp));
+}
+
+bool InflateReader::reserveWindows(const size_t count) {
+  size_t reserved = 0;
+  for (const auto& w : reservedWindows) {
+    const WindowState state = w.state.load();
+    reserved += state == WindowState::Free || state == WindowState::Taken;
+  }
+  for (auto& w : reservedWindows) {
+    if (reserved >= count) {
+      break;
+    }
+    if (w.state.load() != WindowState::Empty) {
+      continue;
+    }
+    w.ringBuffer = static_cast<uint8_t*>(malloc(INFLATE_DICT_SIZE));
+    w.decodeTables = static_cast<unsigned short*>(malloc(UZLIB_FAST_TABLES_LEN * sizeof(unsigned short)));
+    if (!w.ringBuffer || !w.decodeTables) {
+      free(w.ringBuffer);
+      free(w.decodeTables);
+      w.ringBuffer = nullptr;
+      w.decodeTables = nullptr;
+      return false;
+    }
+    w.state.store(WindowState::Free);
+    reserved++;
+  }
+  return reserved >= count;
+}
+
+void InflateReader::releaseWindows() {
+  for (auto& w : reservedWindows) {
+    while (true) {
+      // Claim it back from the pool, or leave it to free to the reader that has it
+      WindowState expected = WindowState::Free;
+      if (w.state.compare_exchange_strong(expected, WindowState::Taken)) {
+        free(w.ringBuffer);
+        free(w.decodeTables);
+        w.ringBuffer = nullptr;
+        w.decodeTables = nullptr;
+        w.state.store(WindowState::Empty);
+        break;
+      }
+      if (expected != WindowState::Taken || w.state.compare_exchange_strong(expected, WindowState::Released)) {
+        break;
+      }
+      // Given back in between: claim it on the next pass
+    }
+  }
+}
+
+bool InflateReader::takeReservedWindow() {
+  for (size_t i = 0; i < MAX_RESERVED_WINDOWS; i++) {
+    ReservedWindow& w = reservedWindows[i];
+    WindowState expected = WindowState::Free;
+    if (!w.state.compare_exchange_strong(expected, WindowState::Taken)) {
+      continue;
+    }
+    // The window comes with its own tables
+    free(decodeTables);
+    ringBuffer = w.ringBuffer;
+    decodeTables = w.decodeTables;
+    reservedWindow = static_cast<int>(i);
+    return true;
+  }
+  return false;
+}
+
+void InflateReader::releaseRingBuffer() {
+  if (reservedWindow >= 0) {
+    // The tables go back with the window, unless the pool was released meanwhile
+    ReservedWindow& w = reservedWindows[reservedWindow];
+    WindowState expected = WindowState::Taken;
+    if (!w.state.compare_exchange_strong(expected, WindowState::Free)) {
+      free(w.ringBuffer);
+      free(w.decodeTables);
+      w.ringBuffer = nullptr;
+      w.decodeTables = nullptr;
+      w.state.store(WindowState::Empty);
+    }
+    reservedWindow = -1;
+    ringBuffer = nullptr;
+    decodeTables = nullptr;
+    return;
+  }
   if (ringBuffer) {
     free(ringBuffer);
     ringBuffer = nullptr;
   }
-  memset(&decomp, 0, sizeof(decomp));
 }
 
 void InflateReader::setSource(const uint8_t* src, size_t len) {
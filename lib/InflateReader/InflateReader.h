@@ -18,6 +18,17 @@ enum class InflateStatus {
 //   init(true)   — streaming: allocates a 32KB ring buffer for back-references
 //                  across multiple read() / readAtMost() calls.
 //
+// Both modes also allocate 2KB of Huffman lookup tables, kept until deinit() so
+// repeated init() calls reuse them. Codes of up to 9 bits (nearly all of them)
+// decode in one step; if the allocation fails, uzlib decodes bit by bit.
+//
+// Reserved windows:
+//   reserveWindows() sets ring buffers and lookup tables aside for a session
+//   (a book being opened and read). Streaming readers take a free one instead of
+//   allocating and give it back in deinit(), so reading entry after entry no
+//   longer allocates and frees 32KB each time. With none reserved, or all of
+//   them taken, readers allocate their own as before.
+//
 // Streaming callback pattern:
 //   The uzlib read callback receives a `struct uzlib_uncomp*` with no separate
 //   context pointer. To attach context, make InflateReader the *first member* of
@@ -49,9 +60,16 @@ class InflateReader {
   // Returns false only in streaming mode if the ring buffer allocation fails.
   bool init(bool streaming = false);
 
-  // Release the ring buffer and reset internal state.
+  // Release the ring buffer and lookup tables and reset internal state.
   void deinit();
 
+  // Allocates windows with their lookup tables up front until `count` (at most MAX_RESERVED_WINDOWS) are reserved.
+  // Returns false if they couldn't all be allocated; the ones that could stay reserved. releaseWindows() frees the
+  // free ones right away and the ones readers still hold when those readers give them back.
+  static constexpr size_t MAX_RESERVED_WINDOWS = 2;
+  static bool reserveWindows(size_t count);
+  static void releaseWindows();
+
   // Set the entire compressed input as a contiguous memory buffer.
   // Used in one-shot mode; not needed when a read callback is set.
   void setSource(const uint8_t* src, size_t len);
@@ -82,4 +100,9 @@ class InflateReader {
  private:
   uzlib_uncomp decomp = {};
   uint8_t* ringBuffer = nullptr;
+  unsigned short* decodeTables = nullptr;
+  int reservedWindow = -1;  // While set, ringBuffer and decodeTables belong to that reserved window
+
+  bool takeReservedWindow();
+  void releaseRingBuffer();
 };
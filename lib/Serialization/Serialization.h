@@ -1,7 +1,10 @@
 #pragma once
 #include <HalStorage.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 namespace serialization {
 template <typename T>
@@ -11,7 +14,7 @@ static void writePod(std::ostream& os, const T& value) {
 
 template <typename T>
 static void writePod(FsFile& file, const T& value) {
-  file.write(reinterpret_cast<const uint8_t*>(&value), sizeof(T));
+  Storage.write(file, &value, sizeof(T));
 }
 
 template <typename T>
@@ -21,7 +24,7 @@ static void readPod(std::istream& is, T& value) {
 
 template <typename T>
 static void readPod(FsFile& file, T& value) {
-  file.read(reinterpret_cast<uint8_t*>(&value), sizeof(T));
+  Storage.read(file, &value, sizeof(T));
 }
 
 static void writeString(std::ostream& os, const std::string& s) {
@@ -33,7 +36,7 @@ static void writeString(std::ostream& os, const std::string& s) {
 static void writeString(FsFile& file, const std::string& s) {
   const uint32_t len = s.size();
   writePod(file, len);
-  file.write(reinterpret_cast<const uint8_t*>(s.data()), len);
+  Storage.write(file, s.data(), len);
 }
 
 static void readString(std::istream& is, std::string& s) {
@@ -47,6 +50,278 @@ static void readString(FsFile& file, std::string& s) {
   uint32_t len;
   readPod(file, len);
   s.resize(len);
-  file.read(&s[0], len);
+  Storage.read(file, &s[0], len);
+}
+
+// Reads a file through a sector-sized buffer, so the many small fields of a cache record cost one driver call per
+// sector instead of one per field. Refills end on sector boundaries, which lets SdFat move whole sectors straight
+// into the buffer. A read past the end of the file zero-fills what is missing and clears ok() for good.
+class BufferedReader {
+ public:
+  static constexpr size_t BUFFER_SIZE = 512;
+
+  explicit BufferedReader(FsFile& file) : file(file), bufferStart(file.position()) {}
+  BufferedReader(const BufferedReader&) = delete;
+  BufferedReader& operator=(const BufferedReader&) = delete;
+
+  bool read(void* out, const size_t len) {
+    if (len <= static_cast<size_t>(length - offset)) {
+      memcpy(out, buffer + offset, len);
+      offset += len;
+      return true;
+    }
+    return refillAndRead(static_cast<uint8_t*>(out), len);
+  }
+
+  // Next byte, or -1 at the end of the file
+  int read() {
+    if (offset == length && !fill()) {
+      failed = true;
+      return -1;
+    }
+    return buffer[offset++];
+  }
+
+  // Seeking inside the buffered range moves no data and doesn't touch the file
+  bool seek(const uint32_t pos) {
+    if (pos >= bufferStart && pos <= bufferStart + length) {
+      offset = pos - bufferStart;
+      return true;
+    }
+    bufferStart = pos;
+    offset = length = 0;
+    if (!Storage.seek(file, pos)) {
+      failed = true;
+    }
+    return !failed;
+  }
+  bool skip(const uint32_t n) { return seek(position() + n); }
+
+  uint32_t position() const { return bufferStart + offset; }
+  uint32_t remaining() const {
+    const uint32_t size = file.size();
+    return size > position() ? size - position() : 0;
+  }
+  bool ok() const { return !failed; }
+
+ private:
+  FsFile& file;
+  uint32_t bufferStart;  // File offset of buffer[0]; the file itself sits at bufferStart + length
+  uint16_t offset = 0;
+  uint16_t length = 0;
+  bool failed = false;
+  uint8_t buffer[BUFFER_SIZE];
+
+  // Moves the buffer on to the data that follows it. False at the end of the file.
+  bool fill() {
+    bufferStart += length;
+    offset = 0;
+    const int n = Storage.read(file, buffer, BUFFER_SIZE - bufferStart % BUFFER_SIZE);
+    length = n > 0 ? n : 0;
+    return length > 0;
+  }
+
+  // A refill can stop short at a sector boundary, so small reads may take two
+  bool refillAndRead(uint8_t* out, size_t len) {
+    while (true) {
+      const size_t buffered = std::min<size_t>(length - offset, len);
+      memcpy(out, buffer + offset, buffered);
+      offset += buffered;
+      out += buffered;
+      len -= buffered;
+      if (len == 0) {
+        return true;
+      }
+
+      if (len >= BUFFER_SIZE) {
+        // Large reads skip the buffer
+        bufferStart += length;
+        offset = length = 0;
+        const int n = Storage.read(file, out, len);
+        const size_t got = n > 0 ? std::min<size_t>(n, len) : 0;
+        bufferStart += got;
+        if (got == len) {
+          return true;
+        }
+        memset(out + got, 0, len - got);
+        failed = true;
+        return false;
+      }
+
+      if (!fill()) {
+        memset(out, 0, len);
+        failed = true;
+        return false;
+      }
+    }
+  }
+};
+
+// Collects small writes in a sector-sized buffer and hands them to the file a sector at a time. Data reaches the
+// file on flush(), seek() or destruction; ok() turns false once any of it failed to.
+class BufferedWriter {
+ public:
+  static constexpr size_t BUFFER_SIZE = 512;
+
+  explicit BufferedWriter(FsFile& file) : file(file), bufferStart(file.position()) {}
+  BufferedWriter(const BufferedWriter&) = delete;
+  BufferedWriter& operator=(const BufferedWriter&) = delete;
+  ~BufferedWriter() { flush(); }
+
+  bool write(const void* data, const size_t len) {
+    if (len <= capacity() - length) {
+      memcpy(buffer + length, data, len);
+      length += len;
+      return true;
+    }
+    return flushAndWrite(static_cast<const uint8_t*>(data), len);
+  }
+  bool write(const uint8_t b) { return write(&b, 1); }
+
+  bool flush() {
+    if (length > 0) {
+      if (Storage.write(file, buffer, length) != length) {
+        failed = true;
+      }
+      bufferStart += length;
+      length = 0;
+    }
+    return !failed;
+  }
+
+  bool seek(const uint32_t pos) {
+    flush();
+    bufferStart = pos;
+    if (!Storage.seek(file, pos)) {
+      failed = true;
+    }
+    return !failed;
+  }
+
+  uint32_t position() const { return bufferStart + length; }
+  bool ok() const { return !failed; }
+
+ private:
+  FsFile& file;
+  uint32_t bufferStart;  // File offset buffer[0] will be written at
+  uint16_t length = 0;
+  bool failed = false;
+  uint8_t buffer[BUFFER_SIZE];
+
+  // Flushes end on sector boundaries
+  size_t capacity() const { return BUFFER_SIZE - bufferStart % BUFFER_SIZE; }
+
+  bool flushAndWrite(const uint8_t* data, size_t len) {
+    const size_t fits = capacity() - length;
+    memcpy(buffer + length, data, fits);
+    length += fits;
+    data += fits;
+    len -= fits;
+    flush();
+
+    // Write whole sectors straight from the caller's memory, buffer the tail
+    const size_t direct = len - len % BUFFER_SIZE;
+    if (direct > 0) {
+      if (Storage.write(file, data, direct) != direct) {
+        failed = true;
+      }
+      bufferStart += direct;
+      data += direct;
+      len -= direct;
+    }
+    memcpy(buffer, data, len);
+    length = len;
+    return !failed;
+  }
+};
+
+template <typename T>
+static bool writePod(BufferedWriter& writer, const T& value) {
+  return writer.write(&value, sizeof(T));
+}
+
+template <typename T>
+static bool readPod(BufferedReader& reader, T& value) {
+  return reader.read(&value, sizeof(T));
+}
+
+static bool writeString(BufferedWriter& writer, const std::string& s) {
+  const uint32_t len = s.size();
+  writePod(writer, len);
+  return writer.write(s.data(), len);
+}
+
+// Rejects a length that runs past the end of the file instead of allocating it
+static bool readString(BufferedReader& reader, std::string& s) {
+  uint32_t len;
+  if (!readPod(reader, len) || len > reader.remaining()) {
+    s.clear();
+    return false;
+  }
+  s.resize(len);
+  return reader.read(&s[0], len);
+}
+
+// CRC-32 (the zlib polynomial) of `len` bytes, continuing from `crc`; start from 0. A nibble at a time, so the table
+// is 64 bytes rather than 1KB.
+static uint32_t crc32(uint32_t crc, const void* data, const size_t len) {
+  static constexpr uint32_t table[16] = {0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+                                         0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+                                         0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+  const auto* p = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (size_t i = 0; i < len; i++) {
+    crc = table[(crc ^ p[i]) & 0x0f] ^ (crc >> 4);
+    crc = table[(crc ^ (p[i] >> 4)) & 0x0f] ^ (crc >> 4);
+  }
+  return ~crc;
+}
+
+// Same, over `len` bytes of `file` from `offset`. False if the file ends first. Sealing reads back through the handle
+// from Storage.openFileForWrite, which is opened read-write for this.
+static bool crc32(FsFile& file, const uint32_t offset, uint32_t len, uint32_t& crc) {
+  if (!Storage.seek(file, offset)) {
+    return false;
+  }
+  uint8_t chunk[256];
+  while (len > 0) {
+    const int n = Storage.read(file, chunk, std::min<size_t>(sizeof(chunk), len));
+    if (n <= 0) {
+      return false;
+    }
+    crc = crc32(crc, chunk, n);
+    len -= n;
+  }
+  return true;
+}
+
+// Cache files are built under a temporary name and moved into place once complete (HalStorage::replace), and end in
+// this trailer: a CRC-32 of the parts the loader trusts without further checks (headers and lookup tables) and the
+// length the file had when it was sealed. Checking it costs the loader a few sectors, not a pass over the file.
+struct Trailer {
+  uint32_t crc;
+  uint32_t length;
+  uint32_t magic;
+};
+constexpr uint32_t TRAILER_MAGIC = 0x4C414553;  // "SEAL"
+
+// Appends the trailer to a finished file
+static bool writeTrailer(FsFile& file, const uint32_t crc) {
+  const uint32_t size = file.size();
+  const Trailer trailer{crc, static_cast<uint32_t>(size + sizeof(Trailer)), TRAILER_MAGIC};
+  return Storage.seek(file, size) && Storage.write(file, &trailer, sizeof(trailer)) == sizeof(trailer);
+}
+
+// The CRC from the trailer, if the file has one and is still the length it was sealed at
+static bool readTrailer(FsFile& file, uint32_t& crc) {
+  const uint64_t size = file.size();
+  Trailer trailer;
+  if (size < sizeof(trailer) || !Storage.seek(file, size - sizeof(trailer)) ||
+      Storage.read(file, &trailer, sizeof(trailer)) != static_cast<int>(sizeof(trailer)) ||
+      trailer.magic != TRAILER_MAGIC || trailer.length != size) {
+    return false;
+  }
+  crc = trailer.crc;
+  return true;
 }
 }  // namespace serialization
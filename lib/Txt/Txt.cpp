@@ -3,6 +3,7 @@
 #include <FsHelpers.h>
 #include <JpegToBmpConverter.h>
 #include <Logging.h>
+#include <StorageStats.h>
 
 Txt::Txt(std::string path, std::string cacheBasePath)
     : filepath(std::move(path)), cacheBasePath(std::move(cacheBasePath)) {
@@ -98,6 +99,7 @@ std::string Txt::findCoverImage() const {
 std::string Txt::getCoverBmpPath() const { return cachePath + "/cover.bmp"; }
 
 bool Txt::generateCoverBmp() const {
+  StorageStats::Scope ioScope(StorageStats::Tag::Thumbnails);
   // Already generated, return true
   if (Storage.exists(getCoverBmpPath().c_str())) {
     return true;
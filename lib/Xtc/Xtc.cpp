@@ -9,6 +9,8 @@
 
 #include <HalStorage.h>
 #include <Logging.h>
+#include <Serialization.h>
+#include <StorageStats.h>
 
 bool Xtc::load() {
   LOG_DBG("XTC", "Loading XTC: %s", filepath.c_str());
@@ -113,6 +115,7 @@ const std::vector<xtc::ChapterInfo>& Xtc::getChapters() const {
 std::string Xtc::getCoverBmpPath() const { return cachePath + "/cover.bmp"; }
 
 bool Xtc::generateCoverBmp() const {
+  StorageStats::Scope ioScope(StorageStats::Tag::Thumbnails);
   // Already generated
   if (Storage.exists(getCoverBmpPath().c_str())) {
     return true;
@@ -171,6 +174,7 @@ bool Xtc::generateCoverBmp() const {
     free(pageBuffer);
     return false;
   }
+  serialization::BufferedWriter bmp(coverBmp);
 
   // Write BMP header
   // BMP file header (14 bytes)
@@ -179,45 +183,45 @@ bool Xtc::generateCoverBmp() const {
   const uint32_t fileSize = 14 + 40 + 8 + imageSize;  // Header + DIB + palette + data
 
   // File header
-  coverBmp.write('B');
-  coverBmp.write('M');
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&fileSize), 4);
+  bmp.write('B');
+  bmp.write('M');
+  bmp.write(reinterpret_cast<const uint8_t*>(&fileSize), 4);
   uint32_t reserved = 0;
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&reserved), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&reserved), 4);
   uint32_t dataOffset = 14 + 40 + 8;  // 1-bit palette has 2 colors (8 bytes)
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&dataOffset), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&dataOffset), 4);
 
   // DIB header (BITMAPINFOHEADER - 40 bytes)
   uint32_t dibHeaderSize = 40;
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&dibHeaderSize), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&dibHeaderSize), 4);
   int32_t width = pageInfo.width;
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&width), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&width), 4);
   int32_t height = -static_cast<int32_t>(pageInfo.height);  // Negative for top-down
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&height), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&height), 4);
   uint16_t planes = 1;
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&planes), 2);
+  bmp.write(reinterpret_cast<const uint8_t*>(&planes), 2);
   uint16_t bitsPerPixel = 1;  // 1-bit monochrome
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&bitsPerPixel), 2);
+  bmp.write(reinterpret_cast<const uint8_t*>(&bitsPerPixel), 2);
   uint32_t compression = 0;  // BI_RGB (no compression)
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&compression), 4);
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&imageSize), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&compression), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&imageSize), 4);
   int32_t ppmX = 2835;  // 72 DPI
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&ppmX), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&ppmX), 4);
   int32_t ppmY = 2835;
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&ppmY), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&ppmY), 4);
   uint32_t colorsUsed = 2;
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&colorsUsed), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&colorsUsed), 4);
   uint32_t colorsImportant = 2;
-  coverBmp.write(reinterpret_cast<const uint8_t*>(&colorsImportant), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&colorsImportant), 4);
 
   // Color palette (2 colors for 1-bit)
   // XTC 1-bit polarity: 0 = black, 1 = white (standard BMP palette order)
   // Color 0: Black (text/foreground in XTC)
   uint8_t black[4] = {0x00, 0x00, 0x00, 0x00};
-  coverBmp.write(black, 4);
+  bmp.write(black, 4);
   // Color 1: White (background in XTC)
   uint8_t white[4] = {0xFF, 0xFF, 0xFF, 0x00};
-  coverBmp.write(white, 4);
+  bmp.write(white, 4);
 
   // Write bitmap data
   // BMP requires 4-byte row alignment
@@ -266,13 +270,13 @@ bool Xtc::generateCoverBmp() const {
       }
 
       // Write converted row
-      coverBmp.write(rowBuffer, dstRowSize);
+      bmp.write(rowBuffer, dstRowSize);
 
       // Pad to 4-byte boundary
       uint8_t padding[4] = {0, 0, 0, 0};
       size_t paddingSize = rowSize - dstRowSize;
       if (paddingSize > 0) {
-        coverBmp.write(padding, paddingSize);
+        bmp.write(padding, paddingSize);
       }
     }
 
@@ -283,17 +287,18 @@ bool Xtc::generateCoverBmp() const {
 
     for (uint16_t y = 0; y < pageInfo.height; y++) {
       // Write source row
-      coverBmp.write(pageBuffer + y * srcRowSize, srcRowSize);
+      bmp.write(pageBuffer + y * srcRowSize, srcRowSize);
 
       // Pad to 4-byte boundary
       uint8_t padding[4] = {0, 0, 0, 0};
       size_t paddingSize = rowSize - srcRowSize;
       if (paddingSize > 0) {
-        coverBmp.write(padding, paddingSize);
+        bmp.write(padding, paddingSize);
       }
     }
   }
 
+  bmp.flush();
   coverBmp.close();
   free(pageBuffer);
 
@@ -305,6 +310,7 @@ std::string Xtc::getThumbBmpPath() const { return cachePath + "/thumb_[HEIGHT].b
 std::string Xtc::getThumbBmpPath(int height) const { return cachePath + "/thumb_" + std::to_string(height) + ".bmp"; }
 
 bool Xtc::generateThumbBmp(int height) const {
+  StorageStats::Scope ioScope(StorageStats::Tag::Thumbnails);
   // Already generated
   if (Storage.exists(getThumbBmpPath(height).c_str())) {
     return true;
@@ -399,6 +405,7 @@ bool Xtc::generateThumbBmp(int height) const {
     free(pageBuffer);
     return false;
   }
+  serialization::BufferedWriter bmp(thumbBmp);
 
   // Write 1-bit BMP header for fast home screen rendering
   const uint32_t rowSize = (thumbWidth + 31) / 32 * 4;  // 1 bit per pixel, aligned to 4 bytes
@@ -406,43 +413,43 @@ bool Xtc::generateThumbBmp(int height) const {
   const uint32_t fileSize = 14 + 40 + 8 + imageSize;  // 8 bytes for 2-color palette
 
   // File header
-  thumbBmp.write('B');
-  thumbBmp.write('M');
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&fileSize), 4);
+  bmp.write('B');
+  bmp.write('M');
+  bmp.write(reinterpret_cast<const uint8_t*>(&fileSize), 4);
   uint32_t reserved = 0;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&reserved), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&reserved), 4);
   uint32_t dataOffset = 14 + 40 + 8;  // 1-bit palette has 2 colors (8 bytes)
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&dataOffset), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&dataOffset), 4);
 
   // DIB header
   uint32_t dibHeaderSize = 40;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&dibHeaderSize), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&dibHeaderSize), 4);
   int32_t widthVal = thumbWidth;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&widthVal), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&widthVal), 4);
   int32_t heightVal = -static_cast<int32_t>(thumbHeight);  // Negative for top-down
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&heightVal), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&heightVal), 4);
   uint16_t planes = 1;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&planes), 2);
+  bmp.write(reinterpret_cast<const uint8_t*>(&planes), 2);
   uint16_t bitsPerPixel = 1;  // 1-bit for black and white
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&bitsPerPixel), 2);
+  bmp.write(reinterpret_cast<const uint8_t*>(&bitsPerPixel), 2);
   uint32_t compression = 0;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&compression), 4);
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&imageSize), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&compression), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&imageSize), 4);
   int32_t ppmX = 2835;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&ppmX), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&ppmX), 4);
   int32_t ppmY = 2835;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&ppmY), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&ppmY), 4);
   uint32_t colorsUsed = 2;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&colorsUsed), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&colorsUsed), 4);
   uint32_t colorsImportant = 2;
-  thumbBmp.write(reinterpret_cast<const uint8_t*>(&colorsImportant), 4);
+  bmp.write(reinterpret_cast<const uint8_t*>(&colorsImportant), 4);
 
   // Color palette (2 colors for 1-bit: black and white)
   uint8_t palette[8] = {
       0x00, 0x00, 0x00, 0x00,  // Color 0: Black
       0xFF, 0xFF, 0xFF, 0x00   // Color 1: White
   };
-  thumbBmp.write(palette, 8);
+  bmp.write(palette, 8);
 
   // Allocate row buffer for 1-bit output
   uint8_t* rowBuffer = static_cast<uint8_t*>(malloc(rowSize));
@@ -551,10 +558,11 @@ bool Xtc::generateThumbBmp(int height) const {
     }
 
     // Write row (already padded to 4-byte boundary by rowSize)
-    thumbBmp.write(rowBuffer, rowSize);
+    bmp.write(rowBuffer, rowSize);
   }
 
   free(rowBuffer);
+  bmp.flush();
   thumbBmp.close();
   free(pageBuffer);
 
@@ -10,6 +10,7 @@
 #include <FsHelpers.h>
 #include <HalStorage.h>
 #include <Logging.h>
+#include <Serialization.h>
 
 #include <cstring>
 
@@ -177,11 +178,11 @@ XtcError XtcParser::readPageTable() {
 
   m_pageTable.resize(m_header.pageCount);
 
-  // Read page table entries
+  // Read page table entries, 32 to a sector
+  serialization::BufferedReader reader(m_file);
   for (uint16_t i = 0; i < m_header.pageCount; i++) {
     PageTableEntry entry;
-    size_t bytesRead = m_file.read(reinterpret_cast<uint8_t*>(&entry), sizeof(PageTableEntry));
-    if (bytesRead != sizeof(PageTableEntry)) {
+    if (!serialization::readPod(reader, entry)) {
       LOG_DBG("XTC", "Failed to read page table entry %u", i);
       return XtcError::READ_ERROR;
     }
@@ -261,8 +262,9 @@ XtcError XtcParser::readChapters() {
   }
 
   std::vector<uint8_t> chapterBuf(chapterSize);
+  serialization::BufferedReader reader(m_file);
   for (size_t i = 0; i < chapterCount; i++) {
-    if (m_file.read(chapterBuf.data(), chapterSize) != chapterSize) {
+    if (!reader.read(chapterBuf.data(), chapterSize)) {
       return XtcError::READ_ERROR;
     }
 
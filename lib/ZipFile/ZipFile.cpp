@@ -3,8 +3,10 @@
 #include <HalStorage.h>
 #include <InflateReader.h>
 #include <Logging.h>
+#include <Serialization.h>
 
 #include <algorithm>
+#include <cstring>
 
 struct ZipInflateCtx {
   InflateReader reader;  // Must be first — callback casts uzlib_uncomp* to ZipInflateCtx*
@@ -18,12 +20,50 @@ namespace {
 constexpr uint16_t ZIP_METHOD_STORED = 0;
 constexpr uint16_t ZIP_METHOD_DEFLATED = 8;
 
+constexpr uint32_t ZIP_INDEX_MAGIC = 0x5844495a;  // "ZIDX"
+constexpr uint32_t ZIP_INDEX_VERSION = 2;
+// Entries gathered per central directory pass while building the index (28 bytes each)
+constexpr size_t ZIP_INDEX_ENTRIES_PER_PASS = 1024;
+
+#pragma pack(push, 1)
+struct ZipIndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t zipSize;
+  uint32_t zipModified;  // FAT date << 16 | time
+  uint32_t centralDirOffset;
+  uint32_t entryCount;
+};
+
+struct ZipIndexEntry {
+  uint64_t hash;  // fnvHash64 of the entry name
+  uint32_t compressedSize;
+  uint32_t uncompressedSize;
+  uint32_t localHeaderOffset;
+  uint32_t dataOffset;
+  uint16_t method;
+  uint16_t nameLen;
+};
+#pragma pack(pop)
+
+// Followed by uint16_t fanout[256]: number of entries whose top hash byte is <= i, then the entries, then the
+// serialization trailer sealing the header and fanout
+constexpr size_t ZIP_INDEX_FANOUT_OFFSET = sizeof(ZipIndexHeader);
+constexpr size_t ZIP_INDEX_ENTRIES_OFFSET = ZIP_INDEX_FANOUT_OFFSET + 256 * sizeof(uint16_t);
+
+// Moves past `count` bytes of the central directory, counted in StorageStats like the reads around it
+bool skip(FsFile& file, const uint32_t count) { return Storage.seek(file, file.position() + count); }
+
+bool indexKeyLess(const uint64_t hashA, const uint16_t lenA, const uint64_t hashB, const uint16_t lenB) {
+  return hashA < hashB || (hashA == hashB && lenA < lenB);
+}
+
 int zipReadCallback(uzlib_uncomp* uncomp) {
   auto* ctx = reinterpret_cast<ZipInflateCtx*>(uncomp);
   if (ctx->fileRemaining == 0) return -1;
 
   const size_t toRead = ctx->fileRemaining < ctx->readBufSize ? ctx->fileRemaining : ctx->readBufSize;
-  const size_t bytesRead = ctx->file->read(ctx->readBuf, toRead);
+  const size_t bytesRead = Storage.read(*ctx->file, ctx->readBuf, toRead);
   ctx->fileRemaining -= bytesRead;
 
   if (bytesRead == 0) return -1;
@@ -47,7 +87,7 @@ bool ZipFile::loadAllFileStatSlims() {
     return false;
   }
 
-  file.seek(zipDetails.centralDirOffset);
+  Storage.seek(file, zipDetails.centralDirOffset);
 
   uint32_t sig;
   char itemName[256];
@@ -55,29 +95,29 @@ bool ZipFile::loadAllFileStatSlims() {
   fileStatSlimCache.reserve(zipDetails.totalEntries);
 
   while (file.available()) {
-    file.read(&sig, 4);
+    Storage.read(file, &sig, 4);
     if (sig != 0x02014b50) break;  // End of list
 
     FileStatSlim fileStat = {};
 
-    file.seekCur(6);
-    file.read(&fileStat.method, 2);
-    file.seekCur(8);
-    file.read(&fileStat.compressedSize, 4);
-    file.read(&fileStat.uncompressedSize, 4);
+    skip(file, 6);
+    Storage.read(file, &fileStat.method, 2);
+    skip(file, 8);
+    Storage.read(file, &fileStat.compressedSize, 4);
+    Storage.read(file, &fileStat.uncompressedSize, 4);
     uint16_t nameLen, m, k;
-    file.read(&nameLen, 2);
-    file.read(&m, 2);
-    file.read(&k, 2);
-    file.seekCur(8);
-    file.read(&fileStat.localHeaderOffset, 4);
-    file.read(itemName, nameLen);
+    Storage.read(file, &nameLen, 2);
+    Storage.read(file, &m, 2);
+    Storage.read(file, &k, 2);
+    skip(file, 8);
+    Storage.read(file, &fileStat.localHeaderOffset, 4);
+    Storage.read(file, itemName, nameLen);
     itemName[nameLen] = '\0';
 
     fileStatSlimCache.emplace(itemName, fileStat);
 
     // Skip the rest of this entry (extra field + comment)
-    file.seekCur(m + k);
+    skip(file, m + k);
   }
 
   // Set cursor to start of central directory for sequential access
@@ -105,6 +145,14 @@ bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
     return false;
   }
 
+  if (openIndex()) {
+    const bool found = findInIndex(filename, fileStat);
+    if (!wasOpen) {
+      close();
+    }
+    return found;
+  }
+
   if (!loadZipDetails()) {
     if (!wasOpen) {
       close();
@@ -117,7 +165,7 @@ bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
   bool wrapped = false;
   bool found = false;
 
-  file.seek(startPos);
+  Storage.seek(file, startPos);
 
   uint32_t sig;
   char itemName[256];
@@ -125,11 +173,11 @@ bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
   while (true) {
     uint32_t entryStart = file.position();
 
-    if (file.read(&sig, 4) != 4 || sig != 0x02014b50) {
+    if (Storage.read(file, &sig, 4) != 4 || sig != 0x02014b50) {
       // End of central directory
       if (!wrapped && lastCentralDirPosValid && startPos != zipDetails.centralDirOffset) {
         // Wrap around to beginning
-        file.seek(zipDetails.centralDirOffset);
+        Storage.seek(file, zipDetails.centralDirOffset);
         wrapped = true;
         continue;
       }
@@ -141,25 +189,25 @@ bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
       break;
     }
 
-    file.seekCur(6);
-    file.read(&fileStat->method, 2);
-    file.seekCur(8);
-    file.read(&fileStat->compressedSize, 4);
-    file.read(&fileStat->uncompressedSize, 4);
+    skip(file, 6);
+    Storage.read(file, &fileStat->method, 2);
+    skip(file, 8);
+    Storage.read(file, &fileStat->compressedSize, 4);
+    Storage.read(file, &fileStat->uncompressedSize, 4);
     uint16_t nameLen, m, k;
-    file.read(&nameLen, 2);
-    file.read(&m, 2);
-    file.read(&k, 2);
-    file.seekCur(8);
-    file.read(&fileStat->localHeaderOffset, 4);
+    Storage.read(file, &nameLen, 2);
+    Storage.read(file, &m, 2);
+    Storage.read(file, &k, 2);
+    skip(file, 8);
+    Storage.read(file, &fileStat->localHeaderOffset, 4);
 
     if (nameLen < 256) {
-      file.read(itemName, nameLen);
+      Storage.read(file, itemName, nameLen);
       itemName[nameLen] = '\0';
 
       if (strcmp(itemName, filename) == 0) {
         // Found it! Update cursor to next entry
-        file.seekCur(m + k);
+        skip(file, m + k);
         lastCentralDirPos = file.position();
         lastCentralDirPosValid = true;
         found = true;
@@ -167,11 +215,11 @@ bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
       }
     } else {
       // Name too long, skip it
-      file.seekCur(nameLen);
+      skip(file, nameLen);
     }
 
     // Skip extra field + comment
-    file.seekCur(m + k);
+    skip(file, m + k);
   }
 
   if (!wasOpen) {
@@ -181,6 +229,10 @@ bool ZipFile::loadFileStatSlim(const char* filename, FileStatSlim* fileStat) {
 }
 
 long ZipFile::getDataOffset(const FileStatSlim& fileStat) {
+  if (fileStat.dataOffset != 0) {
+    return fileStat.dataOffset;
+  }
+
   const bool wasOpen = isOpen();
   if (!wasOpen && !open()) {
     return -1;
@@ -191,8 +243,8 @@ long ZipFile::getDataOffset(const FileStatSlim& fileStat) {
   uint8_t pLocalHeader[localHeaderSize];
   const uint64_t fileOffset = fileStat.localHeaderOffset;
 
-  file.seek(fileOffset);
-  const size_t read = file.read(pLocalHeader, localHeaderSize);
+  Storage.seek(file, fileOffset);
+  const size_t read = Storage.read(file, pLocalHeader, localHeaderSize);
   if (!wasOpen) {
     close();
   }
@@ -244,8 +296,8 @@ bool ZipFile::loadZipDetails() {
     return false;
   }
 
-  file.seek(fileSize - scanRange);
-  file.read(buffer, scanRange);
+  Storage.seek(file, fileSize - scanRange);
+  Storage.read(file, buffer, scanRange);
 
   // Scan backwards for the signature
   int foundOffset = -1;
@@ -290,8 +342,12 @@ bool ZipFile::open() {
 
 bool ZipFile::close() {
   if (file) {
-    file.close();
+    Storage.close(file);
+  }
+  if (indexFile) {
+    Storage.close(indexFile);
   }
+  indexChecked = false;
   lastCentralDirPos = 0;
   lastCentralDirPosValid = false;
   return true;
@@ -317,6 +373,14 @@ int ZipFile::fillUncompressedSizes(std::vector<SizeTarget>& targets, std::vector
     return 0;
   }
 
+  if (openIndex()) {
+    const int matched = fillUncompressedSizesFromIndex(targets, sizes);
+    if (!wasOpen) {
+      close();
+    }
+    return matched;
+  }
+
   if (!loadZipDetails()) {
     if (!wasOpen) {
       close();
@@ -324,33 +388,33 @@ int ZipFile::fillUncompressedSizes(std::vector<SizeTarget>& targets, std::vector
     return 0;
   }
 
-  file.seek(zipDetails.centralDirOffset);
+  Storage.seek(file, zipDetails.centralDirOffset);
 
   int matched = 0;
   uint32_t sig;
   char itemName[256];
 
   while (file.available()) {
-    file.read(&sig, 4);
+    Storage.read(file, &sig, 4);
     if (sig != 0x02014b50) break;
 
-    file.seekCur(6);
+    skip(file, 6);
     uint16_t method;
-    file.read(&method, 2);
-    file.seekCur(8);
+    Storage.read(file, &method, 2);
+    skip(file, 8);
     uint32_t compressedSize, uncompressedSize;
-    file.read(&compressedSize, 4);
-    file.read(&uncompressedSize, 4);
+    Storage.read(file, &compressedSize, 4);
+    Storage.read(file, &uncompressedSize, 4);
     uint16_t nameLen, m, k;
-    file.read(&nameLen, 2);
-    file.read(&m, 2);
-    file.read(&k, 2);
-    file.seekCur(8);
+    Storage.read(file, &nameLen, 2);
+    Storage.read(file, &m, 2);
+    Storage.read(file, &k, 2);
+    skip(file, 8);
     uint32_t localHeaderOffset;
-    file.read(&localHeaderOffset, 4);
+    Storage.read(file, &localHeaderOffset, 4);
 
     if (nameLen < 256) {
-      file.read(itemName, nameLen);
+      Storage.read(file, itemName, nameLen);
       itemName[nameLen] = '\0';
 
       uint64_t hash = fnvHash64(itemName, nameLen);
@@ -368,10 +432,10 @@ int ZipFile::fillUncompressedSizes(std::vector<SizeTarget>& targets, std::vector
         ++it;
       }
     } else {
-      file.seekCur(nameLen);
+      skip(file, nameLen);
     }
 
-    file.seekCur(m + k);
+    skip(file, m + k);
   }
 
   if (!wasOpen) {
@@ -381,6 +445,309 @@ int ZipFile::fillUncompressedSizes(std::vector<SizeTarget>& targets, std::vector
   return matched;
 }
 
+bool ZipFile::readCentralDirEntry(FileStatSlim* fileStat, char* name, uint16_t* nameLen) {
+  uint32_t sig;
+  if (Storage.read(file, &sig, 4) != 4 || sig != 0x02014b50) {
+    return false;  // End of list
+  }
+
+  *fileStat = {};
+  skip(file, 6);
+  Storage.read(file, &fileStat->method, 2);
+  skip(file, 8);
+  Storage.read(file, &fileStat->compressedSize, 4);
+  Storage.read(file, &fileStat->uncompressedSize, 4);
+  uint16_t m, k;
+  Storage.read(file, nameLen, 2);
+  Storage.read(file, &m, 2);
+  Storage.read(file, &k, 2);
+  skip(file, 8);
+  Storage.read(file, &fileStat->localHeaderOffset, 4);
+
+  // Names that don't fit the buffer are skipped by every lookup, so they are left out of the index too
+  if (*nameLen < 256) {
+    Storage.read(file, name, *nameLen);
+    name[*nameLen] = '\0';
+  } else {
+    skip(file, *nameLen);
+  }
+
+  // Skip extra field + comment
+  skip(file, m + k);
+  return true;
+}
+
+uint32_t ZipFile::getModifiedStamp() {
+  uint16_t date = 0, time = 0;
+  if (!file.getModifyDateTime(&date, &time)) {
+    return 0;
+  }
+  return static_cast<uint32_t>(date) << 16 | time;
+}
+
+bool ZipFile::openIndex() {
+  if (indexFile) {
+    return true;
+  }
+  // Only checked once per open, so a missing or stale index costs one failed open
+  if (indexPath.empty() || indexChecked || !isOpen()) {
+    return false;
+  }
+  indexChecked = true;
+
+  if (!Storage.exists(indexPath.c_str()) || !Storage.openFileForRead("ZIP", indexPath, indexFile)) {
+    return false;
+  }
+
+  ZipIndexHeader header;
+  if (Storage.read(indexFile, &header, sizeof(header)) != sizeof(header) || header.magic != ZIP_INDEX_MAGIC ||
+      header.version != ZIP_INDEX_VERSION || header.zipSize != file.size() ||
+      header.zipModified != getModifiedStamp()) {
+    LOG_DBG("ZIP", "Central directory index is stale, ignoring it");
+    Storage.close(indexFile);
+    return false;
+  }
+
+  // Lookups trust the fanout to bound their search, so it has to be what was sealed
+  uint32_t crc = 0;
+  uint32_t sealed;
+  if (!serialization::crc32(indexFile, 0, ZIP_INDEX_ENTRIES_OFFSET, crc) ||
+      !serialization::readTrailer(indexFile, sealed) || crc != sealed) {
+    LOG_ERR("ZIP", "Central directory index is damaged, ignoring it");
+    Storage.close(indexFile);
+    return false;
+  }
+
+  indexEntryCount = header.entryCount;
+  return true;
+}
+
+bool ZipFile::findInIndex(const char* filename, FileStatSlim* fileStat) {
+  const size_t nameLen = strlen(filename);
+  const uint64_t hash = fnvHash64(filename, nameLen);
+  const uint8_t bucket = hash >> 56;
+
+  // Entries of this bucket are [fanout[bucket - 1], fanout[bucket])
+  uint16_t range[2] = {0, 0};
+  if (bucket == 0) {
+    Storage.seek(indexFile, ZIP_INDEX_FANOUT_OFFSET);
+    Storage.read(indexFile, &range[1], sizeof(uint16_t));
+  } else {
+    Storage.seek(indexFile, ZIP_INDEX_FANOUT_OFFSET + (bucket - 1) * sizeof(uint16_t));
+    Storage.read(indexFile, range, sizeof(range));
+  }
+  if (range[1] > indexEntryCount) {
+    return false;
+  }
+
+  // Buckets hold a handful of entries, all on the sector SdFat has cached after the first probe
+  uint32_t lo = range[0];
+  uint32_t hi = range[1];
+  ZipIndexEntry entry;
+  while (lo < hi) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    Storage.seek(indexFile, ZIP_INDEX_ENTRIES_OFFSET + mid * sizeof(ZipIndexEntry));
+    if (Storage.read(indexFile, &entry, sizeof(entry)) != sizeof(entry)) {
+      return false;
+    }
+    if (entry.hash == hash && entry.nameLen == nameLen) {
+      fileStat->method = entry.method;
+      fileStat->compressedSize = entry.compressedSize;
+      fileStat->uncompressedSize = entry.uncompressedSize;
+      fileStat->localHeaderOffset = entry.localHeaderOffset;
+      fileStat->dataOffset = entry.dataOffset;
+      return true;
+    }
+    if (indexKeyLess(entry.hash, entry.nameLen, hash, nameLen)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return false;
+}
+
+int ZipFile::fillUncompressedSizesFromIndex(const std::vector<SizeTarget>& targets, std::vector<uint32_t>& sizes) {
+  // Both are sorted by (hash, len), so one pass over the index matches them all
+  int matched = 0;
+  auto it = targets.begin();
+  ZipIndexEntry entry;
+  Storage.seek(indexFile, ZIP_INDEX_ENTRIES_OFFSET);
+  for (uint32_t i = 0; i < indexEntryCount && it != targets.end(); i++) {
+    if (Storage.read(indexFile, &entry, sizeof(entry)) != sizeof(entry)) {
+      break;
+    }
+    while (it != targets.end() && indexKeyLess(it->hash, it->len, entry.hash, entry.nameLen)) {
+      ++it;
+    }
+    for (auto match = it; match != targets.end() && match->hash == entry.hash && match->len == entry.nameLen;
+         ++match) {
+      if (match->index < sizes.size()) {
+        sizes[match->index] = entry.uncompressedSize;
+        matched++;
+      }
+    }
+  }
+  return matched;
+}
+
+bool ZipFile::buildIndex() {
+  if (indexPath.empty()) {
+    return false;
+  }
+
+  const bool wasOpen = isOpen();
+  if (!wasOpen && !open()) {
+    return false;
+  }
+
+  if (openIndex()) {
+    if (!wasOpen) {
+      close();
+    }
+    return true;
+  }
+
+  if (!loadZipDetails()) {
+    if (!wasOpen) {
+      close();
+    }
+    return false;
+  }
+
+  const uint32_t start = millis();
+  FileStatSlim fileStat;
+  char itemName[256];
+  uint16_t nameLen;
+
+  // Pass 1: count entries per bucket
+  std::vector<uint16_t> fanout(256, 0);
+  size_t entryCount = 0;
+  Storage.seek(file, zipDetails.centralDirOffset);
+  while (readCentralDirEntry(&fileStat, itemName, &nameLen)) {
+    if (nameLen < 256) {
+      fanout[fnvHash64(itemName, nameLen) >> 56]++;
+      entryCount++;
+    }
+  }
+  if (entryCount > UINT16_MAX) {
+    LOG_ERR("ZIP", "Too many entries to index: %zu", entryCount);
+    if (!wasOpen) {
+      close();
+    }
+    return false;
+  }
+
+  // Built under a temporary name and sealed, so an interrupted build never sits where openIndex looks
+  const std::string tmpPath = indexPath + ".tmp";
+  FsFile out;
+  if (!Storage.openFileForWrite("ZIP", tmpPath, out)) {
+    if (!wasOpen) {
+      close();
+    }
+    return false;
+  }
+
+  ZipIndexHeader header = {};
+  Storage.write(out, &header, sizeof(header));
+  uint16_t cumulative = 0;
+  for (auto& count : fanout) {
+    cumulative += count;
+    count = cumulative;
+  }
+  Storage.write(out, fanout.data(), fanout.size() * sizeof(uint16_t));
+
+  // Later passes: gather a run of buckets that fits the batch, resolve data offsets, write it out sorted. A book
+  // with thousands of entries takes a few passes over the central directory instead of holding all of them.
+  std::vector<ZipIndexEntry> batch;
+  batch.reserve(std::min<size_t>(entryCount, ZIP_INDEX_ENTRIES_PER_PASS));
+  bool ok = true;
+  int firstBucket = 0;
+  while (ok && firstBucket < 256) {
+    const uint16_t batchStart = firstBucket == 0 ? 0 : fanout[firstBucket - 1];
+    int endBucket = firstBucket + 1;
+    while (endBucket < 256 && static_cast<size_t>(fanout[endBucket] - batchStart) <= ZIP_INDEX_ENTRIES_PER_PASS) {
+      endBucket++;
+    }
+    if (fanout[endBucket - 1] == batchStart) {
+      firstBucket = endBucket;
+      continue;
+    }
+
+    batch.clear();
+    Storage.seek(file, zipDetails.centralDirOffset);
+    while (readCentralDirEntry(&fileStat, itemName, &nameLen)) {
+      if (nameLen >= 256) {
+        continue;
+      }
+      const uint64_t hash = fnvHash64(itemName, nameLen);
+      const int bucket = static_cast<int>(hash >> 56);
+      if (bucket < firstBucket || bucket >= endBucket) {
+        continue;
+      }
+      batch.push_back({hash, fileStat.compressedSize, fileStat.uncompressedSize, fileStat.localHeaderOffset, 0,
+                       fileStat.method, nameLen});
+    }
+
+    // Local headers in file order, so the reads only move forward
+    std::sort(batch.begin(), batch.end(), [](const ZipIndexEntry& a, const ZipIndexEntry& b) {
+      return a.localHeaderOffset < b.localHeaderOffset;
+    });
+    for (auto& entry : batch) {
+      fileStat = {};
+      fileStat.localHeaderOffset = entry.localHeaderOffset;
+      const long dataOffset = getDataOffset(fileStat);
+      if (dataOffset < 0) {
+        ok = false;
+        break;
+      }
+      entry.dataOffset = static_cast<uint32_t>(dataOffset);
+    }
+
+    std::sort(batch.begin(), batch.end(), [](const ZipIndexEntry& a, const ZipIndexEntry& b) {
+      return indexKeyLess(a.hash, a.nameLen, b.hash, b.nameLen);
+    });
+    const size_t bytes = batch.size() * sizeof(ZipIndexEntry);
+    if (Storage.write(out, batch.data(), bytes) != bytes) {
+      ok = false;
+    }
+    firstBucket = endBucket;
+  }
+
+  if (ok) {
+    header.magic = ZIP_INDEX_MAGIC;
+    header.version = ZIP_INDEX_VERSION;
+    header.zipSize = file.size();
+    header.zipModified = getModifiedStamp();
+    header.centralDirOffset = zipDetails.centralDirOffset;
+    header.entryCount = entryCount;
+    Storage.seek(out, 0);
+    ok = Storage.write(out, &header, sizeof(header)) == sizeof(header);
+  }
+  if (ok) {
+    // Header and fanout are still in memory, so sealing them reads nothing back
+    uint32_t crc = serialization::crc32(0, &header, sizeof(header));
+    crc = serialization::crc32(crc, fanout.data(), fanout.size() * sizeof(uint16_t));
+    ok = serialization::writeTrailer(out, crc);
+  }
+  Storage.close(out);
+
+  if (ok && Storage.replace(tmpPath.c_str(), indexPath.c_str())) {
+    LOG_DBG("ZIP", "Indexed %zu central directory entries in %lu ms", entryCount, millis() - start);
+  } else {
+    ok = false;
+    LOG_ERR("ZIP", "Failed to write central directory index");
+    Storage.remove(tmpPath.c_str());
+  }
+
+  if (!wasOpen) {
+    close();
+  } else {
+    indexChecked = false;
+  }
+  return ok;
+}
+
 uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const bool trailingNullByte) {
   const bool wasOpen = isOpen();
   if (!wasOpen && !open()) {
@@ -403,7 +770,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
     return nullptr;
   }
 
-  file.seek(fileOffset);
+  Storage.seek(file, fileOffset);
 
   const auto deflatedDataSize = fileStat.compressedSize;
   const auto inflatedDataSize = fileStat.uncompressedSize;
@@ -419,7 +786,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
 
   if (fileStat.method == ZIP_METHOD_STORED) {
     // no deflation, just read content
-    const size_t dataRead = file.read(data, inflatedDataSize);
+    const size_t dataRead = Storage.read(file, data, inflatedDataSize);
     if (!wasOpen) {
       close();
     }
@@ -442,7 +809,7 @@ uint8_t* ZipFile::readFileToMemory(const char* filename, size_t* size, const boo
       return nullptr;
     }
 
-    const size_t dataRead = file.read(deflatedData, deflatedDataSize);
+    const size_t dataRead = Storage.read(file, deflatedData, deflatedDataSize);
     if (!wasOpen) {
       close();
     }
@@ -499,7 +866,7 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
     return false;
   }
 
-  file.seek(fileOffset);
+  Storage.seek(file, fileOffset);
   const auto deflatedDataSize = fileStat.compressedSize;
   const auto inflatedDataSize = fileStat.uncompressedSize;
 
@@ -516,7 +883,7 @@ bool ZipFile::readFileToStream(const char* filename, Print& out, const size_t ch
 
     size_t remaining = inflatedDataSize;
     while (remaining > 0) {
-      const size_t dataRead = file.read(buffer, remaining < chunkSize ? remaining : chunkSize);
+      const size_t dataRead = Storage.read(file, buffer, remaining < chunkSize ? remaining : chunkSize);
       if (dataRead == 0) {
         LOG_ERR("ZIP", "Could not read more bytes");
         free(buffer);
@@ -12,6 +12,7 @@ class ZipFile {
     uint32_t compressedSize;     // Compressed size
     uint32_t uncompressedSize;   // Uncompressed size
     uint32_t localHeaderOffset;  // Offset of local file header
+    uint32_t dataOffset;         // Offset of file data, 0 until the local header has been read
   };
 
   struct ZipDetails {
@@ -40,6 +41,11 @@ class ZipFile {
  private:
   const std::string& filePath;
   FsFile file;
+  // Central directory index in the book's cache dir, see buildIndex()
+  std::string indexPath;
+  FsFile indexFile;
+  uint16_t indexEntryCount = 0;
+  bool indexChecked = false;
   ZipDetails zipDetails = {0, 0, false};
   std::unordered_map<std::string, FileStatSlim> fileStatSlimCache;
 
@@ -50,9 +56,15 @@ class ZipFile {
   bool loadFileStatSlim(const char* filename, FileStatSlim* fileStat);
   long getDataOffset(const FileStatSlim& fileStat);
   bool loadZipDetails();
+  bool readCentralDirEntry(FileStatSlim* fileStat, char* name, uint16_t* nameLen);
+  uint32_t getModifiedStamp();
+  bool openIndex();
+  bool findInIndex(const char* filename, FileStatSlim* fileStat);
+  int fillUncompressedSizesFromIndex(const std::vector<SizeTarget>& targets, std::vector<uint32_t>& sizes);
 
  public:
-  explicit ZipFile(const std::string& filePath) : filePath(filePath) {}
+  explicit ZipFile(const std::string& filePath, std::string indexPath = "")
+      : filePath(filePath), indexPath(std::move(indexPath)) {}
   ~ZipFile() = default;
   // Zip file can be opened and closed by hand in order to allow for quick calculation of inflated file size
   // It is NOT recommended to pre-open it for any kind of inflation due to memory constraints
@@ -60,6 +72,13 @@ class ZipFile {
   bool open();
   bool close();
   bool loadAllFileStatSlims();
+  // Writes an index of the central directory to indexPath: entries sorted by (fnvHash64 of the name, name length)
+  // behind a 256-way fanout on the top hash byte, with sizes, method and data offset. Lookups then read one small
+  // bucket of it instead of scanning the central directory. The index records the zip's size and modify time and is
+  // ignored once they no longer match, or once its header and fanout fail the trailer CRC. Names that collide on
+  // both hash and length can't be told apart, the same trade-off fillUncompressedSizes makes. Returns true if a valid
+  // index exists afterwards.
+  bool buildIndex();
   bool getInflatedFileSize(const char* filename, size_t* size);
   // Batch lookup: scan ZIP central dir once and fill sizes for matching targets.
   // targets must be sorted by (hash, len). sizes[target.index] receives uncompressedSize.
@@ -1,5 +1,9 @@
 #include <HalDisplay.h>
 #include <HalGPIO.h>
+#include <Logging.h>
+
+#include <algorithm>
+#include <iterator>
 
 #define SD_SPI_MISO 7
 
@@ -7,17 +11,66 @@ HalDisplay::HalDisplay() : einkDisplay(EPD_SCLK, EPD_MOSI, EPD_CS, EPD_DC, EPD_R
 
 HalDisplay::~HalDisplay() {}
 
-void HalDisplay::begin() { einkDisplay.begin(); }
+namespace {
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261u;
+constexpr uint32_t FNV_PRIME = 16777619u;
+}  // namespace
+
+void HalDisplay::begin() {
+  einkDisplay.begin();
+  shownFrameKnown = false;
+  refreshScheduler.invalidate();
+
+  if (!refreshTask) {
+    refreshDone = xSemaphoreCreateBinary();
+    xTaskCreate(&refreshTaskTrampoline, "DisplayRefresh",
+                4096,         // Stack size
+                this,         // Parameters
+                1,            // Priority, same as the render tasks so they share the CPU while the panel is busy
+                &refreshTask  // Task handle
+    );
+    if (!refreshDone || !refreshTask) {
+      LOG_ERR("DSP", "Could not start refresh task, refreshes will block");
+    }
+  }
+}
+
+void HalDisplay::refreshTaskTrampoline(void* param) { static_cast<HalDisplay*>(param)->refreshTaskLoop(); }
+
+void HalDisplay::refreshTaskLoop() {
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    runRefresh(queuedJob);
+    xSemaphoreGive(refreshDone);
+  }
+}
+
+bool HalDisplay::isRefreshBusy() const { return refreshQueued && uxSemaphoreGetCount(refreshDone) == 0; }
+
+uint32_t HalDisplay::waitForRefresh() const {
+  if (!refreshQueued) {
+    return 0;
+  }
+  const unsigned long start = millis();
+  xSemaphoreTake(refreshDone, portMAX_DELAY);
+  refreshQueued = false;
+  return millis() - start;
+}
 
-void HalDisplay::clearScreen(uint8_t color) const { einkDisplay.clearScreen(color); }
+void HalDisplay::clearScreen(uint8_t color) const {
+  waitForRefresh();
+  einkDisplay.clearScreen(color);
+}
 
 void HalDisplay::drawImage(const uint8_t* imageData, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                            bool fromProgmem) const {
+  waitForRefresh();
   einkDisplay.drawImage(imageData, x, y, w, h, fromProgmem);
 }
 
 void HalDisplay::drawImageTransparent(const uint8_t* imageData, uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                                       bool fromProgmem) const {
+  waitForRefresh();
   einkDisplay.drawImageTransparent(imageData, x, y, w, h, fromProgmem);
 }
 
@@ -33,26 +86,242 @@ EInkDisplay::RefreshMode convertRefreshMode(HalDisplay::RefreshMode mode) {
   }
 }
 
+RefreshScheduler::Mode schedulerMode(HalDisplay::RefreshMode mode) {
+  switch (mode) {
+    case HalDisplay::FULL_REFRESH:
+      return RefreshScheduler::FULL;
+    case HalDisplay::HALF_REFRESH:
+      return RefreshScheduler::HALF;
+    case HalDisplay::FAST_REFRESH:
+    default:
+      return RefreshScheduler::FAST;
+  }
+}
+
+void HalDisplay::submitRefresh(const RefreshJob& job, const bool wait) {
+  waitForRefresh();
+  if (wait || !refreshTask || !refreshDone) {
+    runRefresh(job);
+    return;
+  }
+  queuedJob = job;
+  refreshQueued = true;
+  xTaskNotifyGive(refreshTask);
+}
+
+void HalDisplay::runRefresh(const RefreshJob& job) {
+  const unsigned long start = millis();
+  if (job.kind == RefreshJob::BUFFER) {
+    einkDisplay.displayBuffer(convertRefreshMode(job.mode), job.turnOffScreen);
+    lastRefresh = {BUFFER_SIZE, 0, static_cast<uint32_t>(start), 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT};
+  } else {
+    einkDisplay.displayWindow(job.x, job.y, job.w, job.h, job.turnOffScreen);
+    lastRefresh = {static_cast<uint32_t>(job.w / 8) * job.h, 0, static_cast<uint32_t>(start), job.x, job.y, job.w,
+                   job.h};
+  }
+  lastRefresh.timeMs = millis() - start;
+  if (!job.signaturesCurrent) {
+    if (job.kind == RefreshJob::BUFFER) {
+      updateShownFrame();
+    } else {
+      updateShownWindow(job);
+    }
+  }
+  refreshScheduler.record(einkDisplay.getFrameBuffer(),
+                          job.kind == RefreshJob::BUFFER ? schedulerMode(job.mode) : RefreshScheduler::FAST);
+}
+
 void HalDisplay::displayBuffer(HalDisplay::RefreshMode mode, bool turnOffScreen) {
-  einkDisplay.displayBuffer(convertRefreshMode(mode), turnOffScreen);
+  RefreshJob job;
+  job.mode = mode;
+  job.turnOffScreen = turnOffScreen;
+  submitRefresh(job, true);
+}
+
+void HalDisplay::displayWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool turnOffScreen) {
+  if (x >= DISPLAY_WIDTH || y >= DISPLAY_HEIGHT || w == 0 || h == 0) {
+    return;
+  }
+  // The controller RAM is addressed in whole bytes along a row
+  const uint16_t right = std::min<uint16_t>(DISPLAY_WIDTH, (x + w + 7) & ~7);
+  x &= ~7;
+  w = right - x;
+  h = std::min<uint16_t>(h, DISPLAY_HEIGHT - y);
+
+  RefreshJob job;
+  job.kind = RefreshJob::WINDOW;
+  job.turnOffScreen = turnOffScreen;
+  job.x = x;
+  job.y = y;
+  job.w = w;
+  job.h = h;
+  submitRefresh(job, true);
+}
+
+void HalDisplay::displayChanges(HalDisplay::RefreshMode mode, bool turnOffScreen) {
+  displayChanges(mode, turnOffScreen, true);
+}
+
+void HalDisplay::displayChanges(HalDisplay::RefreshMode mode, bool turnOffScreen, const bool wait) {
+  // The signatures below describe the frame on the panel, so a queued refresh has to land first
+  waitForRefresh();
+  const uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  uint32_t columnHash[DISPLAY_WIDTH_BYTES];
+  std::fill(std::begin(columnHash), std::end(columnHash), FNV_OFFSET_BASIS);
+
+  // One pass over the framebuffer: refresh the row signatures in place and rebuild the column signatures
+  int firstRow = -1;
+  int lastRow = -1;
+  for (uint16_t row = 0; row < DISPLAY_HEIGHT; row++) {
+    const uint8_t* line = frameBuffer + row * DISPLAY_WIDTH_BYTES;
+    uint32_t rowHash = FNV_OFFSET_BASIS;
+    for (uint16_t col = 0; col < DISPLAY_WIDTH_BYTES; col++) {
+      rowHash = (rowHash ^ line[col]) * FNV_PRIME;
+      columnHash[col] = (columnHash[col] ^ line[col]) * FNV_PRIME;
+    }
+    if (rowHash != shownRowHash[row]) {
+      if (firstRow < 0) firstRow = row;
+      lastRow = row;
+      shownRowHash[row] = rowHash;
+    }
+  }
+  int firstCol = -1;
+  int lastCol = -1;
+  for (uint16_t col = 0; col < DISPLAY_WIDTH_BYTES; col++) {
+    if (columnHash[col] != shownColumnHash[col]) {
+      if (firstCol < 0) firstCol = col;
+      lastCol = col;
+      shownColumnHash[col] = columnHash[col];
+    }
+  }
+
+  RefreshJob job;
+  job.mode = mode;
+  job.turnOffScreen = turnOffScreen;
+  if (!shownFrameKnown) {
+    submitRefresh(job, wait);
+    return;
+  }
+  if (firstRow < 0 || firstCol < 0) {
+    lastRefresh = {};
+    LOG_DBG("DSP", "No changes, refresh skipped");
+    return;
+  }
+
+  const uint32_t windowBytes = static_cast<uint32_t>(lastCol - firstCol + 1) * (lastRow - firstRow + 1);
+  job.signaturesCurrent = true;
+  if (windowBytes * 2 <= BUFFER_SIZE) {
+    job.kind = RefreshJob::WINDOW;
+    job.x = firstCol * 8;
+    job.y = firstRow;
+    job.w = (lastCol - firstCol + 1) * 8;
+    job.h = lastRow - firstRow + 1;
+  }
+  submitRefresh(job, wait);
+}
+
+HalDisplay::RefreshMode HalDisplay::displayAdaptive(const int textPagesPerHalfRefresh, const bool turnOffScreen,
+                                                    const bool wait) {
+  waitForRefresh();
+  refreshScheduler.setTextPagesPerHalfRefresh(textPagesPerHalfRefresh);
+  const RefreshScheduler::Decision decision = refreshScheduler.choose(einkDisplay.getFrameBuffer());
+  const RefreshMode mode = decision.mode == RefreshScheduler::FULL   ? FULL_REFRESH
+                           : decision.mode == RefreshScheduler::HALF ? HALF_REFRESH
+                                                                     : FAST_REFRESH;
+  LOG_DBG("DSP", "Adaptive refresh: mode %d, %u tiles changed, peak ghosting %.1f pages", mode,
+          decision.changedTiles, decision.peakGhosting);
+  if (mode == FAST_REFRESH) {
+    displayChanges(mode, turnOffScreen, wait);
+  } else {
+    RefreshJob job;
+    job.mode = mode;
+    job.turnOffScreen = turnOffScreen;
+    submitRefresh(job, wait);
+  }
+  return mode;
+}
+
+void HalDisplay::updateShownFrame() {
+  const uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  std::fill(std::begin(shownColumnHash), std::end(shownColumnHash), FNV_OFFSET_BASIS);
+  for (uint16_t row = 0; row < DISPLAY_HEIGHT; row++) {
+    const uint8_t* line = frameBuffer + row * DISPLAY_WIDTH_BYTES;
+    uint32_t rowHash = FNV_OFFSET_BASIS;
+    for (uint16_t col = 0; col < DISPLAY_WIDTH_BYTES; col++) {
+      rowHash = (rowHash ^ line[col]) * FNV_PRIME;
+      shownColumnHash[col] = (shownColumnHash[col] ^ line[col]) * FNV_PRIME;
+    }
+    shownRowHash[row] = rowHash;
+  }
+  shownFrameKnown = true;
+}
+
+void HalDisplay::updateShownWindow(const RefreshJob& job) {
+  if (!shownFrameKnown) {
+    return;
+  }
+  // Outside the window the panel still shows the previous frame, so a row or column the window only partly covers
+  // now matches neither frame. Those get a signature that differs from the current one and are sent again by the
+  // next displayChanges; rows and columns the window covers end to end are known exactly.
+  const uint8_t* frameBuffer = einkDisplay.getFrameBuffer();
+  const uint16_t firstCol = job.x / 8;
+  const uint16_t lastCol = (job.x + job.w) / 8;
+  const bool fullRows = job.w == DISPLAY_WIDTH;
+  const bool fullColumns = job.h == DISPLAY_HEIGHT;
+  for (uint16_t row = job.y; row < job.y + job.h; row++) {
+    const uint8_t* line = frameBuffer + row * DISPLAY_WIDTH_BYTES;
+    uint32_t rowHash = FNV_OFFSET_BASIS;
+    for (uint16_t col = 0; col < DISPLAY_WIDTH_BYTES; col++) {
+      rowHash = (rowHash ^ line[col]) * FNV_PRIME;
+    }
+    shownRowHash[row] = fullRows ? rowHash : rowHash ^ 1;
+  }
+  for (uint16_t col = firstCol; col < lastCol; col++) {
+    uint32_t columnHash = FNV_OFFSET_BASIS;
+    for (uint16_t row = 0; row < DISPLAY_HEIGHT; row++) {
+      columnHash = (columnHash ^ frameBuffer[row * DISPLAY_WIDTH_BYTES + col]) * FNV_PRIME;
+    }
+    shownColumnHash[col] = fullColumns ? columnHash : columnHash ^ 1;
+  }
 }
 
 void HalDisplay::refreshDisplay(HalDisplay::RefreshMode mode, bool turnOffScreen) {
+  waitForRefresh();
   einkDisplay.refreshDisplay(convertRefreshMode(mode), turnOffScreen);
 }
 
-void HalDisplay::deepSleep() { einkDisplay.deepSleep(); }
+void HalDisplay::deepSleep() {
+  waitForRefresh();
+  einkDisplay.deepSleep();
+  shownFrameKnown = false;
+  refreshScheduler.invalidate();
+}
 
 uint8_t* HalDisplay::getFrameBuffer() const { return einkDisplay.getFrameBuffer(); }
 
 void HalDisplay::copyGrayscaleBuffers(const uint8_t* lsbBuffer, const uint8_t* msbBuffer) {
+  waitForRefresh();
   einkDisplay.copyGrayscaleBuffers(lsbBuffer, msbBuffer);
 }
 
-void HalDisplay::copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer) { einkDisplay.copyGrayscaleLsbBuffers(lsbBuffer); }
+void HalDisplay::copyGrayscaleLsbBuffers(const uint8_t* lsbBuffer) {
+  waitForRefresh();
+  einkDisplay.copyGrayscaleLsbBuffers(lsbBuffer);
+}
 
-void HalDisplay::copyGrayscaleMsbBuffers(const uint8_t* msbBuffer) { einkDisplay.copyGrayscaleMsbBuffers(msbBuffer); }
+void HalDisplay::copyGrayscaleMsbBuffers(const uint8_t* msbBuffer) {
+  waitForRefresh();
+  einkDisplay.copyGrayscaleMsbBuffers(msbBuffer);
+}
 
-void HalDisplay::cleanupGrayscaleBuffers(const uint8_t* bwBuffer) { einkDisplay.cleanupGrayscaleBuffers(bwBuffer); }
+void HalDisplay::cleanupGrayscaleBuffers(const uint8_t* bwBuffer) {
+  waitForRefresh();
+  einkDisplay.cleanupGrayscaleBuffers(bwBuffer);
+}
 
-void HalDisplay::displayGrayBuffer(bool turnOffScreen) { einkDisplay.displayGrayBuffer(turnOffScreen); }
+void HalDisplay::displayGrayBuffer(bool turnOffScreen) {
+  waitForRefresh();
+  einkDisplay.displayGrayBuffer(turnOffScreen);
+  // The panel now shows grayscale content that no BW frame describes
+  shownFrameKnown = false;
+}
@@ -1,6 +1,11 @@
 #pragma once
 #include <Arduino.h>
 #include <EInkDisplay.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "RefreshScheduler.h"
 
 class HalDisplay {
  public:
@@ -36,6 +41,40 @@ class HalDisplay {
   void displayBuffer(RefreshMode mode = RefreshMode::FAST_REFRESH, bool turnOffScreen = false);
   void refreshDisplay(RefreshMode mode = RefreshMode::FAST_REFRESH, bool turnOffScreen = false);
 
+  // Windowed update: send and refresh only a rectangle of the framebuffer. Coordinates are physical panel pixels;
+  // x and w are widened to whole bytes.
+  void displayWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool turnOffScreen = false);
+  // Refresh only the rectangle that changed since the last frame sent to the panel. Skips the refresh if nothing
+  // changed, and falls back to displayBuffer(mode) when the change is large or the panel contents are unknown.
+  void displayChanges(RefreshMode mode = RefreshMode::FAST_REFRESH, bool turnOffScreen = false);
+
+  // Let the refresh scheduler pick the waveform from how much the frame changed and the ghosting accumulated so
+  // far (see RefreshScheduler). Fast refreshes go through displayChanges. Returns the mode that was used.
+  // With `wait` false the refresh runs on the display refresh task and this returns as soon as it is queued (see
+  // waitForRefresh).
+  RefreshMode displayAdaptive(int textPagesPerHalfRefresh, bool turnOffScreen = false, bool wait = true);
+  // Make the next displayAdaptive a half refresh
+  void requestHalfRefresh() { refreshScheduler.invalidate(); }
+
+  // Asynchronous refresh. While a refresh queued with wait=false is running, the framebuffer is being read by the
+  // refresh task: callers may read it but must not write to it, and storage access is only safe because both the
+  // SD card and the panel driver take the SPI bus per transaction. Every other HalDisplay call waits first, so
+  // the usual pattern is: queue the page, do the next page's non-drawing work, then waitForRefresh().
+  bool isRefreshBusy() const;
+  // Block until the queued refresh has finished. Returns how long the caller was blocked, in ms.
+  uint32_t waitForRefresh() const;
+
+  struct RefreshStats {
+    uint32_t bytes = 0;    // Framebuffer bytes sent to the controller
+    uint32_t timeMs = 0;   // Transfer plus refresh
+    uint32_t startMs = 0;  // millis() when the transfer started
+    uint16_t x = 0;        // Physical region that was sent
+    uint16_t y = 0;
+    uint16_t width = 0;
+    uint16_t height = 0;
+  };
+  const RefreshStats& getLastRefreshStats() const { return lastRefresh; }
+
   // Power management
   void deepSleep();
 
@@ -51,4 +90,41 @@ class HalDisplay {
 
  private:
   EInkDisplay einkDisplay;
+
+  // Signatures of the frame last sent to the panel: one hash per physical row and one per byte column. Comparing
+  // them with the framebuffer finds the changed rectangle for displayChanges without keeping a second 48KB copy.
+  uint32_t shownRowHash[DISPLAY_HEIGHT] = {};
+  uint32_t shownColumnHash[DISPLAY_WIDTH_BYTES] = {};
+  bool shownFrameKnown = false;
+  RefreshStats lastRefresh;
+  RefreshScheduler refreshScheduler;
+
+  struct RefreshJob {
+    enum Kind : uint8_t { BUFFER, WINDOW };
+    Kind kind = BUFFER;
+    RefreshMode mode = FAST_REFRESH;
+    bool turnOffScreen = false;
+    bool signaturesCurrent = false;  // displayChanges already updated the shown-frame signatures
+    uint16_t x = 0;
+    uint16_t y = 0;
+    uint16_t w = DISPLAY_WIDTH;
+    uint16_t h = DISPLAY_HEIGHT;
+  };
+  TaskHandle_t refreshTask = nullptr;
+  SemaphoreHandle_t refreshDone = nullptr;
+  RefreshJob queuedJob;
+  mutable bool refreshQueued = false;  // Only touched by the caller's task
+
+  static void refreshTaskTrampoline(void* param);
+  [[noreturn]] void refreshTaskLoop();
+  void submitRefresh(const RefreshJob& job, bool wait);
+  void runRefresh(const RefreshJob& job);
+  void displayChanges(RefreshMode mode, bool turnOffScreen, bool wait);
+  void updateShownFrame();
+  void updateShownWindow(const RefreshJob& job);
 };
+
+// The scheduler is kept free of the driver for the host simulation, so its panel size is spelled out there
+static_assert(RefreshScheduler::PANEL_WIDTH_BYTES == HalDisplay::DISPLAY_WIDTH_BYTES &&
+                  RefreshScheduler::PANEL_HEIGHT == HalDisplay::DISPLAY_HEIGHT,
+              "RefreshScheduler panel size must match the display");
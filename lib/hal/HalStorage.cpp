@@ -1,9 +1,25 @@
 #include "HalStorage.h"
 
+#include <Logging.h>
 #include <SDCardManager.h>
 
+#include "StorageStats.h"
+
 #define SDCard SDCardManager::getInstance()
 
+namespace {
+using Op = StorageStats::Op;
+
+// Runs `fn` and counts it as one `op`
+template <typename Fn>
+auto timed(const Op op, Fn&& fn) {
+  const uint32_t start = StorageStats::now();
+  auto result = fn();
+  StorageStats::record(op, start);
+  return result;
+}
+}  // namespace
+
 HalStorage HalStorage::instance;
 
 HalStorage::HalStorage() {}
@@ -14,34 +30,67 @@ bool HalStorage::ready() const { return SDCard.ready(); }
 
 std::vector<String> HalStorage::listFiles(const char* path, int maxFiles) { return SDCard.listFiles(path, maxFiles); }
 
-String HalStorage::readFile(const char* path) { return SDCard.readFile(path); }
+// Whole-file helpers count as one read or write of everything they moved
+String HalStorage::readFile(const char* path) {
+  const uint32_t start = StorageStats::now();
+  String content = SDCard.readFile(path);
+  StorageStats::record(Op::Read, start, content.length());
+  return content;
+}
 
 bool HalStorage::readFileToStream(const char* path, Print& out, size_t chunkSize) {
-  return SDCard.readFileToStream(path, out, chunkSize);
+  return timed(Op::Read, [&] { return SDCard.readFileToStream(path, out, chunkSize); });
 }
 
 size_t HalStorage::readFileToBuffer(const char* path, char* buffer, size_t bufferSize, size_t maxBytes) {
-  return SDCard.readFileToBuffer(path, buffer, bufferSize, maxBytes);
+  const uint32_t start = StorageStats::now();
+  const size_t n = SDCard.readFileToBuffer(path, buffer, bufferSize, maxBytes);
+  StorageStats::record(Op::Read, start, n);
+  return n;
 }
 
-bool HalStorage::writeFile(const char* path, const String& content) { return SDCard.writeFile(path, content); }
+bool HalStorage::writeFile(const char* path, const String& content) {
+  const uint32_t start = StorageStats::now();
+  const bool ok = SDCard.writeFile(path, content);
+  StorageStats::record(Op::Write, start, ok ? content.length() : 0);
+  return ok;
+}
 
-bool HalStorage::ensureDirectoryExists(const char* path) { return SDCard.ensureDirectoryExists(path); }
+bool HalStorage::ensureDirectoryExists(const char* path) {
+  return timed(Op::Mkdir, [&] { return SDCard.ensureDirectoryExists(path); });
+}
 
-FsFile HalStorage::open(const char* path, const oflag_t oflag) { return SDCard.open(path, oflag); }
+FsFile HalStorage::open(const char* path, const oflag_t oflag) {
+  return timed(Op::Open, [&] { return SDCard.open(path, oflag); });
+}
 
-bool HalStorage::mkdir(const char* path, const bool pFlag) { return SDCard.mkdir(path, pFlag); }
+bool HalStorage::mkdir(const char* path, const bool pFlag) {
+  return timed(Op::Mkdir, [&] { return SDCard.mkdir(path, pFlag); });
+}
 
-bool HalStorage::exists(const char* path) { return SDCard.exists(path); }
+bool HalStorage::exists(const char* path) {
+  return timed(Op::Exists, [&] { return SDCard.exists(path); });
+}
 
-bool HalStorage::remove(const char* path) { return SDCard.remove(path); }
+bool HalStorage::remove(const char* path) {
+  return timed(Op::Remove, [&] { return SDCard.remove(path); });
+}
 
 bool HalStorage::rename(const char* oldPath, const char* newPath) { return SDCard.rename(oldPath, newPath); }
 
-bool HalStorage::rmdir(const char* path) { return SDCard.rmdir(path); }
+bool HalStorage::replace(const char* tmpPath, const char* path) {
+  if (exists(path) && !remove(path)) {
+    return false;
+  }
+  return rename(tmpPath, path);
+}
+
+bool HalStorage::rmdir(const char* path) {
+  return timed(Op::Remove, [&] { return SDCard.rmdir(path); });
+}
 
 bool HalStorage::openFileForRead(const char* moduleName, const char* path, FsFile& file) {
-  return SDCard.openFileForRead(moduleName, path, file);
+  return timed(Op::Open, [&] { return SDCard.openFileForRead(moduleName, path, file); });
 }
 
 bool HalStorage::openFileForRead(const char* moduleName, const std::string& path, FsFile& file) {
@@ -52,8 +101,14 @@ bool HalStorage::openFileForRead(const char* moduleName, const String& path, FsF
   return openFileForRead(moduleName, path.c_str(), file);
 }
 
+// Opened here rather than through SDCard.openFileForWrite so the mode is ours to guarantee
 bool HalStorage::openFileForWrite(const char* moduleName, const char* path, FsFile& file) {
-  return SDCard.openFileForWrite(moduleName, path, file);
+  file = open(path, O_RDWR | O_CREAT | O_TRUNC);
+  if (!file) {
+    LOG_ERR(moduleName, "Failed to open %s for writing", path);
+    return false;
+  }
+  return true;
 }
 
 bool HalStorage::openFileForWrite(const char* moduleName, const std::string& path, FsFile& file) {
@@ -64,4 +119,32 @@ bool HalStorage::openFileForWrite(const char* moduleName, const String& path, Fs
   return openFileForWrite(moduleName, path.c_str(), file);
 }
 
-bool HalStorage::removeDir(const char* path) { return SDCard.removeDir(path); }
\ No newline at end of file
+bool HalStorage::removeDir(const char* path) {
+  return timed(Op::Remove, [&] { return SDCard.removeDir(path); });
+}
+
+int HalStorage::read(FsFile& file, void* buffer, const size_t count) {
+  const uint32_t start = StorageStats::now();
+  const int n = file.read(buffer, count);
+  StorageStats::record(Op::Read, start, n > 0 ? n : 0);
+  return n;
+}
+
+size_t HalStorage::write(FsFile& file, const void* buffer, const size_t count) {
+  const uint32_t start = StorageStats::now();
+  const size_t n = file.write(static_cast<const uint8_t*>(buffer), count);
+  StorageStats::record(Op::Write, start, n);
+  return n;
+}
+
+bool HalStorage::seek(FsFile& file, const uint64_t position) {
+  return timed(Op::Seek, [&] { return file.seek(position); });
+}
+
+bool HalStorage::close(FsFile& file) {
+  return timed(Op::Close, [&] { return file.close(); });
+}
+
+bool HalStorage::preAllocate(FsFile& file, const uint64_t size) { return size > 0 && file.preAllocate(size); }
+
+bool HalStorage::truncate(FsFile& file, const uint64_t size) { return file.truncate(size); }
\ No newline at end of file
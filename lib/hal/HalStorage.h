@@ -29,16 +29,33 @@ class HalStorage {
   bool exists(const char* path);
   bool remove(const char* path);
   bool rename(const char* oldPath, const char* newPath);
+  // Moves a finished file from `tmpPath` to `path`, replacing what is there. FAT can't rename over a file, so the old
+  // one is removed first: a reset in between leaves no file at `path`, never a partly written one.
+  bool replace(const char* tmpPath, const char* path);
   bool rmdir(const char* path);
 
   bool openFileForRead(const char* moduleName, const char* path, FsFile& file);
   bool openFileForRead(const char* moduleName, const std::string& path, FsFile& file);
   bool openFileForRead(const char* moduleName, const String& path, FsFile& file);
+  // Read-write, created or truncated: sealed cache writers read what they wrote back through the same handle to
+  // compute the trailer CRC (serialization::crc32 on the file), which a write-only handle would fail.
   bool openFileForWrite(const char* moduleName, const char* path, FsFile& file);
   bool openFileForWrite(const char* moduleName, const std::string& path, FsFile& file);
   bool openFileForWrite(const char* moduleName, const String& path, FsFile& file);
   bool removeDir(const char* path);
 
+  // FsFile operations counted in StorageStats; same results as calling them on the file
+  int read(FsFile& file, void* buffer, size_t count);
+  size_t write(FsFile& file, const void* buffer, size_t count);
+  bool seek(FsFile& file, uint64_t position);
+  bool close(FsFile& file);
+
+  // Reserves `size` bytes of contiguous clusters for a new, still empty file, so one that grows through many small
+  // writes isn't allocated cluster by cluster wherever the card has holes. The file reads as `size` long until
+  // truncate() cuts it back to what was written. Fails, leaving the file as it was, when no free run is that long.
+  bool preAllocate(FsFile& file, uint64_t size);
+  bool truncate(FsFile& file, uint64_t size);
+
   static HalStorage& getInstance() { return instance; }
 
  private:
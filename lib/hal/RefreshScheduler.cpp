@@ -0,0 +1,85 @@
+#include "RefreshScheduler.h"
+
+#include <algorithm>
+
+namespace {
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261u;
+constexpr uint32_t FNV_PRIME = 16777619u;
+}  // namespace
+
+void RefreshScheduler::sample(const uint8_t* frameBuffer, TileSample* out) {
+  for (int t = 0; t < TILE_COUNT; t++) {
+    out[t] = {FNV_OFFSET_BASIS, 0};
+  }
+  for (int row = 0; row < PANEL_HEIGHT; row++) {
+    const uint8_t* line = frameBuffer + row * PANEL_WIDTH_BYTES;
+    TileSample* tileRow = out + (row / TILE_HEIGHT) * TILE_COLUMNS;
+    for (int tileCol = 0; tileCol < TILE_COLUMNS; tileCol++) {
+      TileSample& tile = tileRow[tileCol];
+      const uint8_t* bytes = line + tileCol * TILE_WIDTH_BYTES;
+      for (int i = 0; i < TILE_WIDTH_BYTES; i++) {
+        tile.hash = (tile.hash ^ bytes[i]) * FNV_PRIME;
+        tile.ink += __builtin_popcount(static_cast<uint8_t>(~bytes[i]));
+      }
+    }
+  }
+}
+
+float RefreshScheduler::addedGhosting(const TileState& tile, const TileSample& next) {
+  if (tile.hash == next.hash && tile.ink == next.ink) {
+    return 0;
+  }
+  // Without the previous frame we can't count flipped pixels, but they are bounded by the ink on either side
+  const float flipped = static_cast<float>(tile.ink + next.ink) / TILE_PIXELS;
+  return flipped / TEXT_PAGE_GHOSTING;
+}
+
+RefreshScheduler::Decision RefreshScheduler::choose(const uint8_t* frameBuffer) const {
+  TileSample next[TILE_COUNT];
+  sample(frameBuffer, next);
+
+  Decision decision;
+  float peakResidue = 0;
+  for (int t = 0; t < TILE_COUNT; t++) {
+    const float added = addedGhosting(tiles[t], next[t]);
+    if (added > 0) {
+      decision.changedTiles++;
+    }
+    const float projected = tiles[t].ghosting + added;
+    decision.peakGhosting = std::max(decision.peakGhosting, projected);
+    peakResidue = std::max(peakResidue, tiles[t].residue + projected * HALF_REFRESH_RESIDUE);
+  }
+
+  if (!known || decision.peakGhosting > halfRefreshLimit()) {
+    decision.mode = known && peakResidue > halfRefreshLimit() ? FULL : HALF;
+  }
+  return decision;
+}
+
+void RefreshScheduler::record(const uint8_t* frameBuffer, const Mode mode) {
+  TileSample next[TILE_COUNT];
+  sample(frameBuffer, next);
+
+  for (int t = 0; t < TILE_COUNT; t++) {
+    TileState& tile = tiles[t];
+    const float added = known ? addedGhosting(tile, next[t]) : 0;
+    switch (mode) {
+      case FAST:
+        tile.ghosting += added;
+        break;
+      case HALF:
+        tile.residue += (tile.ghosting + added) * HALF_REFRESH_RESIDUE;
+        tile.ghosting = 0;
+        break;
+      case FULL:
+        tile.residue = 0;
+        tile.ghosting = 0;
+        break;
+    }
+    tile.hash = next[t].hash;
+    tile.ink = next[t].ink;
+  }
+  known = known || mode != FAST;
+}
+
+void RefreshScheduler::invalidate() { known = false; }
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Picks the refresh waveform for each new frame from how much of the panel has actually changed.
+//
+// The panel is split into tiles. For each tile the scheduler remembers a signature and the ink (black pixel) count
+// of the frame last shown, plus a running ghosting estimate. A fast refresh adds ghosting to every tile it changes,
+// in proportion to how much ink was there before and after; a half refresh clears most of it but leaves a residue
+// that only a full refresh removes. The next frame gets the cheapest waveform that keeps every tile under the limits.
+//
+// Pure logic on a 1bpp framebuffer (bit cleared = black), so it can run in the host simulation as well.
+class RefreshScheduler {
+ public:
+  enum Mode : uint8_t { FAST, HALF, FULL };
+
+  // The panel's framebuffer layout (HalDisplay::DISPLAY_WIDTH_BYTES x DISPLAY_HEIGHT, checked there)
+  static constexpr int PANEL_WIDTH_BYTES = 100;  // 800px
+  static constexpr int PANEL_HEIGHT = 480;
+  static constexpr int TILE_WIDTH_BYTES = 10;
+  static constexpr int TILE_HEIGHT = 48;
+  static constexpr int TILE_COLUMNS = PANEL_WIDTH_BYTES / TILE_WIDTH_BYTES;
+  static constexpr int TILE_ROWS = PANEL_HEIGHT / TILE_HEIGHT;
+  static constexpr int TILE_COUNT = TILE_COLUMNS * TILE_ROWS;
+  static constexpr int TILE_PIXELS = TILE_WIDTH_BYTES * 8 * TILE_HEIGHT;
+  static_assert(PANEL_WIDTH_BYTES % TILE_WIDTH_BYTES == 0 && PANEL_HEIGHT % TILE_HEIGHT == 0,
+                "Tiles must cover the panel exactly");
+
+  // Ghosting a fast refresh adds to a tile when a typical page of text (about 12% ink) replaces another one.
+  // Limits are expressed in these units, so the "pages between refreshes" setting keeps its meaning for text.
+  static constexpr float TEXT_PAGE_GHOSTING = 0.24f;
+  // Share of the ghosting a half refresh leaves behind. A full refresh is due once that residue adds up to what
+  // triggers a half refresh, i.e. every 8 half refreshes while reading plain text.
+  static constexpr float HALF_REFRESH_RESIDUE = 0.125f;
+
+  struct Decision {
+    Mode mode = FAST;
+    uint8_t changedTiles = 0;  // Tiles whose content differs from the shown frame
+    float peakGhosting = 0;    // Worst projected tile, in text pages (see TEXT_PAGE_GHOSTING)
+  };
+
+  // Fast refreshes tolerated for a run of ordinary text pages before a half refresh
+  void setTextPagesPerHalfRefresh(int pages) { textPagesPerHalfRefresh = pages > 0 ? pages : 1; }
+
+  // Choose the refresh for `frameBuffer` without changing any state
+  Decision choose(const uint8_t* frameBuffer) const;
+  // Record that `frameBuffer` was sent to the panel with `mode`
+  void record(const uint8_t* frameBuffer, Mode mode);
+  // Forget the shown frame (power cycle, deep sleep, a reader opening a book): the next chosen refresh is a half
+  // refresh, which becomes the new baseline. Fast refreshes recorded before that only update the signatures.
+  void invalidate();
+
+ private:
+  struct TileState {
+    uint32_t hash = 0;
+    uint16_t ink = 0;
+    float ghosting = 0;  // Text pages since the last half or full refresh
+    float residue = 0;   // Left by half refreshes since the last full refresh, same unit
+  };
+  struct TileSample {
+    uint32_t hash;
+    uint16_t ink;
+  };
+
+  TileState tiles[TILE_COUNT];
+  bool known = false;
+  int textPagesPerHalfRefresh = 15;
+
+  static void sample(const uint8_t* frameBuffer, TileSample* out);
+  static float addedGhosting(const TileState& tile, const TileSample& next);
+  // Ghosting (in text pages) at which the next refresh has to be a half refresh
+  float halfRefreshLimit() const { return static_cast<float>(textPagesPerHalfRefresh) - 0.5f; }
+};
@@ -0,0 +1,94 @@
+#include "StorageStats.h"
+
+namespace {
+constexpr const char* TAG_NAMES[] = {"other", "reader", "section_build", "web_server", "thumbnails", "progress"};
+constexpr const char* OP_NAMES[] = {"open", "read", "write", "seek", "close", "exists", "remove", "mkdir"};
+static_assert(sizeof(TAG_NAMES) / sizeof(TAG_NAMES[0]) == StorageStats::TAG_COUNT, "Tag names out of date");
+static_assert(sizeof(OP_NAMES) / sizeof(OP_NAMES[0]) == StorageStats::OP_COUNT, "Op names out of date");
+
+#ifdef ENABLE_STORAGE_STATS
+thread_local StorageStats::Tag currentTag = StorageStats::Tag::Other;
+StorageStats::Counter counters[StorageStats::TAG_COUNT][StorageStats::OP_COUNT];
+uint32_t resetAtMillis = 0;
+#endif
+}  // namespace
+
+#ifdef ENABLE_STORAGE_STATS
+
+StorageStats::Scope::Scope(const Tag tag) : previous(currentTag) { currentTag = tag; }
+
+StorageStats::Scope::~Scope() { currentTag = previous; }
+
+void StorageStats::record(const Op op, const uint32_t startMicros, const uint32_t bytes) {
+  const uint32_t elapsed = micros() - startMicros;
+  Counter& c = counters[static_cast<int>(currentTag)][static_cast<int>(op)];
+  c.calls++;
+  c.bytes += bytes;
+  c.totalMicros += elapsed;
+  if (elapsed > c.maxMicros) {
+    c.maxMicros = elapsed;
+  }
+  int bucket = elapsed < bucketLimitMicros(0) ? 0 : 31 - __builtin_clz(elapsed) - 4;
+  if (bucket >= BUCKET_COUNT) {
+    bucket = BUCKET_COUNT - 1;
+  }
+  c.histogram[bucket]++;
+}
+
+void StorageStats::reset() {
+  for (auto& tag : counters) {
+    for (auto& c : tag) {
+      c = Counter{};
+    }
+  }
+  resetAtMillis = millis();
+}
+
+const StorageStats::Counter& StorageStats::get(const Tag tag, const Op op) {
+  return counters[static_cast<int>(tag)][static_cast<int>(op)];
+}
+
+uint32_t StorageStats::millisSinceReset() { return millis() - resetAtMillis; }
+
+#else
+
+StorageStats::Scope::Scope(const Tag tag) : previous(tag) {}
+
+StorageStats::Scope::~Scope() = default;
+
+const StorageStats::Counter& StorageStats::get(Tag, Op) {
+  static const Counter empty;
+  return empty;
+}
+
+uint32_t StorageStats::millisSinceReset() { return 0; }
+
+#endif
+
+const char* StorageStats::name(const Tag tag) { return TAG_NAMES[static_cast<int>(tag)]; }
+
+const char* StorageStats::name(const Op op) { return OP_NAMES[static_cast<int>(op)]; }
+
+void StorageStats::print(Print& out) {
+  if (!enabled) {
+    out.printf("IOSTATS disabled (build without ENABLE_STORAGE_STATS)\n");
+    return;
+  }
+  out.printf("IOSTATS over %lu ms; histogram buckets end at 32us, doubling, last is 32ms+\n",
+             static_cast<unsigned long>(millisSinceReset()));
+  for (int t = 0; t < TAG_COUNT; t++) {
+    for (int o = 0; o < OP_COUNT; o++) {
+      const Counter& c = get(static_cast<Tag>(t), static_cast<Op>(o));
+      if (c.calls == 0) {
+        continue;
+      }
+      out.printf("%-13s %-6s calls=%lu bytes=%lu avg=%luus max=%luus hist=", TAG_NAMES[t], OP_NAMES[o],
+                 static_cast<unsigned long>(c.calls), static_cast<unsigned long>(c.bytes),
+                 static_cast<unsigned long>(c.totalMicros / c.calls), static_cast<unsigned long>(c.maxMicros));
+      for (int b = 0; b < BUCKET_COUNT; b++) {
+        out.printf(b == 0 ? "%lu" : ",%lu", static_cast<unsigned long>(c.histogram[b]));
+      }
+      out.printf("\n");
+    }
+  }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// SD card accounting: call counts, bytes and log-scale latency histograms per operation, broken down by the part
+// of the firmware that asked for the I/O. Tells a slow page turn that waits on the card apart from one that spends
+// its time rendering.
+//
+// Operations on the storage HAL are counted; FsFile reads, writes, seeks and closes are counted where they go
+// through HalStorage (the buffered cache serialization and the ZIP reader do). The caller tag comes from the
+// innermost Scope on the calling task. Counters aren't atomic: two tasks hitting the card at the same instant can
+// lose a count, which is fine for diagnostics.
+//
+// Compiled in with ENABLE_STORAGE_STATS; without it every call here is empty and the counters take no RAM.
+class StorageStats {
+ public:
+  enum class Op : uint8_t { Open, Read, Write, Seek, Close, Exists, Remove, Mkdir, Count };
+  enum class Tag : uint8_t { Other, Reader, SectionBuild, WebServer, Thumbnails, Progress, Count };
+
+  static constexpr int OP_COUNT = static_cast<int>(Op::Count);
+  static constexpr int TAG_COUNT = static_cast<int>(Tag::Count);
+  // Bucket i counts operations that took less than (32 << i) us; the last one everything slower
+  static constexpr int BUCKET_COUNT = 12;
+
+  struct Counter {
+    uint32_t calls = 0;
+    uint32_t bytes = 0;
+    uint32_t totalMicros = 0;
+    uint32_t maxMicros = 0;
+    uint32_t histogram[BUCKET_COUNT] = {};
+  };
+
+  // Attributes storage calls made on this task to `tag` until it goes out of scope
+  class Scope {
+   public:
+    explicit Scope(Tag tag);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    Tag previous;
+  };
+
+#ifdef ENABLE_STORAGE_STATS
+  static constexpr bool enabled = true;
+
+  static uint32_t now() { return micros(); }
+  // Counts one `op` that started at `startMicros` (from now()) and moved `bytes`
+  static void record(Op op, uint32_t startMicros, uint32_t bytes = 0);
+  static void reset();
+#else
+  static constexpr bool enabled = false;
+
+  static uint32_t now() { return 0; }
+  static void record(Op, uint32_t, uint32_t = 0) {}
+  static void reset() {}
+#endif
+
+  static const Counter& get(Tag tag, Op op);
+  static uint32_t millisSinceReset();
+  static constexpr uint32_t bucketLimitMicros(const int bucket) { return 32u << bucket; }
+  static const char* name(Tag tag);
+  static const char* name(Op op);
+
+  // One line per tag and operation that saw any calls
+  static void print(Print& out);
+};
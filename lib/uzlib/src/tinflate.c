@@ -122,6 +122,40 @@ static void tinf_build_bits_base(unsigned char *bits, unsigned short *base, int
 }
 #endif
 
+/* fill the lookup table of a tree from its canonical code */
+static void tinf_build_fast_table(TINF_TREE *t)
+{
+   unsigned int len, i, j, idx = 0, code = 0;
+
+   if (!t->fast) return;
+
+   memset(t->fast, 0, sizeof(*t->fast) << UZLIB_CONF_FAST_BITS);
+
+   for (len = 1; len <= UZLIB_CONF_FAST_BITS; ++len)
+   {
+      for (i = 0; i < t->table[len]; ++i, ++idx, ++code)
+      {
+         unsigned int rev = 0, c = code;
+
+         /* over-subscribed lengths: leave the rest to the bitwise decoder */
+         if (code >= (1u << len)) return;
+
+         /* codes are sent MSB first, so the table is indexed by reversed code */
+         for (j = 0; j < len; ++j)
+         {
+            rev = (rev << 1) | (c & 1);
+            c >>= 1;
+         }
+
+         for (j = rev; j < (1u << UZLIB_CONF_FAST_BITS); j += 1u << len)
+         {
+            t->fast[j] = (unsigned short)(len << 9 | t->trans[idx]);
+         }
+      }
+      code <<= 1;
+   }
+}
+
 /* build the fixed huffman trees */
 static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
 {
@@ -145,6 +179,9 @@ static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
    dt->table[5] = 32;
 
    for (i = 0; i < 32; ++i) dt->trans[i] = i;
+
+   tinf_build_fast_table(lt);
+   tinf_build_fast_table(dt);
 }
 
 /* given an array of code lengths, build a tree */
@@ -184,6 +221,8 @@ static void tinf_build_tree(TINF_TREE *t, const unsigned char *lengths, unsigned
    {
       if (lengths[i]) t->trans[offs[lengths[i]]++] = i;
    }
+
+   tinf_build_fast_table(t);
 }
 
 /* ---------------------- *
@@ -216,12 +255,55 @@ unsigned char uzlib_get_byte(TINF_DATA *d)
     return 0;
 }
 
+/* make sure the tag holds at least num (<= 24) bits. Past the end of the
+   input zero bits are appended and counted in padbits, so looking ahead for
+   a table lookup can't fail a stream whose last code is short. */
+static void tinf_refill(TINF_DATA *d, unsigned int num)
+{
+   while (d->bitcount < num)
+   {
+      unsigned int byte;
+
+      if (d->source < d->source_limit) {
+         byte = *d->source++;
+      } else {
+         byte = uzlib_get_byte(d);
+         if (d->eof) d->padbits += 8;
+      }
+
+      d->tag |= byte << d->bitcount;
+      d->bitcount += 8;
+   }
+}
+
+/* skip to the next byte boundary of the input */
+static void tinf_align(TINF_DATA *d)
+{
+   d->tag >>= d->bitcount & 7;
+   d->bitcount &= ~7u;
+}
+
+/* get the next byte from a byte aligned stream; whole bytes already
+   read into the tag come first */
+static unsigned char tinf_get_aligned_byte(TINF_DATA *d)
+{
+   if (d->bitcount >= 8)
+   {
+      unsigned char c = d->tag & 0xff;
+      d->tag >>= 8;
+      d->bitcount -= 8;
+      return c;
+   }
+
+   return uzlib_get_byte(d);
+}
+
 uint32_t tinf_get_le_uint32(TINF_DATA *d)
 {
     uint32_t val = 0;
     int i;
     for (i = 4; i--;) {
-        val = val >> 8 | ((uint32_t)uzlib_get_byte(d)) << 24;
+        val = val >> 8 | ((uint32_t)tinf_get_aligned_byte(d)) << 24;
     }
     return val;
 }
@@ -231,7 +313,7 @@ uint32_t tinf_get_be_uint32(TINF_DATA *d)
     uint32_t val = 0;
     int i;
     for (i = 4; i--;) {
-        val = val << 8 | uzlib_get_byte(d);
+        val = val << 8 | tinf_get_aligned_byte(d);
     }
     return val;
 }
@@ -241,17 +323,12 @@ static int tinf_getbit(TINF_DATA *d)
 {
    unsigned int bit;
 
-   /* check if tag is empty */
-   if (!d->bitcount--)
-   {
-      /* load next tag */
-      d->tag = uzlib_get_byte(d);
-      d->bitcount = 7;
-   }
+   tinf_refill(d, 1);
 
    /* shift bit out of tag */
    bit = d->tag & 0x01;
    d->tag >>= 1;
+   d->bitcount--;
 
    return bit;
 }
@@ -261,14 +338,13 @@ static unsigned int tinf_read_bits(TINF_DATA *d, int num, int base)
 {
    unsigned int val = 0;
 
-   /* read num bits */
+   /* read num bits, first one into the lowest bit */
    if (num)
    {
-      unsigned int limit = 1 << (num);
-      unsigned int mask;
-
-      for (mask = 1; mask < limit; mask *= 2)
-         if (tinf_getbit(d)) val += mask;
+      tinf_refill(d, num);
+      val = d->tag & ((1u << num) - 1);
+      d->tag >>= num;
+      d->bitcount -= num;
    }
 
    return val + base;
@@ -279,6 +355,21 @@ static int tinf_decode_symbol(TINF_DATA *d, TINF_TREE *t)
 {
    int sum = 0, cur = 0, len = 0;
 
+   /* short codes come straight from the lookup table */
+   if (t->fast)
+   {
+      unsigned int entry;
+
+      tinf_refill(d, UZLIB_CONF_FAST_BITS);
+      entry = t->fast[d->tag & ((1u << UZLIB_CONF_FAST_BITS) - 1)];
+      if (entry)
+      {
+         d->tag >>= entry >> 9;
+         d->bitcount -= entry >> 9;
+         return entry & 0x1ff;
+      }
+   }
+
    /* get more bits while code value is above sum */
    do {
 
@@ -403,130 +494,212 @@ static int tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
  * -- block inflate functions -- *
  * ----------------------------- */
 
-/* given a stream and two trees, inflate next chunk of output (a byte or more) */
-static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
+/* copy as much of the current match as fits into dest */
+static void tinf_copy_match(TINF_DATA *d)
 {
-    if (d->curlen == 0) {
-        unsigned int offs;
-        int dist;
-        int sym = tinf_decode_symbol(d, lt);
-        //printf("huff sym: %02x\n", sym);
+    unsigned int n = d->curlen, space = d->dest_limit - d->dest;
 
-        if (d->eof) {
-            return TINF_DATA_ERROR;
-        }
+    if (n > space) {
+        n = space;
+    }
+    d->curlen -= n;
 
-        /* literal byte */
-        if (sym < 256) {
-            TINF_PUT(d, sym);
-            return TINF_OK;
-        }
+    if (d->dict_ring) {
+        /* distance back from the write position; 0 stands for dict_size */
+        unsigned int offs = d->dict_idx >= (unsigned)d->lzOff ? d->dict_idx - d->lzOff
+                                                                : d->dict_idx + d->dict_size - d->lzOff;
+
+        while (n) {
+            unsigned int chunk = n, i;
+
+            /* neither the read nor the write position may wrap in a chunk */
+            if (chunk > d->dict_size - d->lzOff) chunk = d->dict_size - d->lzOff;
+            if (chunk > d->dict_size - d->dict_idx) chunk = d->dict_size - d->dict_idx;
+
+            if (chunk >= 8 && (offs == 0 || offs >= chunk)) {
+                /* long match that doesn't overlap its own output */
+                memcpy(d->dest, d->dict_ring + d->lzOff, chunk);
+                memcpy(d->dict_ring + d->dict_idx, d->dest, chunk);
+            } else {
+                for (i = 0; i < chunk; ++i) {
+                    unsigned char c = d->dict_ring[d->lzOff + i];
+                    d->dest[i] = c;
+                    d->dict_ring[d->dict_idx + i] = c;
+                }
+            }
 
-        /* end of block */
-        if (sym == 256) {
-            return TINF_DONE;
+            d->dest += chunk;
+            d->lzOff += chunk;
+            if ((unsigned)d->lzOff == d->dict_size) d->lzOff = 0;
+            d->dict_idx += chunk;
+            if (d->dict_idx == d->dict_size) d->dict_idx = 0;
+            n -= chunk;
         }
+    } else {
+        const unsigned char *src = d->dest + d->lzOff;
 
-        /* substring from sliding dictionary */
-        sym -= 257;
-        if (sym >= 29) {
-            return TINF_DATA_ERROR;
+        if (n >= 8 && (unsigned)-d->lzOff >= n) {
+            memcpy(d->dest, src, n);
+        } else {
+            unsigned int i;
+            for (i = 0; i < n; ++i) {
+                d->dest[i] = src[i];
+            }
         }
+        d->dest += n;
+    }
+}
 
-        /* possibly get more bits from length code */
-        d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
+/* given a stream and two trees, inflate output until dest is full or the
+   block ends */
+static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
+{
+    while (d->dest < d->dest_limit) {
+        if (d->curlen == 0) {
+            unsigned int offs;
+            int dist;
+            int sym = tinf_decode_symbol(d, lt);
+            //printf("huff sym: %02x\n", sym);
+
+            /* error decoding, or the code ran past the end of the input */
+            if (sym < 0 || d->bitcount < d->padbits) {
+                return TINF_DATA_ERROR;
+            }
 
-        dist = tinf_decode_symbol(d, dt);
-        if (dist >= 30) {
-            return TINF_DATA_ERROR;
-        }
+            /* literal byte */
+            if (sym < 256) {
+                TINF_PUT(d, sym);
+                continue;
+            }
 
-        /* possibly get more bits from distance code */
-        offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
+            /* end of block */
+            if (sym == 256) {
+                return TINF_DONE;
+            }
 
-        /* calculate and validate actual LZ offset to use */
-        if (d->dict_ring) {
-            if (offs > d->dict_size) {
-                return TINF_DICT_ERROR;
+            /* substring from sliding dictionary */
+            sym -= 257;
+            if (sym >= 29) {
+                return TINF_DATA_ERROR;
             }
-            /* Note: unlike full-dest-in-memory case below, we don't
-               try to catch offset which points to not yet filled
-               part of the dictionary here. Doing so would require
-               keeping another variable to track "filled in" size
-               of the dictionary. Appearance of such an offset cannot
-               lead to accessing memory outside of the dictionary
-               buffer, and clients which don't want to leak unrelated
-               information, should explicitly initialize dictionary
-               buffer passed to uzlib. */
-
-            d->lzOff = d->dict_idx - offs;
-            if (d->lzOff < 0) {
-                d->lzOff += d->dict_size;
+
+            /* possibly get more bits from length code */
+            d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
+
+            dist = tinf_decode_symbol(d, dt);
+            if (dist < 0 || dist >= 30) {
+                return TINF_DATA_ERROR;
             }
-        } else {
-            /* catch trying to point before the start of dest buffer */
-            if (offs > (unsigned)(d->dest - d->destStart)) {
+
+            /* possibly get more bits from distance code */
+            offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
+            if (d->bitcount < d->padbits) {
                 return TINF_DATA_ERROR;
             }
-            d->lzOff = -offs;
+
+            /* calculate and validate actual LZ offset to use */
+            if (d->dict_ring) {
+                if (offs > d->dict_size) {
+                    return TINF_DICT_ERROR;
+                }
+                /* Note: unlike full-dest-in-memory case below, we don't
+                   try to catch offset which points to not yet filled
+                   part of the dictionary here. Doing so would require
+                   keeping another variable to track "filled in" size
+                   of the dictionary. Appearance of such an offset cannot
+                   lead to accessing memory outside of the dictionary
+                   buffer, and clients which don't want to leak unrelated
+                   information, should explicitly initialize dictionary
+                   buffer passed to uzlib. */
+
+                d->lzOff = d->dict_idx - offs;
+                if (d->lzOff < 0) {
+                    d->lzOff += d->dict_size;
+                }
+            } else {
+                /* catch trying to point before the start of dest buffer */
+                if (offs > (unsigned)(d->dest - d->destStart)) {
+                    return TINF_DATA_ERROR;
+                }
+                d->lzOff = -offs;
+            }
         }
+
+        tinf_copy_match(d);
     }
+    return TINF_OK;
+}
+
+/* copy n bytes of an uncompressed block to dest (and the dictionary) */
+static void tinf_put_bytes(TINF_DATA *d, const unsigned char *src, unsigned int n)
+{
+    memcpy(d->dest, src, n);
+    d->dest += n;
 
-    /* copy next byte from dict substring */
     if (d->dict_ring) {
-        TINF_PUT(d, d->dict_ring[d->lzOff]);
-        if ((unsigned)++d->lzOff == d->dict_size) {
-            d->lzOff = 0;
+        /* n is at most dict_size, so this wraps at most once */
+        unsigned int first = d->dict_size - d->dict_idx;
+        if (first > n) {
+            first = n;
         }
-    } else {
-        #if UZLIB_CONF_USE_MEMCPY
-        /* copy as much as possible, in one memcpy() call */
-        unsigned int to_copy = d->curlen, dest_len = d->dest_limit - d->dest;
-        if (to_copy > dest_len) {
-            to_copy = dest_len;
+        memcpy(d->dict_ring + d->dict_idx, src, first);
+        memcpy(d->dict_ring, src + first, n - first);
+        d->dict_idx += n;
+        if (d->dict_idx >= d->dict_size) {
+            d->dict_idx -= d->dict_size;
         }
-        memcpy(d->dest, d->dest + d->lzOff, to_copy);
-        d->dest += to_copy;
-        d->curlen -= to_copy;
-        return TINF_OK;
-        #else
-        d->dest[0] = d->dest[d->lzOff];
-        d->dest++;
-        #endif
     }
-    d->curlen--;
-    return TINF_OK;
 }
 
-/* inflate next byte from uncompressed block of data */
+/* inflate output from an uncompressed block until dest is full or the
+   block ends */
 static int tinf_inflate_uncompressed_block(TINF_DATA *d)
 {
     if (d->curlen == 0) {
         unsigned int length, invlength;
 
+        /* the block starts on a byte boundary */
+        tinf_align(d);
+
         /* get length */
-        length = uzlib_get_byte(d);
-        length += 256 * uzlib_get_byte(d);
+        length = tinf_get_aligned_byte(d);
+        length += 256 * tinf_get_aligned_byte(d);
         /* get one's complement of length */
-        invlength = uzlib_get_byte(d);
-        invlength += 256 * uzlib_get_byte(d);
+        invlength = tinf_get_aligned_byte(d);
+        invlength += 256 * tinf_get_aligned_byte(d);
         /* check length */
         if (length != (~invlength & 0x0000ffff)) return TINF_DATA_ERROR;
 
         /* increment length to properly return TINF_DONE below, without
            producing data at the same time */
         d->curlen = length + 1;
-
-        /* make sure we start next block on a byte boundary */
-        d->bitcount = 0;
     }
 
-    if (--d->curlen == 0) {
-        return TINF_DONE;
-    }
+    while (d->dest < d->dest_limit) {
+        unsigned int n;
 
-    unsigned char c = uzlib_get_byte(d);
-    TINF_PUT(d, c);
+        if (d->curlen == 1) {
+            d->curlen = 0;
+            return TINF_DONE;
+        }
+
+        /* bytes still in the tag, or the next buffer from the callback */
+        if (d->bitcount >= 8 || d->source >= d->source_limit) {
+            unsigned char c = tinf_get_aligned_byte(d);
+            TINF_PUT(d, c);
+            d->curlen--;
+            continue;
+        }
+
+        n = d->curlen - 1;
+        if (n > (unsigned)(d->source_limit - d->source)) n = d->source_limit - d->source;
+        if (n > (unsigned)(d->dest_limit - d->dest)) n = d->dest_limit - d->dest;
+        if (d->dict_ring && n > d->dict_size) n = d->dict_size;
+
+        tinf_put_bytes(d, d->source, n);
+        d->source += n;
+        d->curlen -= n;
+    }
     return TINF_OK;
 }
 
@@ -552,7 +725,9 @@ void uzlib_init(void)
 void uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen)
 {
    d->eof = 0;
+   d->tag = 0;
    d->bitcount = 0;
+   d->padbits = 0;
    d->bfinal = 0;
    d->btype = -1;
    d->dict_size = dictLen;
@@ -561,6 +736,13 @@ void uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen)
    d->curlen = 0;
 }
 
+/* use lookup tables of UZLIB_FAST_TABLES_LEN shorts for the trees */
+void uzlib_uncompress_set_fast_tables(TINF_DATA *d, unsigned short *tables)
+{
+   d->ltree.fast = tables;
+   d->dtree.fast = tables ? tables + (1 << UZLIB_CONF_FAST_BITS) : NULL;
+}
+
 /* inflate next output bytes from compressed stream */
 int uzlib_uncompress(TINF_DATA *d)
 {
@@ -650,6 +832,9 @@ int uzlib_uncompress_chksum(TINF_DATA *d)
     if (res == TINF_DONE) {
         unsigned int val;
 
+        /* the trailer starts on a byte boundary */
+        tinf_align(d);
+
         switch (d->checksum_type) {
 
         case TINF_CHKSUM_ADLER:
@@ -78,8 +78,13 @@ extern "C" {
 typedef struct {
    unsigned short table[16];  /* table of code length counts */
    unsigned short trans[288]; /* code -> symbol translation table */
+   unsigned short *fast;      /* optional: (code length << 9 | symbol) by next
+                                 UZLIB_CONF_FAST_BITS input bits, 0 for longer codes */
 } TINF_TREE;
 
+/* number of shorts to pass to uzlib_uncompress_set_fast_tables() */
+#define UZLIB_FAST_TABLES_LEN (2 << UZLIB_CONF_FAST_BITS)
+
 struct uzlib_uncomp {
     /* Pointer to the next byte in the input buffer */
     const unsigned char *source;
@@ -94,6 +99,8 @@ struct uzlib_uncomp {
 
     unsigned int tag;
     unsigned int bitcount;
+    /* Zero bits appended to tag past the end of the input */
+    unsigned int padbits;
 
     /* Destination (output) buffer start */
     unsigned char *dest_start;
@@ -133,6 +140,9 @@ unsigned char TINFCC uzlib_get_byte(TINF_DATA *d);
 
 void TINFCC uzlib_init(void);
 void TINFCC uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen);
+/* Optional, after uzlib_uncompress_init() and before decoding: lookup tables
+   of UZLIB_FAST_TABLES_LEN shorts for decoding short codes in one step */
+void TINFCC uzlib_uncompress_set_fast_tables(TINF_DATA *d, unsigned short *tables);
 int  TINFCC uzlib_uncompress(TINF_DATA *d);
 int  TINFCC uzlib_uncompress_chksum(TINF_DATA *d);
 
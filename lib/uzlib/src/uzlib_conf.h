@@ -29,4 +29,11 @@
 #define UZLIB_CONF_USE_MEMCPY 0
 #endif
 
+#ifndef UZLIB_CONF_FAST_BITS
+/* Huffman codes up to this many bits long are decoded with one lookup
+   when the caller provides tables (see uzlib_uncompress_set_fast_tables()),
+   longer ones bit by bit. Tables take 2 * 2^bits shorts; at most 9. */
+#define UZLIB_CONF_FAST_BITS 9
+#endif
+
 #endif /* UZLIB_CONF_H_INCLUDED */
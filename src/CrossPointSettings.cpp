@@ -292,6 +292,20 @@ int CrossPointSettings::getRefreshFrequency() const {
   }
 }
 
+unsigned long CrossPointSettings::getTextAntiAliasingDelayMs() const {
+  switch (textAntiAliasingDelay) {
+    case AA_DELAY_NONE:
+    default:
+      return 0;
+    case AA_DELAY_500_MS:
+      return 500;
+    case AA_DELAY_1_S:
+      return 1000;
+    case AA_DELAY_2_S:
+      return 2000;
+  }
+}
+
 int CrossPointSettings::getReaderFontId() const {
   switch (fontFamily) {
     case BOOKERLY:
@@ -113,6 +113,9 @@ class CrossPointSettings {
     REFRESH_FREQUENCY_COUNT
   };
 
+  // Idle time before the anti-aliasing pass runs on a freshly turned page
+  enum TEXT_AA_DELAY { AA_DELAY_NONE = 0, AA_DELAY_500_MS = 1, AA_DELAY_1_S = 2, AA_DELAY_2_S = 3, TEXT_AA_DELAY_COUNT };
+
   // Short power button press actions
   enum SHORT_PWRBTN { IGNORE = 0, SLEEP = 1, PAGE_TURN = 2, SHORT_PWRBTN_COUNT };
 
@@ -133,6 +136,7 @@ class CrossPointSettings {
   // Text rendering settings
   uint8_t extraParagraphSpacing = 1;
   uint8_t textAntiAliasing = 1;
+  uint8_t textAntiAliasingDelay = AA_DELAY_NONE;
   // Short power button click behaviour
   uint8_t shortPwrBtn = IGNORE;
   // EPUB reading orientation settings
@@ -200,6 +204,7 @@ class CrossPointSettings {
   float getReaderLineCompression() const;
   unsigned long getSleepTimeoutMs() const;
   int getRefreshFrequency() const;
+  unsigned long getTextAntiAliasingDelayMs() const;
 };
 
 // Helper macro to access settings
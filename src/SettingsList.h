@@ -67,6 +67,9 @@ inline std::vector<SettingInfo> getSettingsList() {
                           StrId::STR_CAT_READER),
       SettingInfo::Toggle(StrId::STR_TEXT_AA, &CrossPointSettings::textAntiAliasing, "textAntiAliasing",
                           StrId::STR_CAT_READER),
+      SettingInfo::Enum(StrId::STR_TEXT_AA_DELAY, &CrossPointSettings::textAntiAliasingDelay,
+                        {StrId::STR_IMMEDIATE, StrId::STR_SEC_HALF, StrId::STR_SEC_1, StrId::STR_SEC_2},
+                        "textAntiAliasingDelay", StrId::STR_CAT_READER),
 
       // --- Controls ---
       SettingInfo::Enum(StrId::STR_SIDE_BTN_LAYOUT, &CrossPointSettings::sideButtonLayout,
@@ -13,6 +13,7 @@ class SleepActivity final : public Activity {
   void renderDefaultSleepScreen() const;
   void renderCustomSleepScreen() const;
   void renderCoverSleepScreen() const;
-  void renderBitmapSleepScreen(const Bitmap& bitmap) const;
+  // `cachePath`: BMP path to keep a frame buffer image cache next to (see GfxRenderer::drawBitmapCached), or empty
+  void renderBitmapSleepScreen(const Bitmap& bitmap, const std::string& cachePath = "") const;
   void renderBlankSleepScreen() const;
 };
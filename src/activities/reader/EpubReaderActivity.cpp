@@ -1,11 +1,14 @@
 #include "EpubReaderActivity.h"
 
+#include <Epub/CachePack.h>
 #include <Epub/Page.h>
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
+#include <HalPowerManager.h>
 #include <HalStorage.h>
 #include <I18n.h>
 #include <Logging.h>
+#include <StorageStats.h>
 
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
@@ -20,7 +23,6 @@
 #include "util/ScreenshotUtil.h"
 
 namespace {
-// pagesPerRefresh now comes from SETTINGS.getRefreshFrequency()
 constexpr unsigned long skipChapterMs = 700;
 constexpr unsigned long goHomeMs = 1000;
 constexpr int statusBarMargin = 19;
@@ -69,10 +71,15 @@ void EpubReaderActivity::onEnter() {
   // Configure screen orientation based on settings
   // NOTE: This affects layout math and must be applied before any render calls.
   applyReaderOrientation(renderer, SETTINGS.orientation);
+  // Open the book on a clean panel
+  renderer.requestHalfRefresh();
 
   epub->setupCacheDir();
+  // Compact the image pack now, not in the first page render that shows an image
+  CachePack::open(epub->getCachePath());
 
   FsFile f;
+  bool progressLoaded = false;
   if (Storage.openFileForRead("ERS", epub->getCachePath() + "/progress.bin", f)) {
     uint8_t data[6];
     int dataSize = f.read(data, 6);
@@ -80,6 +87,7 @@ void EpubReaderActivity::onEnter() {
       currentSpineIndex = data[0] + (data[1] << 8);
       nextPageNumber = data[2] + (data[3] << 8);
       cachedSpineIndex = currentSpineIndex;
+      progressLoaded = true;
       LOG_DBG("ERS", "Loaded cache: %d, %d", currentSpineIndex, nextPageNumber);
     }
     if (dataSize == 6) {
@@ -87,6 +95,8 @@ void EpubReaderActivity::onEnter() {
     }
     f.close();
   }
+  progress.begin(epub->getCachePath() + "/progress.bin", progressLoaded ? currentSpineIndex : -1,
+                 progressLoaded ? nextPageNumber : -1);
   // We may want a better condition to detect if we are opening for the first time.
   // This will trigger if the book is re-opened at Chapter 0.
   if (currentSpineIndex == 0) {
@@ -108,6 +118,7 @@ void EpubReaderActivity::onEnter() {
 
 void EpubReaderActivity::onExit() {
   ActivityWithSubactivity::onExit();
+  progress.end();
 
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
@@ -115,10 +126,18 @@ void EpubReaderActivity::onExit() {
   APP_STATE.readerActivityLoadCount = 0;
   APP_STATE.saveToFile();
   section.reset();
+  prefetchedPage.reset();
   epub.reset();
+  aaGlyphs.release();
 }
 
 void EpubReaderActivity::loop() {
+  // The page has stayed on screen a while: time to write where the reader is
+  if (progress.due(millis())) {
+    RenderLock lock(*this);
+    progress.flush();
+  }
+
   // Pass input responsibility to sub activity if exists
   if (subActivity) {
     subActivity->loop();
@@ -164,16 +183,37 @@ void EpubReaderActivity::loop() {
     return;
   }
 
+  // Deferred anti-aliasing: any input restarts the idle period; once it elapses, run the grayscale pass. Only the
+  // schedule read here is changed, so one the render task has just replaced or cancelled is left alone.
+  if (unsigned long dueAt = deferredAaDueAt.load(); dueAt != 0) {
+    if (mappedInput.wasAnyPressed() || mappedInput.wasAnyReleased()) {
+      deferredAaDueAt.compare_exchange_strong(dueAt, millis() + SETTINGS.getTextAntiAliasingDelayMs());
+    } else if (static_cast<long>(millis() - dueAt) >= 0 && deferredAaDueAt.compare_exchange_strong(dueAt, 0)) {
+      runDeferredAa.store(true);
+      requestUpdate();
+    }
+  }
+
   // Enter reader menu activity.
   if (mappedInput.wasReleased(MappedInputManager::Button::Confirm)) {
-    const int currentPage = section ? section->currentPage + 1 : 0;
-    const int totalPages = section ? section->pageCount : 0;
+    // The render task may be replacing the section for a page turn
+    int currentPage = 0;
+    int totalPages = 0;
     float bookProgress = 0.0f;
-    if (epub && epub->getBookSize() > 0 && section && section->pageCount > 0) {
-      const float chapterProgress = static_cast<float>(section->currentPage) / static_cast<float>(section->pageCount);
-      bookProgress = epub->calculateProgress(currentSpineIndex, chapterProgress) * 100.0f;
+    {
+      RenderLock lock(*this);
+      currentPage = section ? section->currentPage + 1 : 0;
+      totalPages = section ? section->pageCount : 0;
+      if (epub && epub->getBookSize() > 0 && section && section->pageCount > 0) {
+        const float chapterProgress =
+            static_cast<float>(section->currentPage) / static_cast<float>(section->pageCount);
+        bookProgress = epub->calculateProgress(currentSpineIndex, chapterProgress) * 100.0f;
+      }
     }
     const int bookProgressPercent = clampPercent(static_cast<int>(bookProgress + 0.5f));
+    // The menu draws over the framebuffer, so the pending grayscale pass can no longer run
+    deferredAaDueAt.store(0);
+    runDeferredAa.store(false);
     exitActivity();
     enterNewActivity(new EpubReaderMenuActivity(
         this->renderer, this->mappedInput, epub->getTitle(), currentPage, totalPages, bookProgressPercent,
@@ -193,17 +233,28 @@ void EpubReaderActivity::loop() {
     return;
   }
 
+  const bool pageForwardDown = mappedInput.wasPressed(MappedInputManager::Button::PageForward) ||
+                               mappedInput.wasPressed(MappedInputManager::Button::Right);
+  const bool pageBackDown = mappedInput.wasPressed(MappedInputManager::Button::PageBack) ||
+                            mappedInput.wasPressed(MappedInputManager::Button::Left);
+  if (pageForwardDown || pageBackDown) {
+    pageTurnPressedAt = millis();
+    // Turns wait for the release to tell a page turn from a chapter skip: draw the page meanwhile
+    if (SETTINGS.longPressChapterSkip && pageTurns.empty()) {
+      speculativeDirection.store(pageForwardDown ? 1 : -1);
+      requestUpdate();
+    }
+  }
+
   // When long-press chapter skip is disabled, turn pages on press instead of release.
   const bool usePressForPageTurn = !SETTINGS.longPressChapterSkip;
-  const bool prevTriggered = usePressForPageTurn ? (mappedInput.wasPressed(MappedInputManager::Button::PageBack) ||
-                                                    mappedInput.wasPressed(MappedInputManager::Button::Left))
+  const bool prevTriggered = usePressForPageTurn ? pageBackDown
                                                  : (mappedInput.wasReleased(MappedInputManager::Button::PageBack) ||
                                                     mappedInput.wasReleased(MappedInputManager::Button::Left));
   const bool powerPageTurn = SETTINGS.shortPwrBtn == CrossPointSettings::SHORT_PWRBTN::PAGE_TURN &&
                              mappedInput.wasReleased(MappedInputManager::Button::Power);
   const bool nextTriggered = usePressForPageTurn
-                                 ? (mappedInput.wasPressed(MappedInputManager::Button::PageForward) || powerPageTurn ||
-                                    mappedInput.wasPressed(MappedInputManager::Button::Right))
+                                 ? (pageForwardDown || powerPageTurn)
                                  : (mappedInput.wasReleased(MappedInputManager::Button::PageForward) || powerPageTurn ||
                                     mappedInput.wasReleased(MappedInputManager::Button::Right));
 
@@ -213,6 +264,7 @@ void EpubReaderActivity::loop() {
 
   // any botton press when at end of the book goes back to the last page
   if (currentSpineIndex > 0 && currentSpineIndex >= epub->getSpineItemsCount()) {
+    pageTurns.clear();
     currentSpineIndex = epub->getSpineItemsCount() - 1;
     nextPageNumber = UINT16_MAX;
     requestUpdate();
@@ -225,6 +277,7 @@ void EpubReaderActivity::loop() {
     // We don't want to delete the section mid-render, so grab the semaphore
     {
       RenderLock lock(*this);
+      pageTurns.clear();
       nextPageNumber = 0;
       currentSpineIndex = nextTriggered ? currentSpineIndex + 1 : currentSpineIndex - 1;
       section.reset();
@@ -233,39 +286,11 @@ void EpubReaderActivity::loop() {
     return;
   }
 
-  // No current section, attempt to rerender the book
-  if (!section) {
-    requestUpdate();
-    return;
-  }
-
-  if (prevTriggered) {
-    if (section->currentPage > 0) {
-      section->currentPage--;
-    } else if (currentSpineIndex > 0) {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      {
-        RenderLock lock(*this);
-        nextPageNumber = UINT16_MAX;
-        currentSpineIndex--;
-        section.reset();
-      }
-    }
-    requestUpdate();
-  } else {
-    if (section->currentPage < section->pageCount - 1) {
-      section->currentPage++;
-    } else {
-      // We don't want to delete the section mid-render, so grab the semaphore
-      {
-        RenderLock lock(*this);
-        nextPageNumber = 0;
-        currentSpineIndex++;
-        section.reset();
-      }
-    }
-    requestUpdate();
-  }
+  // The render task applies the turn, together with any others that arrive before it gets to it. Crossing into
+  // another chapter happens there too, as does loading a missing section first, so the input loop never waits for a
+  // render or a section build and never touches the section the render task owns.
+  pageTurns.push(nextTriggered ? 1 : -1);
+  requestUpdate();
 }
 
 void EpubReaderActivity::onReaderMenuBack(const uint8_t orientation) {
@@ -425,7 +450,9 @@ void EpubReaderActivity::onReaderMenuConfirm(EpubReaderMenuActivity::MenuAction
           // 4. RESTORE: Re-setup the directory and rewrite the progress file
           epub->setupCacheDir();
 
-          saveProgress(backupSpine, backupPage, backupPageCount);
+          progress.begin(epub->getCachePath() + "/progress.bin", -1, -1);
+          recordProgress(backupSpine, backupPage, backupPageCount);
+          progress.flush();
         }
       }
       // Defer go home to avoid race condition with display task
@@ -496,10 +523,21 @@ void EpubReaderActivity::applyOrientation(const uint8_t orientation) {
 
 // TODO: Failure handling
 void EpubReaderActivity::render(Activity::RenderLock&& lock) {
+  StorageStats::Scope ioScope(StorageStats::Tag::Reader);
   if (!epub) {
     return;
   }
 
+  // A speculatively drawn page is only good for the render right after it
+  auto speculated = std::move(speculativePage);
+
+  if (runDeferredAa.exchange(false)) {
+    if (isDeferredAaPageCurrent()) {
+      renderDeferredAntiAliasing();
+      return;
+    }
+  }
+
   // edge case handling for sub-zero spine index
   if (currentSpineIndex < 0) {
     currentSpineIndex = 0;
@@ -542,6 +580,7 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
     const auto filepath = epub->getSpineItem(currentSpineIndex).href;
     LOG_DBG("ERS", "Loading file: %s, index: %d", filepath.c_str(), currentSpineIndex);
     section = std::unique_ptr<Section>(new Section(epub, currentSpineIndex, renderer));
+    prefetchedPage.reset();
 
     const uint16_t viewportWidth = renderer.getScreenWidth() - orientedMarginLeft - orientedMarginRight;
     const uint16_t viewportHeight = renderer.getScreenHeight() - orientedMarginTop - orientedMarginBottom;
@@ -553,9 +592,33 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
 
       const auto popupFn = [this]() { GUI.drawPopup(renderer, tr(STR_INDEXING)); };
 
-      if (!section->createSectionFile(SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(),
-                                      SETTINGS.extraParagraphSpacing, SETTINGS.paragraphAlignment, viewportWidth,
-                                      viewportHeight, SETTINGS.hyphenationEnabled, SETTINGS.embeddedStyle, popupFn)) {
+      // Turned back out of a chapter entered at its start (or forward out of one entered at its end) before it
+      // could be shown: no point finishing the build
+      const bool enteredAtStart = nextPageNumber == 0;
+      const bool enteredAtEnd = nextPageNumber == UINT16_MAX;
+      bool buildCancelled = false;
+      const auto turnedAway = [this, enteredAtStart, enteredAtEnd, &buildCancelled]() {
+        const int turns = pageTurns.peek();
+        buildCancelled = (enteredAtStart && turns < 0) || (enteredAtEnd && turns > 0);
+        return buildCancelled;
+      };
+
+      const bool created = section->createSectionFile(
+          SETTINGS.getReaderFontId(), SETTINGS.getReaderLineCompression(), SETTINGS.extraParagraphSpacing,
+          SETTINGS.paragraphAlignment, viewportWidth, viewportHeight, SETTINGS.hyphenationEnabled,
+          SETTINGS.embeddedStyle, popupFn, turnedAway);
+      if (!created && buildCancelled) {
+        // Entered at its first or last page, the unbuilt chapter counts as a single page for turns leaving it.
+        // Turns that came back into it since are applied once it is built.
+        LOG_DBG("ERS", "Section build cancelled by page turn");
+        if (turnedAway() && !applyPageTurns(0, 1, pageTurns.take())) {
+          return;
+        }
+        section.reset();
+        requestUpdate();
+        return;
+      }
+      if (!created) {
         LOG_ERR("ERS", "Failed to persist page data to SD");
         section.reset();
         return;
@@ -592,12 +655,34 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
     }
   }
 
-  renderer.clearScreen();
+  const int turns = pageTurns.take();
+  if (turns != 0 && !applyPageTurns(section->currentPage, section->pageCount, turns)) {
+    return;
+  }
+
+  // Unless the release already turned the page while this render was pending. Only within the loaded section; a
+  // turn across chapters has to load the next one first.
+  if (const int direction = speculativeDirection.exchange(0); direction != 0 && turns == 0) {
+    const int target = section->currentPage + direction;
+    if (target >= 0 && target < section->pageCount) {
+      speculativeSpineIndex = currentSpineIndex;
+      speculativePageNumber = target;
+      renderSpeculativePage(orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+      return;
+    }
+  }
+
+  // The release turned to the page drawn while the button was down: the framebuffer already holds it
+  const bool commitSpeculation =
+      speculated && currentSpineIndex == speculativeSpineIndex && section->currentPage == speculativePageNumber;
+  if (!commitSpeculation) {
+    renderer.clearScreen();
+  }
 
   if (section->pageCount == 0) {
     LOG_DBG("ERS", "No pages to render");
     renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_EMPTY_CHAPTER), true, EpdFontFamily::BOLD);
-    renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+    renderStatusBar(section->currentPage, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
     renderer.displayBuffer();
     return;
   }
@@ -605,13 +690,20 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
   if (section->currentPage < 0 || section->currentPage >= section->pageCount) {
     LOG_DBG("ERS", "Page out of bounds: %d (max %d)", section->currentPage, section->pageCount);
     renderer.drawCenteredText(UI_12_FONT_ID, 300, tr(STR_OUT_OF_BOUNDS), true, EpdFontFamily::BOLD);
-    renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+    renderStatusBar(section->currentPage, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
     renderer.displayBuffer();
     return;
   }
 
-  {
-    auto p = section->loadPageFromSectionFile();
+  if (commitSpeculation) {
+    LOG_DBG("ERS", "Committing speculatively drawn page %d", speculativePageNumber);
+    presentContents(std::move(speculated), orientedMarginTop, orientedMarginRight, orientedMarginBottom,
+                    orientedMarginLeft);
+  } else {
+    auto p = takePrefetchedPage();
+    if (!p) {
+      p = section->loadPageFromSectionFile();
+    }
     if (!p) {
       LOG_ERR("ERS", "Failed to load page from SD - clearing section cache");
       section->clearCache();
@@ -621,11 +713,24 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
       return;
     }
     const auto start = millis();
+    const uint16_t glyphCacheMisses = p->prewarmGlyphs(renderer, SETTINGS.getReaderFontId());
     renderContents(std::move(p), orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
-    LOG_DBG("ERS", "Rendered page in %dms", millis() - start);
+    LOG_DBG("ERS", "Rendered page in %dms (%u glyph cache misses)", millis() - start, glyphCacheMisses);
     renderer.clearFontCache();
   }
-  saveProgress(currentSpineIndex, section->currentPage, section->pageCount);
+
+  // The page's refresh may still be running; do the work that doesn't touch the framebuffer meanwhile
+  const auto refreshQueuedAt = millis();
+  const uint32_t progressWrites = progress.stats().writes;
+  recordProgress(currentSpineIndex, section->currentPage, section->pageCount);
+  const auto progressRecordedAt = millis();
+  prefetchNextPage();
+  const auto nextPageReadyAt = millis();
+  const uint32_t waitedMs = renderer.waitForRefresh();
+  LOG_DBG("ERS",
+          "Timeline: progress recorded +%lums (%s), next page ready +%lums, refresh done +%lums (waited %lums)",
+          progressRecordedAt - refreshQueuedAt, progress.stats().writes != progressWrites ? "written" : "pending",
+          nextPageReadyAt - refreshQueuedAt, millis() - refreshQueuedAt, static_cast<unsigned long>(waitedMs));
 
   if (pendingScreenshot) {
     pendingScreenshot = false;
@@ -633,31 +738,121 @@ void EpubReaderActivity::render(Activity::RenderLock&& lock) {
   }
 }
 
-void EpubReaderActivity::saveProgress(int spineIndex, int currentPage, int pageCount) {
-  FsFile f;
-  if (Storage.openFileForWrite("ERS", epub->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[6];
-    data[0] = currentSpineIndex & 0xFF;
-    data[1] = (currentSpineIndex >> 8) & 0xFF;
-    data[2] = currentPage & 0xFF;
-    data[3] = (currentPage >> 8) & 0xFF;
-    data[4] = pageCount & 0xFF;
-    data[5] = (pageCount >> 8) & 0xFF;
-    f.write(data, 6);
-    f.close();
-    LOG_DBG("ERS", "Progress saved: Chapter %d, Page %d", spineIndex, currentPage);
+bool EpubReaderActivity::applyPageTurns(const int page, const int pageCount, const int turns) {
+  const auto target = PageTurnQueue::resolve(currentSpineIndex, page, pageCount, turns);
+  if (target.spineIndex == currentSpineIndex) {
+    section->currentPage = target.page;
+    return true;
+  }
+
+  LOG_DBG("ERS", "Page turns (%d) leave spine %d for spine %d, %d turns left", turns, currentSpineIndex,
+          target.spineIndex, target.remainingTurns);
+  currentSpineIndex = target.spineIndex;
+  nextPageNumber = target.page == PageTurnQueue::LAST_PAGE ? UINT16_MAX : target.page;
+  section.reset();
+  prefetchedPage.reset();
+  pageTurns.push(target.remainingTurns);
+  requestUpdate();
+  return false;
+}
+
+bool EpubReaderActivity::isPageSuperseded() const { return !pageTurns.empty(); }
+
+void EpubReaderActivity::renderSpeculativePage(const int orientedMarginTop, const int orientedMarginRight,
+                                               const int orientedMarginBottom, const int orientedMarginLeft) {
+  const auto start = millis();
+  std::unique_ptr<Page> page;
+  if (prefetchedPage && prefetchedPageNumber == speculativePageNumber) {
+    page = std::move(prefetchedPage);
   } else {
-    LOG_ERR("ERS", "Could not save progress!");
+    page = section->loadPage(speculativePageNumber);
+  }
+  if (!page) {
+    return;
   }
+
+  // Nothing reaches the panel; the framebuffer is redrawn by whatever render comes next if this page isn't it. It no
+  // longer holds the page on screen, so that page's deferred grayscale pass can't run over it.
+  deferredAaPage.reset();
+  renderer.clearScreen();
+  page->prewarmGlyphs(renderer, SETTINGS.getReaderFontId());
+  drawContents(*page, speculativePageNumber, orientedMarginTop, orientedMarginRight, orientedMarginBottom,
+               orientedMarginLeft);
+  renderer.clearFontCache();
+  speculativePage = std::move(page);
+  LOG_DBG("ERS", "Speculatively drew page %d in %dms", speculativePageNumber, millis() - start);
+}
+
+void EpubReaderActivity::prefetchNextPage() {
+  const int nextPage = section->currentPage + 1;
+  if (nextPage >= section->pageCount) {
+    prefetchedPage.reset();
+    return;
+  }
+  if (prefetchedPage && prefetchedPageNumber == nextPage) {
+    return;
+  }
+  prefetchedPage = section->loadPage(nextPage);
+  prefetchedPageNumber = nextPage;
+}
+
+std::unique_ptr<Page> EpubReaderActivity::takePrefetchedPage() {
+  if (!prefetchedPage || prefetchedPageNumber != section->currentPage) {
+    return nullptr;
+  }
+  return std::move(prefetchedPage);
+}
+
+void EpubReaderActivity::recordProgress(int spineIndex, int currentPage, int pageCount) {
+  uint8_t data[6];
+  data[0] = spineIndex & 0xFF;
+  data[1] = (spineIndex >> 8) & 0xFF;
+  data[2] = currentPage & 0xFF;
+  data[3] = (currentPage >> 8) & 0xFF;
+  data[4] = pageCount & 0xFF;
+  data[5] = (pageCount >> 8) & 0xFF;
+  progress.record(spineIndex, currentPage, data, sizeof(data), powerManager.getBatteryPercentage(), millis());
 }
 void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int orientedMarginTop,
                                         const int orientedMarginRight, const int orientedMarginBottom,
                                         const int orientedMarginLeft) {
+  drawContents(*page, section->currentPage, orientedMarginTop, orientedMarginRight, orientedMarginBottom,
+               orientedMarginLeft);
+  presentContents(std::move(page), orientedMarginTop, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+}
+
+void EpubReaderActivity::drawContents(const Page& page, const int pageNumber, const int orientedMarginTop,
+                                      const int orientedMarginRight, const int orientedMarginBottom,
+                                      const int orientedMarginLeft) {
+  // A new page always supersedes a grayscale pass still waiting for the previous one, which also relies on the
+  // framebuffer still holding the page on screen
+  deferredAaPage.reset();
+  deferredAaDueAt.store(0);
+
+  // With anti-aliasing on, record the page's glyphs during the BW pass so both grayscale planes can be replayed
+  // from the list instead of walking the page again
+  if (SETTINGS.textAntiAliasing) {
+    renderer.beginGlyphCapture(aaGlyphs, page.glyphCount());
+  } else {
+    aaGlyphs.release();
+  }
+  page.render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+  renderer.endGlyphCapture();
+  renderStatusBar(pageNumber, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+}
+
+void EpubReaderActivity::presentContents(std::unique_ptr<Page> page, const int orientedMarginTop,
+                                         const int orientedMarginRight, const int orientedMarginBottom,
+                                         const int orientedMarginLeft) {
   // Force special handling for pages with images when anti-aliasing is on
   bool imagePageWithAA = page->hasImages() && SETTINGS.textAntiAliasing;
+  const unsigned long aaDelayMs = SETTINGS.getTextAntiAliasingDelayMs();
+
+  if (pageTurnPressedAt != 0) {
+    LOG_DBG("ERS", "Page button press to refresh: %lums", millis() - pageTurnPressedAt);
+    pageTurnPressedAt = 0;
+  }
 
-  page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-  renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
   if (imagePageWithAA) {
     // Double FAST_REFRESH with selective image blanking (pablohc's technique):
     // HALF_REFRESH sets particles too firmly for the grayscale LUT to adjust.
@@ -668,21 +863,41 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
     if (page->getImageBoundingBox(imgX, imgY, imgW, imgH)) {
       renderer.fillRect(imgX + orientedMarginLeft, imgY + orientedMarginTop, imgW, imgH, false);
       renderer.displayBuffer(HalDisplay::FAST_REFRESH);
+      if (isPageSuperseded()) {
+        // The next page is already waiting; skip drawing the images and the grayscale pass
+        LOG_DBG("ERS", "Image page superseded after its first refresh");
+        aaGlyphs.release();
+        return;
+      }
 
       // Re-render page content to restore images into the blanked area
       page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-      renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
+      renderStatusBar(section->currentPage, orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
       renderer.displayBuffer(HalDisplay::FAST_REFRESH);
     } else {
       renderer.displayBuffer(HalDisplay::HALF_REFRESH);
     }
-    // Double FAST_REFRESH handles ghosting for image pages; don't count toward full refresh cadence
-  } else if (pagesUntilFullRefresh <= 1) {
-    renderer.displayBuffer(HalDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
+    // Both fast refreshes are still recorded by the refresh scheduler, so the image counts toward the next half refresh
   } else {
-    renderer.displayBuffer();
-    pagesUntilFullRefresh--;
+    // Unless the grayscale pass follows right away, let the panel refresh while render() does the page's
+    // remaining work (progress, next page) and wait for it at the end
+    const bool grayscaleNext = SETTINGS.textAntiAliasing && aaDelayMs == 0;
+    renderer.displayAdaptive(SETTINGS.getRefreshFrequency(), grayscaleNext);
+  }
+
+  if (!SETTINGS.textAntiAliasing) {
+    return;
+  }
+
+  // Deferred anti-aliasing: leave the BW page up and run the grayscale pass from loop() once input has been idle
+  if (aaDelayMs > 0) {
+    deferredAaPage = std::move(page);
+    deferredAaMarginLeft = orientedMarginLeft;
+    deferredAaMarginTop = orientedMarginTop;
+    deferredAaSpineIndex = currentSpineIndex;
+    deferredAaPageNumber = section->currentPage;
+    deferredAaDueAt.store(millis() + aaDelayMs);
+    return;
   }
 
   // Save bw buffer to reset buffer state after grayscale data sync
@@ -690,29 +905,71 @@ void EpubReaderActivity::renderContents(std::unique_ptr<Page> page, const int or
 
   // grayscale rendering
   // TODO: Only do this if font supports it
-  if (SETTINGS.textAntiAliasing) {
-    renderer.clearScreen(0x00);
-    renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-    renderer.copyGrayscaleLsbBuffers();
-
-    // Render and copy to MSB buffer
-    renderer.clearScreen(0x00);
-    renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
-    page->render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
-    renderer.copyGrayscaleMsbBuffers();
-
-    // display grayscale part
-    renderer.displayGrayBuffer();
+  renderGrayscalePlanes(*page, orientedMarginLeft, orientedMarginTop, true);
+
+  // restore the bw data
+  renderer.restoreBwBuffer();
+  aaGlyphs.release();
+}
+
+bool EpubReaderActivity::renderGrayscalePlanes(const Page& page, const int orientedMarginLeft,
+                                               const int orientedMarginTop, const bool cancellable) {
+  const auto grayStart = millis();
+  // Underlines are drawn black and leave the grayscale planes untouched, so glyphs and images are all they need
+  const auto renderGrayPlane = [&]() {
+    if (renderer.replayGlyphs(aaGlyphs)) {
+      page.renderImages(renderer, orientedMarginLeft, orientedMarginTop);
+    } else {
+      page.render(renderer, SETTINGS.getReaderFontId(), orientedMarginLeft, orientedMarginTop);
+    }
+  };
+
+  renderer.clearScreen(0x00);
+  renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
+  renderGrayPlane();
+  renderer.copyGrayscaleLsbBuffers();
+
+  // A page turn that lands mid-pass wins: drop the grayscale data before it reaches the panel
+  if (cancellable && isPageSuperseded()) {
     renderer.setRenderMode(GfxRenderer::BW);
+    LOG_DBG("ERS", "Anti-aliasing cancelled by page turn");
+    return false;
   }
 
-  // restore the bw data
+  // Render and copy to MSB buffer
+  renderer.clearScreen(0x00);
+  renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
+  renderGrayPlane();
+  renderer.copyGrayscaleMsbBuffers();
+  LOG_DBG("ERS", "Grayscale planes in %dms (%u glyphs %s)", millis() - grayStart,
+          static_cast<unsigned>(aaGlyphs.size()), aaGlyphs.isComplete() ? "replayed" : "overflowed, re-rendered");
+
+  // display grayscale part
+  renderer.displayGrayBuffer();
+  renderer.setRenderMode(GfxRenderer::BW);
+  return true;
+}
+
+bool EpubReaderActivity::isDeferredAaPageCurrent() const {
+  return deferredAaPage && section && currentSpineIndex == deferredAaSpineIndex &&
+         section->currentPage == deferredAaPageNumber && !isPageSuperseded();
+}
+
+void EpubReaderActivity::renderDeferredAntiAliasing() {
+  if (!isDeferredAaPageCurrent()) {
+    return;
+  }
+
+  // The framebuffer still holds the BW page that is on screen
+  const auto page = std::move(deferredAaPage);
+  renderer.storeBwBuffer();
+  renderGrayscalePlanes(*page, deferredAaMarginLeft, deferredAaMarginTop, true);
   renderer.restoreBwBuffer();
+  aaGlyphs.release();
 }
 
-void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const int orientedMarginBottom,
-                                         const int orientedMarginLeft) const {
+void EpubReaderActivity::renderStatusBar(const int pageNumber, const int orientedMarginRight,
+                                         const int orientedMarginBottom, const int orientedMarginLeft) const {
   auto metrics = UITheme::getInstance().getMetrics();
 
   // determine visible status bar elements
@@ -740,7 +997,7 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
   int progressTextWidth = 0;
 
   // Calculate progress in book
-  const float sectionChapterProg = static_cast<float>(section->currentPage) / section->pageCount;
+  const float sectionChapterProg = static_cast<float>(pageNumber) / section->pageCount;
   const float bookProgress = epub->calculateProgress(currentSpineIndex, sectionChapterProg) * 100;
 
   if (showProgressText || showProgressPercentage || showBookPercentage) {
@@ -749,12 +1006,12 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
 
     // Hide percentage when progress bar is shown to reduce clutter
     if (showProgressPercentage) {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d  %.0f%%", section->currentPage + 1, section->pageCount,
+      snprintf(progressStr, sizeof(progressStr), "%d/%d  %.0f%%", pageNumber + 1, section->pageCount,
                bookProgress);
     } else if (showBookPercentage) {
       snprintf(progressStr, sizeof(progressStr), "%.0f%%", bookProgress);
     } else {
-      snprintf(progressStr, sizeof(progressStr), "%d/%d", section->currentPage + 1, section->pageCount);
+      snprintf(progressStr, sizeof(progressStr), "%d/%d", pageNumber + 1, section->pageCount);
     }
 
     progressTextWidth = renderer.getTextWidth(SMALL_FONT_ID, progressStr);
@@ -770,7 +1027,7 @@ void EpubReaderActivity::renderStatusBar(const int orientedMarginRight, const in
   if (showChapterProgressBar) {
     // Draw chapter progress bar at the very bottom of the screen, from edge to edge of viewable area
     const float chapterProgress =
-        (section->pageCount > 0) ? (static_cast<float>(section->currentPage + 1) / section->pageCount) * 100 : 0;
+        (section->pageCount > 0) ? (static_cast<float>(pageNumber + 1) / section->pageCount) * 100 : 0;
     GUI.drawReadingProgressBar(renderer, static_cast<size_t>(chapterProgress));
   }
 
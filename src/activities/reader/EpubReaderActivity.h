@@ -1,8 +1,13 @@
 #pragma once
 #include <Epub.h>
+#include <Epub/Page.h>
 #include <Epub/Section.h>
 
+#include <atomic>
+
 #include "EpubReaderMenuActivity.h"
+#include "PageTurnQueue.h"
+#include "ProgressJournal.h"
 #include "activities/ActivityWithSubactivity.h"
 
 class EpubReaderActivity final : public ActivityWithSubactivity {
@@ -10,9 +15,11 @@ class EpubReaderActivity final : public ActivityWithSubactivity {
   std::unique_ptr<Section> section = nullptr;
   int currentSpineIndex = 0;
   int nextPageNumber = 0;
-  int pagesUntilFullRefresh = 0;
+  // Turns from loop() that the render task applies, all pending ones at once
+  PageTurnQueue pageTurns;
   int cachedSpineIndex = 0;
   int cachedChapterTotalPageCount = 0;
+  ProgressJournal progress;
   // Signals that the next render should reposition within the newly loaded section
   // based on a cross-book percentage jump.
   bool pendingPercentJump = false;
@@ -22,13 +29,51 @@ class EpubReaderActivity final : public ActivityWithSubactivity {
   bool pendingGoHome = false;           // Defer go home to avoid race condition with display task
   bool pendingScreenshot = false;
   bool skipNextButtonCheck = false;  // Skip button processing for one frame after subactivity exit
+  // Glyphs recorded during the BW pass, replayed for the grayscale planes
+  GlyphDisplayList aaGlyphs;
+  // Deferred anti-aliasing: the page whose grayscale pass is waiting for input to go idle
+  std::unique_ptr<Page> deferredAaPage = nullptr;
+  int deferredAaMarginLeft = 0;
+  int deferredAaMarginTop = 0;
+  int deferredAaSpineIndex = 0;
+  int deferredAaPageNumber = 0;
+  // Scheduled by the render task and pushed back or fired by loop(), so both are shared without the lock
+  std::atomic<unsigned long> deferredAaDueAt{0};  // 0 = nothing scheduled
+  std::atomic<bool> runDeferredAa{false};         // Set by loop() when the idle period elapsed
+  // Next page of the current section, loaded while the panel refreshes the current one
+  std::unique_ptr<Page> prefetchedPage = nullptr;
+  int prefetchedPageNumber = 0;
+  // Speculative page turn: while a page button is held (turns happen on release), the page it would turn to is drawn
+  // into the framebuffer, and sent to the panel only if the release turns to it. Any other render discards it.
+  std::atomic<int> speculativeDirection{0};  // Set by loop() on the press edge, taken by the render task; 0 = none
+  int speculativeSpineIndex = 0;             // The page the render task drew for it
+  int speculativePageNumber = 0;
+  std::unique_ptr<Page> speculativePage = nullptr;  // Set once the framebuffer holds that page
+  unsigned long pageTurnPressedAt = 0;              // For press-to-refresh latency, 0 = no page button pressed
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
   void renderContents(std::unique_ptr<Page> page, int orientedMarginTop, int orientedMarginRight,
                       int orientedMarginBottom, int orientedMarginLeft);
-  void renderStatusBar(int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
-  void saveProgress(int spineIndex, int currentPage, int pageCount);
+  // The two halves of renderContents: the BW pass into the framebuffer, and sending it (plus grayscale) to the panel
+  void drawContents(const Page& page, int pageNumber, int orientedMarginTop, int orientedMarginRight,
+                    int orientedMarginBottom, int orientedMarginLeft);
+  void presentContents(std::unique_ptr<Page> page, int orientedMarginTop, int orientedMarginRight,
+                       int orientedMarginBottom, int orientedMarginLeft);
+  void renderSpeculativePage(int orientedMarginTop, int orientedMarginRight, int orientedMarginBottom,
+                             int orientedMarginLeft);
+  // Returns false if a cancellable pass was abandoned because the page changed underneath it
+  bool renderGrayscalePlanes(const Page& page, int orientedMarginLeft, int orientedMarginTop, bool cancellable);
+  bool isDeferredAaPageCurrent() const;
+  // A newer page is waiting for the render task, so the one being presented can be cut short
+  bool isPageSuperseded() const;
+  // Returns false if the turns leave the section, which the next render then loads before applying the rest
+  bool applyPageTurns(int page, int pageCount, int turns);
+  void renderDeferredAntiAliasing();
+  void renderStatusBar(int pageNumber, int orientedMarginRight, int orientedMarginBottom, int orientedMarginLeft) const;
+  void recordProgress(int spineIndex, int currentPage, int pageCount);
+  void prefetchNextPage();
+  std::unique_ptr<Page> takePrefetchedPage();
   // Jump to a percentage of the book (0-100), mapping it to spine and page.
   void jumpToPercent(int percent);
   void onReaderMenuBack(uint8_t orientation);
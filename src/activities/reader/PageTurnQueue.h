@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+// Page turns the input loop has asked for and the render task hasn't drawn yet. Presses only add to a net count and
+// the render task takes all of it at once, so a burst of presses draws the page it ends on, not every page on the
+// way. Pure logic, so the host simulation can drive it too.
+class PageTurnQueue {
+ public:
+  // Stands for the last page of a section whose page count isn't known until it is loaded
+  static constexpr int LAST_PAGE = -1;
+
+  struct Target {
+    int spineIndex;
+    int page;            // LAST_PAGE when moving back into the previous spine item
+    int remainingTurns;  // Still to apply once a newly entered section is loaded
+  };
+
+  void push(const int turns) { pending.fetch_add(turns); }
+  int take() { return pending.exchange(0); }
+  int peek() const { return pending.load(); }
+  bool empty() const { return pending.load() == 0; }
+  void clear() { pending.store(0); }
+
+  // Where `turns` lead from `page` of a section with `pageCount` pages. Leaving the section stops at the first page
+  // of the next spine item or the last page of the previous one; the turns that takes are used up, the rest are
+  // returned. Turning back from the start of the book stays on its first page.
+  static Target resolve(const int spineIndex, const int page, const int pageCount, const int turns) {
+    if (turns > 0 && page + turns >= pageCount) {
+      const int used = std::max(1, pageCount - page);
+      return {spineIndex + 1, 0, turns - used};
+    }
+    if (turns < 0 && page + turns < 0) {
+      if (spineIndex == 0) {
+        return {0, 0, 0};
+      }
+      return {spineIndex - 1, LAST_PAGE, turns + page + 1};
+    }
+    return {spineIndex, page + turns, 0};
+  }
+
+ private:
+  std::atomic<int> pending{0};
+};
@@ -0,0 +1,81 @@
+#include "ProgressJournal.h"
+
+#include <HalStorage.h>
+#include <Logging.h>
+#include <StorageStats.h>
+
+#include <algorithm>
+#include <cstring>
+
+void ProgressJournal::begin(std::string path, const int spineIndex, const int page) {
+  this->path = std::move(path);
+  this->spineIndex = storedSpineIndex = spineIndex;
+  this->page = storedPage = page;
+  size = 0;
+  dirty = false;
+  sessionStats = {};
+}
+
+void ProgressJournal::record(const int spineIndex, const int page, const uint8_t* data, const size_t size,
+                             const uint16_t batteryPercent, const uint32_t nowMs) {
+  const uint32_t start = StorageStats::now();
+  const size_t kept = std::min(size, MAX_RECORD_SIZE);
+  if (!dirty && spineIndex == storedSpineIndex && page == storedPage && kept == this->size &&
+      memcmp(this->data, data, kept) == 0) {
+    // Drawn again where it already was (a settings change, a menu closing): nothing new to store
+    sessionStats.records++;
+    sessionStats.recordMicros += StorageStats::now() - start;
+    return;
+  }
+
+  memcpy(this->data, data, kept);
+  this->size = kept;
+  this->spineIndex = spineIndex;
+  this->page = page;
+  dirty = true;
+  lastRecordMs = nowMs;
+  sessionStats.records++;
+
+  const bool farBehind = spineIndex != storedSpineIndex || page > storedPage + 1 || page < storedPage - 1;
+  if (farBehind || batteryPercent <= LOW_BATTERY_PERCENT) {
+    flush();
+  }
+  sessionStats.recordMicros += StorageStats::now() - start;
+}
+
+bool ProgressJournal::flush() {
+  if (!dirty || path.empty()) {
+    return true;
+  }
+
+  StorageStats::Scope ioScope(StorageStats::Tag::Progress);
+  const uint32_t start = StorageStats::now();
+  // Overwritten in place: truncating first would leave an empty file if the power went before the write
+  FsFile file = Storage.open(path.c_str(), O_RDWR | O_CREAT);
+  bool written = false;
+  if (file) {
+    written = Storage.write(file, data, size) == size;
+    written = Storage.close(file) && written;
+  }
+  sessionStats.writes++;
+  sessionStats.writeMicros += StorageStats::now() - start;
+
+  if (!written) {
+    LOG_ERR("PRJ", "Could not save progress to %s", path.c_str());
+    return false;
+  }
+  storedSpineIndex = spineIndex;
+  storedPage = page;
+  dirty = false;
+  LOG_DBG("PRJ", "Progress saved: spine %d, page %d", spineIndex, page);
+  return true;
+}
+
+void ProgressJournal::end() {
+  flush();
+  if (sessionStats.records > 0) {
+    LOG_DBG("PRJ", "%lu page turns, %lu progress writes, %lu us per turn",
+            static_cast<unsigned long>(sessionStats.records), static_cast<unsigned long>(sessionStats.writes),
+            static_cast<unsigned long>(sessionStats.recordMicros / sessionStats.records));
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Write-behind for a reader's progress.bin. A page turn only updates the position held here. It goes to the card
+// once no page has been turned for IDLE_FLUSH_MS, when the reader moves to another chapter or more than one page
+// away from what is stored, while the battery is low, and when the reader exits (which entering sleep goes through
+// as well). An unexpected reset loses at most the page on screen.
+//
+// record() runs on the render task and due() on the input loop; the reader holds its RenderLock around flush() and
+// end() from the loop.
+class ProgressJournal {
+ public:
+  static constexpr size_t MAX_RECORD_SIZE = 8;
+  // Longer than a page takes to read, so steady reading is stored by the one-page rule, every other page, and this
+  // only catches a book put down mid-chapter
+  static constexpr uint32_t IDLE_FLUSH_MS = 120000;
+  // Below this the device may shut off by itself, so every page is written right away
+  static constexpr uint16_t LOW_BATTERY_PERCENT = 10;
+
+  struct Stats {
+    uint32_t records = 0;       // Page turns noted
+    uint32_t writes = 0;        // progress.bin writes
+    uint32_t recordMicros = 0;  // Spent in record(), including the writes it made
+    uint32_t writeMicros = 0;   // Spent writing, whoever asked
+  };
+
+  // Starts a reading session on `path`, whose record the reader has just loaded. A spine index or page of -1 stands
+  // for nothing stored yet.
+  void begin(std::string path, int spineIndex, int page);
+  // Notes the position now on screen, `data` being its progress.bin record. Writes it straight away only when
+  // leaving it pending would put the stored position more than a page behind, or the battery is low.
+  void record(int spineIndex, int page, const uint8_t* data, size_t size, uint16_t batteryPercent, uint32_t nowMs);
+  // A position is pending and no page has been turned for IDLE_FLUSH_MS
+  bool due(uint32_t nowMs) const { return dirty && nowMs - lastRecordMs >= IDLE_FLUSH_MS; }
+  bool pending() const { return dirty; }
+  // Writes the pending position, if any. On failure it stays pending for the next trigger.
+  bool flush();
+  // Flushes and logs the session's counts
+  void end();
+
+  const Stats& stats() const { return sessionStats; }
+
+ private:
+  std::string path;
+  uint8_t data[MAX_RECORD_SIZE] = {};
+  size_t size = 0;
+  int spineIndex = -1;
+  int page = -1;
+  int storedSpineIndex = -1;
+  int storedPage = -1;
+  bool dirty = false;
+  uint32_t lastRecordMs = 0;
+  Stats sessionStats;
+};
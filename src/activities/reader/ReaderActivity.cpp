@@ -1,6 +1,7 @@
 #include "ReaderActivity.h"
 
 #include <HalStorage.h>
+#include <InflateReader.h>
 
 #include "CrossPointSettings.h"
 #include "Epub.h"
@@ -121,6 +122,10 @@ void ReaderActivity::onEnter() {
   }
 
   currentBookPath = initialBookPath;
+
+  LOG_DBG("READER", "Heap at book open: %u bytes free, largest block %u bytes", ESP.getFreeHeap(),
+          ESP.getMaxAllocHeap());
+
   if (isBmpFile(initialBookPath)) {
     onGoToBmpViewer(initialBookPath);
   } else if (isXtcFile(initialBookPath)) {
@@ -138,6 +143,12 @@ void ReaderActivity::onEnter() {
     }
     onGoToTxtReader(std::move(txt));
   } else {
+    // Opening an EPUB inflates the container, OPF, TOC, every CSS file and then each chapter, each through a 32KB
+    // window. Set one aside for the whole session now, so those reads don't depend on finding 32KB in one piece every
+    // time. The other formats are read as they are stored and never inflate.
+    if (!InflateReader::reserveWindows(1)) {
+      LOG_ERR("READER", "Could not reserve inflate window, largest free block: %u bytes", ESP.getMaxAllocHeap());
+    }
     auto epub = loadEpub(initialBookPath);
     if (!epub) {
       onGoBack();
@@ -146,3 +157,8 @@ void ReaderActivity::onEnter() {
     onGoToEpubReader(std::move(epub));
   }
 }
+
+void ReaderActivity::onExit() {
+  ActivityWithSubactivity::onExit();
+  InflateReader::releaseWindows();
+}
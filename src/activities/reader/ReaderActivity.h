@@ -36,5 +36,6 @@ class ReaderActivity final : public ActivityWithSubactivity {
         onGoBack(onGoBack),
         onGoToLibrary(onGoToLibrary) {}
   void onEnter() override;
+  void onExit() override;
   bool isReaderActivity() const override { return true; }
 };
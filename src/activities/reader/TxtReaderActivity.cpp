@@ -1,9 +1,11 @@
 #include "TxtReaderActivity.h"
 
 #include <GfxRenderer.h>
+#include <HalPowerManager.h>
 #include <HalStorage.h>
 #include <I18n.h>
 #include <Serialization.h>
+#include <StorageStats.h>
 #include <Utf8.h>
 
 #include "CrossPointSettings.h"
@@ -21,7 +23,7 @@ constexpr size_t CHUNK_SIZE = 8 * 1024;  // 8KB chunk for reading
 
 // Cache file magic and version
 constexpr uint32_t CACHE_MAGIC = 0x54585449;  // "TXTI"
-constexpr uint8_t CACHE_VERSION = 2;          // Increment when cache format changes
+constexpr uint8_t CACHE_VERSION = 3;          // Increment when cache format changes
 }  // namespace
 
 void TxtReaderActivity::onEnter() {
@@ -49,6 +51,9 @@ void TxtReaderActivity::onEnter() {
       break;
   }
 
+  // Open the book on a clean panel
+  renderer.requestHalfRefresh();
+
   txt->setupCacheDir();
 
   // Save current txt as last opened file and add to recent books
@@ -64,6 +69,7 @@ void TxtReaderActivity::onEnter() {
 
 void TxtReaderActivity::onExit() {
   ActivityWithSubactivity::onExit();
+  progress.end();
 
   // Reset orientation back to portrait for the rest of the UI
   renderer.setOrientation(GfxRenderer::Orientation::Portrait);
@@ -76,6 +82,11 @@ void TxtReaderActivity::onExit() {
 }
 
 void TxtReaderActivity::loop() {
+  if (progress.due(millis())) {
+    RenderLock lock(*this);
+    progress.flush();
+  }
+
   if (subActivity) {
     subActivity->loop();
     return;
@@ -340,6 +351,7 @@ bool TxtReaderActivity::loadPageAtOffset(size_t offset, std::vector<std::string>
 }
 
 void TxtReaderActivity::render(Activity::RenderLock&&) {
+  StorageStats::Scope ioScope(StorageStats::Tag::Reader);
   if (!txt) {
     return;
   }
@@ -370,8 +382,9 @@ void TxtReaderActivity::render(Activity::RenderLock&&) {
   renderPage();
   renderer.clearFontCache();
 
-  // Save progress
-  saveProgress();
+  // Written behind, once the page has been on screen a while
+  recordProgress();
+  renderer.waitForRefresh();
 }
 
 void TxtReaderActivity::renderPage() {
@@ -425,13 +438,8 @@ void TxtReaderActivity::renderPage() {
   renderLines();
   renderStatusBar(orientedMarginRight, orientedMarginBottom, orientedMarginLeft);
 
-  if (pagesUntilFullRefresh <= 1) {
-    renderer.displayBuffer(HalDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-  } else {
-    renderer.displayBuffer();
-    pagesUntilFullRefresh--;
-  }
+  // Without anti-aliasing the refresh runs in the background while render() saves progress
+  renderer.displayAdaptive(SETTINGS.getRefreshFrequency(), SETTINGS.textAntiAliasing);
 
   // Grayscale rendering pass (for anti-aliased fonts)
   if (SETTINGS.textAntiAliasing) {
@@ -530,24 +538,22 @@ void TxtReaderActivity::renderStatusBar(const int orientedMarginRight, const int
   }
 }
 
-void TxtReaderActivity::saveProgress() const {
-  FsFile f;
-  if (Storage.openFileForWrite("TRS", txt->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
-    data[0] = currentPage & 0xFF;
-    data[1] = (currentPage >> 8) & 0xFF;
-    data[2] = 0;
-    data[3] = 0;
-    f.write(data, 4);
-    f.close();
-  }
+void TxtReaderActivity::recordProgress() {
+  uint8_t data[4];
+  data[0] = currentPage & 0xFF;
+  data[1] = (currentPage >> 8) & 0xFF;
+  data[2] = 0;
+  data[3] = 0;
+  progress.record(0, currentPage, data, sizeof(data), powerManager.getBatteryPercentage(), millis());
 }
 
 void TxtReaderActivity::loadProgress() {
   FsFile f;
+  bool loaded = false;
   if (Storage.openFileForRead("TRS", txt->getCachePath() + "/progress.bin", f)) {
     uint8_t data[4];
     if (f.read(data, 4) == 4) {
+      loaded = true;
       currentPage = data[0] + (data[1] << 8);
       if (currentPage >= totalPages) {
         currentPage = totalPages - 1;
@@ -559,6 +565,7 @@ void TxtReaderActivity::loadProgress() {
     }
     f.close();
   }
+  progress.begin(txt->getCachePath() + "/progress.bin", loaded ? 0 : -1, loaded ? currentPage : -1);
 }
 
 bool TxtReaderActivity::loadPageIndexCache() {
@@ -573,6 +580,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   // - uint8_t: paragraph alignment (to invalidate cache on alignment change)
   // - uint32_t: total pages count
   // - N * uint32_t: page offsets
+  // - serialization::Trailer over all of the above
 
   std::string cachePath = txt->getCachePath() + "/index.bin";
   FsFile f;
@@ -580,10 +588,21 @@ bool TxtReaderActivity::loadPageIndexCache() {
     LOG_DBG("TRS", "No page index cache found");
     return false;
   }
+  // All of it gets read below anyway, so the check covers the whole file
+  uint32_t sealedCrc = 0;
+  uint32_t crc = 0;
+  if (!serialization::readTrailer(f, sealedCrc) ||
+      !serialization::crc32(f, 0, f.size() - sizeof(serialization::Trailer), crc) || crc != sealedCrc ||
+      !Storage.seek(f, 0)) {
+    LOG_DBG("TRS", "Cache file is damaged, rebuilding");
+    f.close();
+    return false;
+  }
+  serialization::BufferedReader reader(f);
 
   // Read and validate header using serialization module
   uint32_t magic;
-  serialization::readPod(f, magic);
+  serialization::readPod(reader, magic);
   if (magic != CACHE_MAGIC) {
     LOG_DBG("TRS", "Cache magic mismatch, rebuilding");
     f.close();
@@ -591,7 +610,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint8_t version;
-  serialization::readPod(f, version);
+  serialization::readPod(reader, version);
   if (version != CACHE_VERSION) {
     LOG_DBG("TRS", "Cache version mismatch (%d != %d), rebuilding", version, CACHE_VERSION);
     f.close();
@@ -599,7 +618,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint32_t fileSize;
-  serialization::readPod(f, fileSize);
+  serialization::readPod(reader, fileSize);
   if (fileSize != txt->getFileSize()) {
     LOG_DBG("TRS", "Cache file size mismatch, rebuilding");
     f.close();
@@ -607,7 +626,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t cachedWidth;
-  serialization::readPod(f, cachedWidth);
+  serialization::readPod(reader, cachedWidth);
   if (cachedWidth != viewportWidth) {
     LOG_DBG("TRS", "Cache viewport width mismatch, rebuilding");
     f.close();
@@ -615,7 +634,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t cachedLines;
-  serialization::readPod(f, cachedLines);
+  serialization::readPod(reader, cachedLines);
   if (cachedLines != linesPerPage) {
     LOG_DBG("TRS", "Cache lines per page mismatch, rebuilding");
     f.close();
@@ -623,7 +642,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t fontId;
-  serialization::readPod(f, fontId);
+  serialization::readPod(reader, fontId);
   if (fontId != cachedFontId) {
     LOG_DBG("TRS", "Cache font ID mismatch (%d != %d), rebuilding", fontId, cachedFontId);
     f.close();
@@ -631,7 +650,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   int32_t margin;
-  serialization::readPod(f, margin);
+  serialization::readPod(reader, margin);
   if (margin != cachedScreenMargin) {
     LOG_DBG("TRS", "Cache screen margin mismatch, rebuilding");
     f.close();
@@ -639,7 +658,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint8_t alignment;
-  serialization::readPod(f, alignment);
+  serialization::readPod(reader, alignment);
   if (alignment != cachedParagraphAlignment) {
     LOG_DBG("TRS", "Cache paragraph alignment mismatch, rebuilding");
     f.close();
@@ -647,7 +666,12 @@ bool TxtReaderActivity::loadPageIndexCache() {
   }
 
   uint32_t numPages;
-  serialization::readPod(f, numPages);
+  serialization::readPod(reader, numPages);
+  if (numPages > reader.remaining() / sizeof(uint32_t)) {
+    LOG_DBG("TRS", "Cache page count exceeds file, rebuilding");
+    f.close();
+    return false;
+  }
 
   // Read page offsets
   pageOffsets.clear();
@@ -655,7 +679,7 @@ bool TxtReaderActivity::loadPageIndexCache() {
 
   for (uint32_t i = 0; i < numPages; i++) {
     uint32_t offset;
-    serialization::readPod(f, offset);
+    serialization::readPod(reader, offset);
     pageOffsets.push_back(offset);
   }
 
@@ -667,28 +691,38 @@ bool TxtReaderActivity::loadPageIndexCache() {
 
 void TxtReaderActivity::savePageIndexCache() const {
   std::string cachePath = txt->getCachePath() + "/index.bin";
+  std::string tmpPath = cachePath + ".tmp";
   FsFile f;
-  if (!Storage.openFileForWrite("TRS", cachePath, f)) {
+  if (!Storage.openFileForWrite("TRS", tmpPath, f)) {
     LOG_ERR("TRS", "Failed to save page index cache");
     return;
   }
+  serialization::BufferedWriter writer(f);
 
   // Write header using serialization module
-  serialization::writePod(f, CACHE_MAGIC);
-  serialization::writePod(f, CACHE_VERSION);
-  serialization::writePod(f, static_cast<uint32_t>(txt->getFileSize()));
-  serialization::writePod(f, static_cast<int32_t>(viewportWidth));
-  serialization::writePod(f, static_cast<int32_t>(linesPerPage));
-  serialization::writePod(f, static_cast<int32_t>(cachedFontId));
-  serialization::writePod(f, static_cast<int32_t>(cachedScreenMargin));
-  serialization::writePod(f, cachedParagraphAlignment);
-  serialization::writePod(f, static_cast<uint32_t>(pageOffsets.size()));
+  serialization::writePod(writer, CACHE_MAGIC);
+  serialization::writePod(writer, CACHE_VERSION);
+  serialization::writePod(writer, static_cast<uint32_t>(txt->getFileSize()));
+  serialization::writePod(writer, static_cast<int32_t>(viewportWidth));
+  serialization::writePod(writer, static_cast<int32_t>(linesPerPage));
+  serialization::writePod(writer, static_cast<int32_t>(cachedFontId));
+  serialization::writePod(writer, static_cast<int32_t>(cachedScreenMargin));
+  serialization::writePod(writer, cachedParagraphAlignment);
+  serialization::writePod(writer, static_cast<uint32_t>(pageOffsets.size()));
 
   // Write page offsets
   for (size_t offset : pageOffsets) {
-    serialization::writePod(f, static_cast<uint32_t>(offset));
+    serialization::writePod(writer, static_cast<uint32_t>(offset));
   }
 
-  f.close();
+  uint32_t crc = 0;
+  const bool sealed = writer.flush() && serialization::crc32(f, 0, writer.position(), crc) &&
+                      serialization::writeTrailer(f, crc);
+  const bool closed = f.close();
+  if (!sealed || !closed || !Storage.replace(tmpPath.c_str(), cachePath.c_str())) {
+    LOG_ERR("TRS", "Failed to write page index cache");
+    Storage.remove(tmpPath.c_str());
+    return;
+  }
   LOG_DBG("TRS", "Saved page index cache: %d pages", totalPages);
 }
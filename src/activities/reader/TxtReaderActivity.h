@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "CrossPointSettings.h"
+#include "ProgressJournal.h"
 #include "activities/ActivityWithSubactivity.h"
 
 class TxtReaderActivity final : public ActivityWithSubactivity {
@@ -12,7 +13,7 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
 
   int currentPage = 0;
   int totalPages = 1;
-  int pagesUntilFullRefresh = 0;
+  ProgressJournal progress;
 
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
@@ -37,7 +38,7 @@ class TxtReaderActivity final : public ActivityWithSubactivity {
   void buildPageIndex();
   bool loadPageIndexCache();
   void savePageIndexCache() const;
-  void saveProgress() const;
+  void recordProgress();
   void loadProgress();
 
  public:
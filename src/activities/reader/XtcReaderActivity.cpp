@@ -9,8 +9,10 @@
 
 #include <FsHelpers.h>
 #include <GfxRenderer.h>
+#include <HalPowerManager.h>
 #include <HalStorage.h>
 #include <I18n.h>
+#include <StorageStats.h>
 
 #include "CrossPointSettings.h"
 #include "CrossPointState.h"
@@ -33,6 +35,8 @@ void XtcReaderActivity::onEnter() {
   }
 
   xtc->setupCacheDir();
+  // Open the book on a clean panel
+  renderer.requestHalfRefresh();
 
   // Load saved progress
   loadProgress();
@@ -48,6 +52,7 @@ void XtcReaderActivity::onEnter() {
 
 void XtcReaderActivity::onExit() {
   ActivityWithSubactivity::onExit();
+  progress.end();
 
   APP_STATE.readerActivityLoadCount = 0;
   APP_STATE.saveToFile();
@@ -55,6 +60,11 @@ void XtcReaderActivity::onExit() {
 }
 
 void XtcReaderActivity::loop() {
+  if (progress.due(millis())) {
+    RenderLock lock(*this);
+    progress.flush();
+  }
+
   // Pass input responsibility to sub activity if exists
   if (subActivity) {
     subActivity->loop();
@@ -136,6 +146,7 @@ void XtcReaderActivity::loop() {
 }
 
 void XtcReaderActivity::render(Activity::RenderLock&&) {
+  StorageStats::Scope ioScope(StorageStats::Tag::Reader);
   if (!xtc) {
     return;
   }
@@ -150,7 +161,8 @@ void XtcReaderActivity::render(Activity::RenderLock&&) {
   }
 
   renderPage();
-  saveProgress();
+  recordProgress();
+  renderer.waitForRefresh();
 }
 
 void XtcReaderActivity::renderPage() {
@@ -242,14 +254,8 @@ void XtcReaderActivity::renderPage() {
       }
     }
 
-    // Display BW with conditional refresh based on pagesUntilFullRefresh
-    if (pagesUntilFullRefresh <= 1) {
-      renderer.displayBuffer(HalDisplay::HALF_REFRESH);
-      pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-    } else {
-      renderer.displayBuffer();
-      pagesUntilFullRefresh--;
-    }
+    // Display BW, letting the refresh scheduler pick the waveform
+    renderer.displayAdaptive(SETTINGS.getRefreshFrequency());
 
     // Pass 2: LSB buffer - mark DARK gray only (XTH value 1)
     // In LUT: 0 bit = apply gray effect, 1 bit = untouched
@@ -321,36 +327,28 @@ void XtcReaderActivity::renderPage() {
 
   // XTC pages already have status bar pre-rendered, no need to add our own
 
-  // Display with appropriate refresh
-  if (pagesUntilFullRefresh <= 1) {
-    renderer.displayBuffer(HalDisplay::HALF_REFRESH);
-    pagesUntilFullRefresh = SETTINGS.getRefreshFrequency();
-  } else {
-    renderer.displayBuffer();
-    pagesUntilFullRefresh--;
-  }
+  // Display with the refresh the scheduler picks, in the background while render() saves progress
+  renderer.displayAdaptive(SETTINGS.getRefreshFrequency(), false);
 
   LOG_DBG("XTR", "Rendered page %lu/%lu (%u-bit)", currentPage + 1, xtc->getPageCount(), bitDepth);
 }
 
-void XtcReaderActivity::saveProgress() const {
-  FsFile f;
-  if (Storage.openFileForWrite("XTR", xtc->getCachePath() + "/progress.bin", f)) {
-    uint8_t data[4];
-    data[0] = currentPage & 0xFF;
-    data[1] = (currentPage >> 8) & 0xFF;
-    data[2] = (currentPage >> 16) & 0xFF;
-    data[3] = (currentPage >> 24) & 0xFF;
-    f.write(data, 4);
-    f.close();
-  }
+void XtcReaderActivity::recordProgress() {
+  uint8_t data[4];
+  data[0] = currentPage & 0xFF;
+  data[1] = (currentPage >> 8) & 0xFF;
+  data[2] = (currentPage >> 16) & 0xFF;
+  data[3] = (currentPage >> 24) & 0xFF;
+  progress.record(0, static_cast<int>(currentPage), data, sizeof(data), powerManager.getBatteryPercentage(), millis());
 }
 
 void XtcReaderActivity::loadProgress() {
   FsFile f;
+  bool loaded = false;
   if (Storage.openFileForRead("XTR", xtc->getCachePath() + "/progress.bin", f)) {
     uint8_t data[4];
     if (f.read(data, 4) == 4) {
+      loaded = true;
       currentPage = data[0] | (data[1] << 8) | (data[2] << 16) | (data[3] << 24);
       LOG_DBG("XTR", "Loaded progress: page %lu", currentPage);
 
@@ -361,4 +359,5 @@ void XtcReaderActivity::loadProgress() {
     }
     f.close();
   }
+  progress.begin(xtc->getCachePath() + "/progress.bin", loaded ? 0 : -1, loaded ? static_cast<int>(currentPage) : -1);
 }
@@ -9,19 +9,20 @@
 
 #include <Xtc.h>
 
+#include "ProgressJournal.h"
 #include "activities/ActivityWithSubactivity.h"
 
 class XtcReaderActivity final : public ActivityWithSubactivity {
   std::shared_ptr<Xtc> xtc;
 
   uint32_t currentPage = 0;
-  int pagesUntilFullRefresh = 0;
+  ProgressJournal progress;
 
   const std::function<void()> onGoBack;
   const std::function<void()> onGoHome;
 
   void renderPage();
-  void saveProgress() const;
+  void recordProgress();
   void loadProgress();
 
  public:
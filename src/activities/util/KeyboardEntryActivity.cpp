@@ -319,5 +319,5 @@ void KeyboardEntryActivity::render(Activity::RenderLock&&) {
   // Draw side button hints for Up/Down navigation
   GUI.drawSideButtonHints(renderer, ">", "<");
 
-  renderer.displayBuffer();
+  renderer.displayChanges();
 }
@@ -269,15 +269,9 @@ void LyraTheme::drawList(const GfxRenderer& renderer, Rect rect, int itemCount,
                       scrollBarHeight, true);
   }
 
-  // Draw selection
   int contentWidth =
       rect.width -
       (totalPages > 1 ? (LyraMetrics::values.scrollBarWidth + LyraMetrics::values.scrollBarRightOffset) : 1);
-  if (selectedIndex >= 0) {
-    renderer.fillRoundedRect(LyraMetrics::values.contentSidePadding, rect.y + selectedIndex % pageItems * rowHeight,
-                             contentWidth - LyraMetrics::values.contentSidePadding * 2, rowHeight, cornerRadius,
-                             Color::LightGray);
-  }
 
   int textX = rect.x + LyraMetrics::values.contentSidePadding + hPaddingInSelection;
   int textWidth = contentWidth - LyraMetrics::values.contentSidePadding * 2 - hPaddingInSelection * 2;
@@ -295,6 +289,13 @@ void LyraTheme::drawList(const GfxRenderer& renderer, Rect rect, int itemCount,
     const int itemY = rect.y + (i % pageItems) * rowHeight;
     int rowTextWidth = textWidth;
 
+    // Each row draws its own selection highlight
+    if (i == selectedIndex) {
+      renderer.fillRoundedRect(LyraMetrics::values.contentSidePadding, itemY,
+                               contentWidth - LyraMetrics::values.contentSidePadding * 2, rowHeight, cornerRadius,
+                               Color::LightGray);
+    }
+
     // Draw name
     int valueWidth = 0;
     std::string valueText = "";
@@ -442,8 +443,8 @@ void LyraTheme::drawRecentBookCover(GfxRenderer& renderer, Rect rect, const std:
           Bitmap bitmap(file);
           if (bitmap.parseHeaders() == BmpReaderError::Ok) {
             coverWidth = bitmap.getWidth();
-            renderer.drawBitmap(bitmap, tileX + hPaddingInSelection, tileY + hPaddingInSelection, coverWidth,
-                                LyraMetrics::values.homeCoverHeight);
+            renderer.drawBitmapCached(bitmap, coverBmpPath, tileX + hPaddingInSelection, tileY + hPaddingInSelection,
+                                      coverWidth, LyraMetrics::values.homeCoverHeight);
           } else {
             hasCover = false;
           }
@@ -615,7 +616,7 @@ Rect LyraTheme::drawPopup(const GfxRenderer& renderer, const char* message) cons
   const int textX = x + (w - textWidth) / 2;
   const int textY = y + popupMarginY - 2;
   renderer.drawText(UI_12_FONT_ID, textX, textY, message, false, EpdFontFamily::REGULAR);
-  renderer.displayBuffer();
+  renderer.displayChanges();
 
   return Rect{x, y, w, h};
 }
@@ -633,7 +634,7 @@ void LyraTheme::fillPopupProgress(const GfxRenderer& renderer, const Rect& layou
 
   renderer.fillRect(barX, barY, fillWidth, barHeight, false);
 
-  renderer.displayBuffer(HalDisplay::FAST_REFRESH);
+  renderer.displayChanges(HalDisplay::FAST_REFRESH);
 }
 
 void LyraTheme::drawTextField(const GfxRenderer& renderer, Rect rect, const int textWidth) const {
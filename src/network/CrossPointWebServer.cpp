@@ -5,6 +5,7 @@
 #include <FsHelpers.h>
 #include <HalStorage.h>
 #include <Logging.h>
+#include <StorageStats.h>
 #include <WiFi.h>
 #include <esp_task_wdt.h>
 
@@ -157,6 +158,10 @@ void CrossPointWebServer::begin() {
   server->on("/api/settings", HTTP_GET, [this] { handleGetSettings(); });
   server->on("/api/settings", HTTP_POST, [this] { handlePostSettings(); });
 
+  // Storage I/O accounting endpoints
+  server->on("/api/iostats", HTTP_GET, [this] { handleGetIoStats(); });
+  server->on("/api/iostats/reset", HTTP_POST, [this] { handleResetIoStats(); });
+
   server->onNotFound([this] { handleNotFound(); });
   LOG_DBG("WEB", "[MEM] Free heap after route setup: %d bytes", ESP.getFreeHeap());
 
@@ -258,7 +263,10 @@ void CrossPointWebServer::handleClient() {
     lastDebugPrint = millis();
   }
 
-  server->handleClient();
+  {
+    StorageStats::Scope ioScope(StorageStats::Tag::WebServer);
+    server->handleClient();
+  }
 
   // Handle WebSocket events
   if (wsServer) {
@@ -1338,3 +1346,47 @@ void CrossPointWebServer::onWebSocketEvent(uint8_t num, WStype_t type, uint8_t*
       break;
   }
 }
+
+void CrossPointWebServer::handleGetIoStats() const {
+  JsonDocument doc;
+  doc["enabled"] = StorageStats::enabled;
+  doc["sinceMs"] = StorageStats::millisSinceReset();
+  JsonArray buckets = doc["bucketsUs"].to<JsonArray>();
+  for (int b = 0; b < StorageStats::BUCKET_COUNT; b++) {
+    buckets.add(StorageStats::bucketLimitMicros(b));
+  }
+
+  JsonObject tags = doc["tags"].to<JsonObject>();
+  for (int t = 0; t < StorageStats::TAG_COUNT; t++) {
+    const auto tag = static_cast<StorageStats::Tag>(t);
+    JsonObject ops;
+    for (int o = 0; o < StorageStats::OP_COUNT; o++) {
+      const auto op = static_cast<StorageStats::Op>(o);
+      const StorageStats::Counter& c = StorageStats::get(tag, op);
+      if (c.calls == 0) continue;
+
+      if (ops.isNull()) {
+        ops = tags[StorageStats::name(tag)].to<JsonObject>();
+      }
+      JsonObject entry = ops[StorageStats::name(op)].to<JsonObject>();
+      entry["calls"] = c.calls;
+      entry["bytes"] = c.bytes;
+      entry["totalUs"] = c.totalMicros;
+      entry["maxUs"] = c.maxMicros;
+      JsonArray histogram = entry["histogram"].to<JsonArray>();
+      for (const uint32_t count : c.histogram) {
+        histogram.add(count);
+      }
+    }
+  }
+
+  String json;
+  serializeJson(doc, json);
+  server->send(200, "application/json", json);
+}
+
+void CrossPointWebServer::handleResetIoStats() const {
+  StorageStats::reset();
+  LOG_DBG("WEB", "Storage I/O stats reset");
+  server->send(200, "text/plain", "IO stats reset");
+}
@@ -105,4 +105,8 @@ class CrossPointWebServer {
   void handleSettingsPage() const;
   void handleGetSettings() const;
   void handlePostSettings();
+
+  // Storage I/O accounting
+  void handleGetIoStats() const;
+  void handleResetIoStats() const;
 };
@@ -0,0 +1,195 @@
+#include <BookMetadataCache.h>
+#include <Serialization.h>
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Cuts the power at random points while book.bin is rebuilt over a good one, then opens the book the way Epub::load
+// does: load the cache and build it again when that fails. Whatever the cut left on the card, the book has to open
+// with either the old or the new contents exactly, after at most one rebuild. Also damages sealed files (flipped
+// bytes in the parts the trailer covers, truncation, appended bytes) and checks load() turns every one of them down.
+
+namespace {
+
+const std::string CACHE_DIR = "/.crosspoint/epub_fault";
+const std::string BOOK_BIN = CACHE_DIR + "/book.bin";
+constexpr int CUTS = 3000;
+constexpr int TAIL_CUTS = 64;  // Also cut at every one of the last units: sealing, closing and the rename
+constexpr int DAMAGES = 1000;
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+struct Book {
+  BookMetadataCache::BookMetadata metadata;
+  std::vector<std::string> spine;
+  std::vector<std::string> toc;
+};
+
+Book makeBook(const char* title, const int chapters, const int tocEntries) {
+  Book book;
+  book.metadata = {title, "An Author", "en", "images/cover.jpg", "text/ch0.xhtml"};
+  for (int i = 0; i < chapters; i++) {
+    book.spine.push_back("text/" + std::string(title) + std::to_string(i) + ".xhtml");
+  }
+  for (int i = 0; i < tocEntries; i++) book.toc.push_back(book.spine[i * chapters / tocEntries]);
+  return book;
+}
+
+// Everything load() hands back, flattened for comparison; empty when it turns the cache down
+std::string snapshot() {
+  BookMetadataCache cache(CACHE_DIR);
+  if (!cache.load()) return "";
+  const auto& m = cache.coreMetadata;
+  std::string s = m.title + "|" + m.author + "|" + m.language + "|" + m.coverItemHref + "|" + m.textReferenceHref;
+  for (int i = 0; i < cache.getSpineCount(); i++) {
+    const auto e = cache.getSpineEntry(i);
+    s += "|" + e.href + ":" + std::to_string(e.cumulativeSize) + ":" + std::to_string(e.tocIndex);
+  }
+  for (int i = 0; i < cache.getTocCount(); i++) {
+    const auto e = cache.getTocEntry(i);
+    s += "|" + e.title + ":" + e.href + ":" + std::to_string(e.level) + ":" + std::to_string(e.spineIndex);
+  }
+  return s;
+}
+
+// The build steps of Epub::load, giving up at the first failure like it does
+bool build(const Book& book) {
+  BookMetadataCache cache(CACHE_DIR);
+  if (!cache.beginWrite() || !cache.beginContentOpfPass()) return false;
+  for (const auto& href : book.spine) cache.createSpineEntry(href);
+  if (!cache.endContentOpfPass() || !cache.beginTocPass()) return false;
+  for (const auto& href : book.toc) cache.createTocEntry("Chapter " + href, href, "", 1);
+  if (!cache.endTocPass() || !cache.endWrite() || !cache.buildBookBin("book.epub", "", book.metadata)) return false;
+  cache.cleanupTmpFiles();
+  return true;
+}
+
+// Opening the book after a reset: the cache as it is, or rebuilt once
+std::string open(const Book& book, bool& rebuilt) {
+  std::string s = snapshot();
+  rebuilt = s.empty();
+  if (rebuilt) {
+    check(build(book), "rebuild after a reset");
+    s = snapshot();
+  }
+  return s;
+}
+
+// Deep copy, so a trial's writes don't reach the saved state
+std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> copyFiles() {
+  std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+  for (const auto& [path, data] : Storage.card.files) files[path] = std::make_shared<std::vector<uint8_t>>(*data);
+  return files;
+}
+
+void crcKnownAnswer() {
+  const char digits[] = "123456789";
+  check(serialization::crc32(0, digits, 9) == 0xCBF43926, "CRC-32 check value");
+  check(serialization::crc32(serialization::crc32(0, digits, 4), digits + 4, 5) == 0xCBF43926, "CRC-32 continued");
+}
+
+}  // namespace
+
+int main() {
+  crcKnownAnswer();
+
+  const Book oldBook = makeBook("Old", 60, 25);
+  const Book newBook = makeBook("New", 90, 40);
+  check(build(oldBook), "build old book.bin");
+  const std::string oldContents = snapshot();
+  const auto oldFiles = copyFiles();
+
+  const uint64_t before = Storage.card.spent;
+  check(build(newBook), "build new book.bin");
+  const uint64_t buildUnits = Storage.card.spent - before;
+  const std::string newContents = snapshot();
+  check(!oldContents.empty() && !newContents.empty() && oldContents != newContents, "clean builds load");
+
+  // Power cuts while the new book.bin replaces the old one
+  std::mt19937 rng(7);
+  int keptOld = 0, gotNew = 0, rebuilds = 0, partialTmp = 0;
+  for (int i = 0; i < CUTS + TAIL_CUTS; i++) {
+    Storage.card.files = oldFiles;
+    for (auto& [path, data] : Storage.card.files) data = std::make_shared<std::vector<uint8_t>>(*data);
+    Storage.card.budget = i < CUTS ? rng() % (buildUnits + 1) : buildUnits - (i - CUTS);
+    build(newBook);
+    Storage.card.reboot();
+    if (Storage.card.files.count(BOOK_BIN + ".tmp")) partialTmp++;
+
+    bool rebuilt = false;
+    const std::string contents = open(newBook, rebuilt);
+    if (rebuilt) {
+      rebuilds++;
+      check(contents == newContents, "rebuilt cache matches a clean build");
+    } else if (contents == oldContents) {
+      keptOld++;
+    } else if (contents == newContents) {
+      gotNew++;
+    } else {
+      check(false, "a cut left a cache that loads with the wrong contents");
+    }
+  }
+
+  // Damage to a sealed book.bin
+  Storage.card.files.clear();
+  check(build(newBook), "build book.bin to damage");
+  const std::vector<uint8_t> sealed = *Storage.card.files[BOOK_BIN];
+  uint32_t lutOffset;
+  uint16_t spineCount, tocCount;
+  memcpy(&lutOffset, sealed.data() + 1, sizeof(lutOffset));
+  memcpy(&spineCount, sealed.data() + 5, sizeof(spineCount));
+  memcpy(&tocCount, sealed.data() + 7, sizeof(tocCount));
+  const size_t lutEnd = lutOffset + sizeof(uint32_t) * (spineCount + tocCount);
+  const size_t trailerStart = sealed.size() - sizeof(serialization::Trailer);
+
+  int refused = 0;
+  for (int i = 0; i < DAMAGES; i++) {
+    auto damaged = sealed;
+    switch (i % 3) {
+      case 0: {
+        // One byte of the header, metadata, LUTs or trailer
+        const size_t covered = lutEnd + sizeof(serialization::Trailer);
+        size_t at = rng() % covered;
+        if (at >= lutEnd) at = trailerStart + at - lutEnd;
+        damaged[at] ^= 1 + rng() % 255;
+        break;
+      }
+      case 1:
+        damaged.resize(rng() % sealed.size());
+        break;
+      default:
+        damaged.resize(sealed.size() + 1 + rng() % 600, static_cast<uint8_t>(rng()));
+        break;
+    }
+    *Storage.card.files[BOOK_BIN] = damaged;
+    bool rebuilt = false;
+    const std::string contents = open(newBook, rebuilt);
+    if (rebuilt) refused++;
+    check(contents == newContents, "damaged cache recovers after one rebuild");
+  }
+  check(refused == DAMAGES, "every damaged book.bin is refused");
+
+  printf("book.bin rebuild: %llu units (bytes written plus file operations)\n",
+         static_cast<unsigned long long>(buildUnits));
+  printf("power cut at %d random units and each of the last %d, then the book opened:\n", CUTS, TAIL_CUTS);
+  printf("  opened with the old cache:  %5d\n", keptOld);
+  printf("  opened with the new cache:  %5d\n", gotNew);
+  printf("  rebuilt once:               %5d\n", rebuilds);
+  printf("  book.bin.tmp left behind:   %5d (before, book.bin itself was written in place)\n", partialTmp);
+  printf("damaged sealed book.bin: %d of %d refused\n", refused, DAMAGES);
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Host stand-in for the HAL, picked up ahead of the real HalStorage.h: an in-memory card that can lose power part way
+// through a build. Every byte written and every create, remove and rename spends one unit of a budget; once it runs
+// out, the write in progress lands only as far as the budget reached and every later operation fails, as if the
+// device had reset. Reads are free. A rename is modelled as atomic. Handles have the device's modes: openFileForRead
+// is read-only, openFileForWrite read-write (sealing reads back what it wrote) and truncates the file in place.
+
+class Card {
+ public:
+  std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+  int64_t budget = -1;  // Units left before the power goes; -1 for no limit
+  uint64_t spent = 0;
+  bool powered = true;
+
+  // How many of `units` go through before the power goes
+  size_t spend(const size_t units) {
+    if (!powered) return 0;
+    size_t allowed = units;
+    if (budget >= 0 && static_cast<int64_t>(units) > budget) {
+      allowed = budget;
+      powered = false;
+    }
+    if (budget >= 0) budget -= allowed;
+    spent += allowed;
+    return allowed;
+  }
+  bool spendOne() { return spend(1) == 1; }
+
+  // Power back on, files as the cut left them
+  void reboot() {
+    budget = -1;
+    powered = true;
+  }
+};
+
+class FsFile {
+ public:
+  FsFile() = default;
+  FsFile(Card* card, std::shared_ptr<std::vector<uint8_t>> data, const bool writable)
+      : card(card), data(std::move(data)), writable(writable) {}
+
+  int read(void* buf, const size_t count) {
+    if (!card->powered) return -1;
+    const size_t n = pos < data->size() ? std::min(count, data->size() - pos) : 0;
+    memcpy(buf, data->data() + pos, n);
+    pos += n;
+    return static_cast<int>(n);
+  }
+
+  size_t write(const void* buf, const size_t count) {
+    if (!writable) return 0;
+    const size_t n = card->spend(count);
+    if (pos + n > data->size()) data->resize(pos + n);
+    memcpy(data->data() + pos, buf, n);
+    pos += n;
+    return n;
+  }
+
+  bool seek(const uint64_t p) {
+    if (!card->powered || p > data->size()) return false;
+    pos = p;
+    return true;
+  }
+
+  bool close() {
+    const bool ok = data && card->powered;
+    data.reset();
+    return ok;
+  }
+
+  uint64_t position() const { return pos; }
+  uint64_t size() const { return data->size(); }
+  explicit operator bool() const { return data != nullptr; }
+
+ private:
+  Card* card = nullptr;
+  std::shared_ptr<std::vector<uint8_t>> data;
+  bool writable = false;
+  size_t pos = 0;
+};
+
+// The parts of the real HalStorage the cache code uses, on top of the card model
+class HalStorage {
+ public:
+  Card card;
+
+  bool openFileForRead(const char*, const std::string& path, FsFile& file) {
+    const auto it = card.files.find(path);
+    if (!card.powered || it == card.files.end()) return false;
+    file = FsFile(&card, it->second, false);
+    return true;
+  }
+  bool openFileForWrite(const char*, const std::string& path, FsFile& file) {
+    if (!card.spendOne()) return false;
+    auto& data = card.files[path];
+    if (data) {
+      data->clear();
+    } else {
+      data = std::make_shared<std::vector<uint8_t>>();
+    }
+    file = FsFile(&card, data, true);
+    return true;
+  }
+  bool exists(const char* path) { return card.powered && card.files.count(path) > 0; }
+  bool remove(const char* path) {
+    if (!exists(path) || !card.spendOne()) return false;
+    card.files.erase(path);
+    return true;
+  }
+  bool rename(const char* oldPath, const char* newPath) {
+    if (!exists(oldPath) || exists(newPath) || !card.spendOne()) return false;
+    card.files[newPath] = card.files[oldPath];
+    card.files.erase(oldPath);
+    return true;
+  }
+  bool replace(const char* tmpPath, const char* path) {
+    if (exists(path) && !remove(path)) {
+      return false;
+    }
+    return rename(tmpPath, path);
+  }
+
+  int read(FsFile& file, void* buffer, const size_t count) { return file.read(buffer, count); }
+  size_t write(FsFile& file, const void* buffer, const size_t count) { return file.write(buffer, count); }
+  bool seek(FsFile& file, const uint64_t position) { return file.seek(position); }
+
+  static HalStorage& getInstance() {
+    static HalStorage instance;
+    return instance;
+  }
+};
+
+#define Storage HalStorage::getInstance()
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdio>
+
+// Host stand-in for the firmware logger: quiet, but the arguments still count as used
+#define LOG_ERR(tag, ...)        \
+  do {                           \
+    if (false) printf(__VA_ARGS__); \
+  } while (0)
+#define LOG_DBG(tag, ...)        \
+  do {                           \
+    if (false) printf(__VA_ARGS__); \
+  } while (0)
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Host stand-in for ZipFile, picked up ahead of the real one: book.bin only asks it for the inflated size of each
+// spine item, which here is derived from the item's name
+class ZipFile {
+ public:
+  struct SizeTarget {
+    uint64_t hash;
+    uint16_t len;
+    uint16_t index;
+  };
+
+  static uint64_t fnvHash64(const char* s, const size_t len) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < len; i++) {
+      hash ^= static_cast<uint8_t>(s[i]);
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  static size_t itemSize(const std::string& name) { return 1000 + fnvHash64(name.data(), name.size()) % 50000; }
+
+  explicit ZipFile(const std::string&, std::string = "") {}
+
+  bool open() { return true; }
+  bool close() { return true; }
+  bool getInflatedFileSize(const char* filename, size_t* size) {
+    *size = itemSize(filename);
+    return true;
+  }
+  int fillUncompressedSizes(std::vector<SizeTarget>&, std::vector<uint32_t>&) { return 0; }
+};
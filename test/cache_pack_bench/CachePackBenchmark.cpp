@@ -0,0 +1,287 @@
+#include <Epub/CachePack.h>
+
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+// Models the SD card sector traffic of a book's image cache, once as loose files in the cache directory (the old
+// img_<spine>_<n>.<ext> and .pxc layout) and once in a CachePack, for a book with hundreds of images: extracting
+// them while building sections, finding them again when pages are drawn, and clearing the cache. Also checks that
+// the pack hands back what was written across replacements, compaction (at book open, never on a lookup), aborted
+// writes and a torn tail.
+
+SectorIo Card::io;
+
+namespace {
+
+constexpr int CHAPTERS = 40;
+constexpr int IMAGES_PER_CHAPTER = 10;
+const std::string LOOSE_DIR = "/.crosspoint/epub_loose";
+const std::string PACK_DIR = "/.crosspoint/epub_pack";
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+struct CacheFile {
+  std::string name;
+  std::vector<uint8_t> data;
+};
+
+// Every extracted image followed by its pixel cache, in the order a full book build writes them
+std::vector<CacheFile> makeFiles(const int generation) {
+  std::mt19937 rng(11 + generation);
+  std::vector<CacheFile> files;
+  for (int spine = 0; spine < CHAPTERS; spine++) {
+    for (int n = 0; n < IMAGES_PER_CHAPTER; n++) {
+      const std::string base = "img_" + std::to_string(spine) + "_" + std::to_string(n);
+      CacheFile image{base + ((spine + n) % 3 ? ".jpg" : ".png"), std::vector<uint8_t>(5000 + rng() % 55000)};
+      CacheFile pixels{base + ".pxc", std::vector<uint8_t>(8000 + rng() % 32000)};
+      for (auto& b : image.data) b = rng();
+      for (auto& b : pixels.data) b = rng();
+      files.push_back(std::move(image));
+      files.push_back(std::move(pixels));
+    }
+  }
+  return files;
+}
+
+// The few files that sit in every book's cache directory ahead of the images
+void makeBookFiles(const std::string& dir) {
+  for (const char* name : {"book.bin", "css_rules.cache", "progress.bin", "thumb_240.bmp"}) {
+    FsFile f;
+    Storage.openFileForWrite("BCH", dir + "/" + name, f);
+    const std::vector<uint8_t> data(4000);
+    f.write(data.data(), data.size());
+    f.close();
+  }
+}
+
+SectorIo measure(const std::function<void()>& fn) {
+  const SectorIo before = Card::io;
+  fn();
+  const SectorIo& after = Card::io;
+  SectorIo d;
+  d.dirReads = after.dirReads - before.dirReads;
+  d.dirWrites = after.dirWrites - before.dirWrites;
+  d.fatReads = after.fatReads - before.fatReads;
+  d.fatWrites = after.fatWrites - before.fatWrites;
+  d.dataReads = after.dataReads - before.dataReads;
+  d.dataWrites = after.dataWrites - before.dataWrites;
+  return d;
+}
+
+struct Row {
+  const char* name;
+  size_t ops;
+  SectorIo loose;
+  SectorIo pack;
+};
+
+void printRow(const Row& r) {
+  const double loose = static_cast<double>(r.loose.total()) / r.ops;
+  const double pack = static_cast<double>(r.pack.total()) / r.ops;
+  printf("%-34s %6zu %8zu %8zu %10.1f %10.1f %7.1fx\n", r.name, r.ops, r.loose.dirReads + r.loose.dirWrites,
+         r.loose.fatReads + r.loose.fatWrites, loose, pack, pack > 0 ? loose / pack : 0.0);
+}
+
+bool writeEntry(const std::string& path, const std::vector<uint8_t>& data) {
+  CachePack::Writer w;
+  if (!CachePack::beginEntry(path, w)) return false;
+  // Like readItemContentsToStream, in 4 KiB chunks
+  for (size_t off = 0; off < data.size(); off += 4096) {
+    w.write(data.data() + off, std::min<size_t>(4096, data.size() - off));
+  }
+  return w.commit();
+}
+
+bool entryMatches(const std::string& path, const std::vector<uint8_t>& data) {
+  CachePack::Entry e;
+  if (!CachePack::openEntry(path, e)) return false;
+  std::vector<uint8_t> got(data.size() + 1);
+  const int n = e.read(got.data(), got.size());
+  e.close();
+  return n == static_cast<int>(data.size()) && memcmp(got.data(), data.data(), data.size()) == 0;
+}
+
+uint64_t packSize(const std::string& dir) { return Storage.card.files[dir + "/images.pack"]->data.size(); }
+
+uint64_t slack(const std::string& dir) {
+  uint64_t wasted = 0;
+  for (const auto& name : Storage.card.dirs[dir]) {
+    const auto& file = Storage.card.files[dir + "/" + name];
+    wasted += static_cast<uint64_t>(file->clusters) * CLUSTER_SIZE - file->data.size();
+  }
+  return wasted;
+}
+
+void packEdgeCases() {
+  const std::string dir = "/.crosspoint/epub_edge";
+  std::vector<uint8_t> a(3000, 'a'), b(7000, 'b'), c(100, 'c');
+
+  check(writeEntry(dir + "/img_0_0.jpg", a), "write entry");
+  check(writeEntry(dir + "/img_0_1.jpg", c), "write second entry");
+  check(writeEntry(dir + "/img_0_0.jpg", b), "replace entry");
+  check(entryMatches(dir + "/img_0_0.jpg", b), "replaced entry reads the new data");
+  check(entryMatches(dir + "/img_0_1.jpg", c), "neighbour survives replacement");
+  check(!CachePack::exists(dir + "/img_9_9.jpg"), "missing entry");
+
+  CachePack::Entry e;
+  check(CachePack::openEntry(dir + "/img_0_0.jpg", e), "open for seek");
+  uint8_t byte = 0;
+  check(e.seek(6999) && e.read(&byte, 4) == 1 && byte == 'b', "read stops at the entry end");
+  check(!e.seek(7001), "seek past the entry end");
+  e.close();
+
+  // An entry that is never committed leaves nothing behind
+  const uint64_t before = packSize(dir);
+  {
+    CachePack::Writer w;
+    check(CachePack::beginEntry(dir + "/img_0_2.jpg", w), "begin aborted entry");
+    w.write(a.data(), a.size());
+  }
+  check(packSize(dir) == before && !CachePack::exists(dir + "/img_0_2.jpg"), "uncommitted entry dropped");
+
+  // A record cut off mid-write is dropped on the next load; the ones before it stay
+  {
+    auto& data = Storage.card.files[dir + "/images.pack"]->data;
+    const uint8_t torn[] = {0xff, 0xff, 0xff, 0xff, 0, 0, 0, 0, 11, 0, 0, 0, 'i', 'm', 'g'};
+    data.insert(data.end(), torn, torn + sizeof(torn));
+  }
+  CachePack::release(dir);
+  check(entryMatches(dir + "/img_0_0.jpg", b) && entryMatches(dir + "/img_0_1.jpg", c), "entries before torn tail");
+  check(packSize(dir) == before, "torn tail truncated");
+
+  // A replacement committed but cut off before retiring the original: both are live, the later one wins
+  const std::vector<uint8_t> d(500, 'd');
+  check(writeEntry(dir + "/img_0_1.jpg", d), "replace second entry");
+  {
+    auto& data = Storage.card.files[dir + "/images.pack"]->data;
+    const uint32_t original = 4 + 12 + 11 + a.size();  // After the magic and the first img_0_0.jpg
+    const uint32_t live = 0x4556494C;
+    memcpy(data.data() + original, &live, sizeof(live));
+  }
+  CachePack::release(dir);
+  check(entryMatches(dir + "/img_0_1.jpg", d) && entryMatches(dir + "/img_0_0.jpg", b), "duplicate live records");
+  CachePack::release(dir);
+}
+
+}  // namespace
+
+int main() {
+  packEdgeCases();
+
+  const auto files = makeFiles(0);
+  std::vector<Row> rows;
+  makeBookFiles(LOOSE_DIR);
+  makeBookFiles(PACK_DIR);
+
+  Row build{"extract image or pixel cache", files.size(), {}, {}};
+  build.loose = measure([&] {
+    for (const auto& f : files) {
+      FsFile out;
+      Storage.openFileForWrite("BCH", LOOSE_DIR + "/" + f.name, out);
+      out.write(f.data.data(), f.data.size());
+      out.close();
+    }
+  });
+  build.pack = measure([&] {
+    for (const auto& f : files) check(writeEntry(PACK_DIR + "/" + f.name, f.data), "pack build");
+  });
+  rows.push_back(build);
+
+  // Drawing a page with an image opens its pixel cache (the image itself only on a cache miss)
+  std::mt19937 rng(5);
+  std::vector<size_t> order;
+  for (size_t i = 1; i < files.size(); i += 2) order.push_back(i);
+  std::shuffle(order.begin(), order.end(), rng);
+
+  const auto openPixels = [&](const std::string& dir, const size_t i, const bool pack) {
+    uint16_t size[2];
+    if (pack) {
+      CachePack::Entry e;
+      check(CachePack::openEntry(dir + "/" + files[i].name, e) && e.read(size, 4) == 4, "pack lookup");
+      e.close();
+    } else {
+      FsFile f;
+      check(Storage.openFileForRead("BCH", dir + "/" + files[i].name, f) && f.read(size, 4) == 4, "loose lookup");
+      f.close();
+    }
+  };
+
+  CachePack::release(PACK_DIR);
+  Row first{"first image after opening the book", 1, {}, {}};
+  first.loose = measure([&] { openPixels(LOOSE_DIR, order[0], false); });
+  first.pack = measure([&] { openPixels(PACK_DIR, order[0], true); });
+  rows.push_back(first);
+
+  Row lookup{"image lookup while reading", order.size(), {}, {}};
+  lookup.loose = measure([&] {
+    for (const size_t i : order) openPixels(LOOSE_DIR, i, false);
+  });
+  lookup.pack = measure([&] {
+    for (const size_t i : order) openPixels(PACK_DIR, i, true);
+  });
+  rows.push_back(lookup);
+
+  bool allMatch = true;
+  for (const auto& f : files) allMatch = allMatch && entryMatches(PACK_DIR + "/" + f.name, f.data);
+  check(allMatch, "every pack entry reads back what was written");
+
+  // Worst case for compaction: every entry rewritten twice, so all live records sit behind dead ones. Section
+  // rebuilds only rewrite pixel caches (images already in the pack aren't extracted again).
+  const uint64_t builtSize = packSize(PACK_DIR);
+  std::vector<CacheFile> latest;
+  for (int generation = 1; generation <= 2; generation++) {
+    latest = makeFiles(generation);
+    for (const auto& f : latest) check(writeEntry(PACK_DIR + "/" + f.name, f.data), "pack rebuild");
+  }
+  CachePack::release(PACK_DIR);
+  const uint64_t deadSize = packSize(PACK_DIR);
+  check(CachePack::exists(PACK_DIR + "/" + latest[0].name) && packSize(PACK_DIR) == deadSize,
+        "an entry lookup doesn't compact");
+  CachePack::release(PACK_DIR);
+
+  // A compaction cut short leaves its temporary file behind and the pack as it was
+  FsFile leftover;
+  Storage.openFileForWrite("BCH", PACK_DIR + "/images.pack.tmp", leftover);
+  leftover.write(latest[0].data.data(), 1000);
+  leftover.close();
+  Row compact{"open book, 2/3 dead (compacts)", 1, {}, {}};
+  compact.pack = measure([&] { CachePack::open(PACK_DIR); });
+  check(!Storage.exists((PACK_DIR + "/images.pack.tmp").c_str()), "no temporary file left after compaction");
+  allMatch = true;
+  for (const auto& f : latest) allMatch = allMatch && entryMatches(PACK_DIR + "/" + f.name, f.data);
+  check(allMatch, "compacted pack reads back the latest entries");
+  check(packSize(PACK_DIR) < builtSize * 11 / 10, "compaction reclaims dead records");
+
+  const uint64_t looseSlack = slack(LOOSE_DIR);
+  const uint64_t packSlack = slack(PACK_DIR);
+
+  Row clear{"clear book cache", 1, {}, {}};
+  clear.loose = measure([&] { Storage.removeDir(LOOSE_DIR.c_str()); });
+  clear.pack = measure([&] {
+    CachePack::release(PACK_DIR);
+    Storage.removeDir(PACK_DIR.c_str());
+  });
+  rows.push_back(clear);
+
+  printf("%d images and pixel caches, %zu files in the loose cache directory\n", CHAPTERS * IMAGES_PER_CHAPTER,
+         files.size() + 4);
+  printf("%-34s %6s %8s %8s %10s %10s %8s\n", "", "ops", "dir", "fat", "loose/op", "pack/op", "fewer");
+  for (const auto& r : rows) printRow(r);
+  printf("%-34s %6d %8s %8s %10s %10.1f\n", compact.name, 1, "", "", "", static_cast<double>(compact.pack.total()));
+  printf("(sector I/Os in the FAT model; dir and fat are the loose layout's directory and FAT sectors)\n");
+  printf("cluster slack: loose %llu KiB, pack %llu KiB\n", static_cast<unsigned long long>(looseSlack / 1024),
+         static_cast<unsigned long long>(packSlack / 1024));
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Host stand-in for the HAL, picked up ahead of the real HalStorage.h: an in-memory card that models the sector
+// traffic FAT32 would cause. Directories are a flat list of entries in creation order, scanned linearly on every
+// open; long names take one 32-byte entry per 13 characters plus the short entry. Files are chains of 32 KiB
+// clusters; seeking walks the chain through the FAT, from the start when going backwards. Handles have the device's
+// modes: openFileForRead is read-only, openFileForWrite read-write (sealing reads back what it wrote) and truncates
+// the file in place.
+
+constexpr uint32_t SECTOR_SIZE = 512;
+constexpr uint32_t CLUSTER_SIZE = 32 * 1024;
+constexpr uint32_t FAT_ENTRIES_PER_SECTOR = SECTOR_SIZE / 4;
+constexpr int FAT_COPIES = 2;
+
+struct SectorIo {
+  size_t dirReads = 0;
+  size_t dirWrites = 0;
+  size_t fatReads = 0;
+  size_t fatWrites = 0;
+  size_t dataReads = 0;
+  size_t dataWrites = 0;
+
+  size_t total() const { return dirReads + dirWrites + fatReads + fatWrites + dataReads + dataWrites; }
+};
+
+class Print {
+ public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size) = 0;
+};
+
+typedef int oflag_t;
+#define O_RDONLY 0
+#define O_RDWR 2
+#define O_CREAT 0x100
+#define O_TRUNC 0x200
+
+struct CardFile {
+  std::vector<uint8_t> data;
+  uint32_t clusters = 0;
+};
+
+class Card {
+ public:
+  static SectorIo io;
+
+  std::map<std::string, std::shared_ptr<CardFile>> files;
+  std::map<std::string, std::vector<std::string>> dirs;  // Directory -> entry names in creation order
+
+  static uint32_t dirEntries(const std::string& name) { return 1 + (name.size() + 12) / 13; }
+  static uint32_t sectorsFor(const uint32_t entries) { return (entries * 32 + SECTOR_SIZE - 1) / SECTOR_SIZE; }
+
+  static void split(const std::string& path, std::string& dir, std::string& name) {
+    const size_t slash = path.find_last_of('/');
+    dir = path.substr(0, slash);
+    name = path.substr(slash + 1);
+  }
+
+  // Scans the directory up to `name`, or all of it when it isn't there
+  bool lookup(const std::string& path) {
+    std::string dir, name;
+    split(path, dir, name);
+    uint32_t entries = 0;
+    for (const auto& n : dirs[dir]) {
+      entries += dirEntries(n);
+      if (n == name) {
+        io.dirReads += sectorsFor(entries);
+        return true;
+      }
+    }
+    io.dirReads += std::max<uint32_t>(1, sectorsFor(entries));
+    return false;
+  }
+
+  std::shared_ptr<CardFile> create(const std::string& path) {
+    std::string dir, name;
+    split(path, dir, name);
+    dirs[dir].push_back(name);
+    io.dirWrites++;
+    return files[path] = std::make_shared<CardFile>();
+  }
+
+  // Within one directory: the entry is rewritten under its new name
+  bool rename(const std::string& from, const std::string& to) {
+    std::string dir, name, toDir, toName;
+    split(from, dir, name);
+    split(to, toDir, toName);
+    auto& entries = dirs[dir];
+    const auto it = std::find(entries.begin(), entries.end(), name);
+    if (it == entries.end()) return false;
+    *it = toName;
+    io.dirWrites++;
+    files[to] = files[from];
+    files.erase(from);
+    return true;
+  }
+
+  void free(const std::string& path) {
+    std::string dir, name;
+    split(path, dir, name);
+    auto& entries = dirs[dir];
+    entries.erase(std::find(entries.begin(), entries.end(), name));
+    io.dirWrites++;
+    const auto& file = files[path];
+    io.fatWrites += FAT_COPIES * std::max<uint32_t>(1, (file->clusters + FAT_ENTRIES_PER_SECTOR - 1) /
+                                                             FAT_ENTRIES_PER_SECTOR);
+    files.erase(path);
+  }
+};
+
+class FsFile {
+ public:
+  FsFile() = default;
+  FsFile(std::shared_ptr<CardFile> file, const bool writable) : file(std::move(file)), writable(writable) {}
+
+  int read(void* buf, const size_t count) {
+    const size_t n = pos < file->data.size() ? std::min(count, file->data.size() - pos) : 0;
+    Card::io.dataReads += sectorsSpanned(n);
+    memcpy(buf, file->data.data() + pos, n);
+    pos += n;
+    return static_cast<int>(n);
+  }
+
+  size_t write(const void* buf, const size_t count) {
+    if (!writable) return 0;
+    Card::io.dataWrites += sectorsSpanned(count);
+    if (pos + count > file->data.size()) {
+      file->data.resize(pos + count);
+      const uint32_t clusters = (file->data.size() + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+      Card::io.fatWrites += FAT_COPIES * (clusters - file->clusters);
+      file->clusters = clusters;
+    }
+    memcpy(file->data.data() + pos, buf, count);
+    pos += count;
+    return count;
+  }
+
+  bool seek(const uint64_t p) {
+    if (p > file->data.size()) return false;
+    const uint32_t from = pos / CLUSTER_SIZE / FAT_ENTRIES_PER_SECTOR;
+    const uint32_t to = p / CLUSTER_SIZE / FAT_ENTRIES_PER_SECTOR;
+    Card::io.fatReads += p >= pos ? to - from : to + 1;
+    pos = p;
+    return true;
+  }
+
+  bool truncate(const uint64_t length) {
+    file->data.resize(length);
+    const uint32_t clusters = (length + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    if (clusters < file->clusters) Card::io.fatWrites += FAT_COPIES;
+    file->clusters = clusters;
+    pos = std::min<size_t>(pos, length);
+    return true;
+  }
+
+  bool close() {
+    if (file) Card::io.dirWrites++;  // Size and date in the directory entry
+    file.reset();
+    return true;
+  }
+
+  uint64_t position() const { return pos; }
+  uint64_t size() const { return file->data.size(); }
+  explicit operator bool() const { return file != nullptr; }
+
+ private:
+  std::shared_ptr<CardFile> file;
+  bool writable = false;
+  size_t pos = 0;
+
+  size_t sectorsSpanned(const size_t n) const { return n == 0 ? 0 : (pos + n - 1) / SECTOR_SIZE - pos / SECTOR_SIZE + 1; }
+};
+
+// The parts of the real HalStorage the cache code uses, on top of the card model
+class HalStorage {
+ public:
+  Card card;
+
+  FsFile open(const char* path, const oflag_t oflag = O_RDONLY) {
+    const bool writable = (oflag & O_RDWR) != 0;
+    if (card.lookup(path)) {
+      FsFile f(card.files[path], writable);
+      if (oflag & O_TRUNC) f.truncate(0);
+      return f;
+    }
+    return (oflag & O_CREAT) ? FsFile(card.create(path), writable) : FsFile();
+  }
+  bool openFileForRead(const char*, const std::string& path, FsFile& file) {
+    file = open(path.c_str());
+    return static_cast<bool>(file);
+  }
+  bool openFileForWrite(const char*, const std::string& path, FsFile& file) {
+    file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+    return static_cast<bool>(file);
+  }
+  bool exists(const char* path) { return card.lookup(path); }
+  bool remove(const char* path) {
+    if (!card.lookup(path)) return false;
+    card.free(path);
+    return true;
+  }
+  bool replace(const char* tmpPath, const char* path) {
+    if (card.lookup(path)) card.free(path);
+    return card.lookup(tmpPath) && card.rename(tmpPath, path);
+  }
+  // Deletes every file under `dir`, one directory scan and free each
+  bool removeDir(const char* dir) {
+    std::vector<std::string> paths;
+    for (const auto& name : card.dirs[dir]) paths.push_back(std::string(dir) + "/" + name);
+    for (const auto& path : paths) remove(path.c_str());
+    return true;
+  }
+
+  int read(FsFile& file, void* buffer, const size_t count) { return file.read(buffer, count); }
+  size_t write(FsFile& file, const void* buffer, const size_t count) { return file.write(buffer, count); }
+  bool seek(FsFile& file, const uint64_t position) { return file.seek(position); }
+  bool close(FsFile& file) { return file.close(); }
+
+  static HalStorage& getInstance() {
+    static HalStorage instance;
+    return instance;
+  }
+};
+
+#define Storage HalStorage::getInstance()
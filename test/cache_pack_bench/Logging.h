@@ -0,0 +1,5 @@
+#pragma once
+
+// Host stand-in for the firmware logger: the bench only prints its own results
+#define LOG_ERR(tag, ...) ((void)0)
+#define LOG_DBG(tag, ...) ((void)0)
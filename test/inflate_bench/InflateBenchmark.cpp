@@ -0,0 +1,207 @@
+#include <InflateReader.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "builtinFonts/bookerly_14_regular.h"
+#include "builtinFonts/notosans_12_regular.h"
+
+// Inflates every deflated entry of the given EPUBs (the test EPUBs by default) and every group of two bundled
+// compressed fonts through InflateReader, once with uzlib's bitwise Huffman decoding and once with the lookup tables.
+// EPUB entries go through the streaming mode the way ZipFile feeds it, fonts through the one-shot mode the way
+// FontDecompressor does. Outputs are checked against the ZIP CRC-32s and against each other. Throughput is host
+// throughput: it shows the ratio between the two, not what the ESP32-C3 reaches.
+
+namespace {
+
+constexpr size_t READ_CHUNK = 4096;  // readFileToStream chunk size used for spine items
+constexpr int ROUNDS = 20;
+
+struct Stream {
+  std::string name;
+  std::vector<uint8_t> compressed;
+  uint32_t uncompressedSize;
+  uint32_t crc;  // 0 for font groups
+};
+
+uint32_t crc32(const uint8_t* data, const size_t len) {
+  static uint32_t table[256];
+  if (table[1] == 0) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+  }
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < len; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+uint32_t le32(const uint8_t* p) { return p[0] | p[1] << 8 | p[2] << 16 | static_cast<uint32_t>(p[3]) << 24; }
+uint16_t le16(const uint8_t* p) { return p[0] | p[1] << 8; }
+
+bool loadEpub(const std::string& path, std::vector<Stream>& out) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  std::vector<uint8_t> zip;
+  uint8_t buf[65536];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) zip.insert(zip.end(), buf, buf + n);
+  fclose(f);
+
+  size_t eocd = zip.size() >= 22 ? zip.size() - 22 : 0;
+  while (eocd > 0 && le32(&zip[eocd]) != 0x06054b50) eocd--;
+  if (le32(&zip[eocd]) != 0x06054b50) return false;
+
+  size_t pos = le32(&zip[eocd + 16]);
+  for (uint16_t i = le16(&zip[eocd + 10]); i > 0; i--) {
+    const uint8_t* e = &zip[pos];
+    const uint16_t nameLen = le16(e + 28);
+    const uint32_t localHeader = le32(e + 42);
+    if (le16(e + 10) == 8) {
+      const uint8_t* lh = &zip[localHeader];
+      const size_t dataOffset = localHeader + 30 + le16(lh + 26) + le16(lh + 28);
+      const uint32_t compressedSize = le32(e + 20);
+      out.push_back({path.substr(path.rfind('/') + 1) + ":" + std::string(reinterpret_cast<const char*>(e + 46), nameLen),
+                     std::vector<uint8_t>(zip.begin() + dataOffset, zip.begin() + dataOffset + compressedSize),
+                     le32(e + 24), le32(e + 16)});
+    }
+    pos += 46 + nameLen + le16(e + 30) + le16(e + 32);
+  }
+  return true;
+}
+
+void loadFont(const char* name, const EpdFontData& font, std::vector<Stream>& out) {
+  for (uint16_t i = 0; i < font.groupCount; i++) {
+    const EpdFontGroup& g = font.groups[i];
+    out.push_back({std::string(name) + " group " + std::to_string(i),
+                   std::vector<uint8_t>(font.bitmap + g.compressedOffset, font.bitmap + g.compressedOffset + g.compressedSize),
+                   g.uncompressedSize, 0});
+  }
+}
+
+// Feeds the compressed data in READ_CHUNK pieces, like ZipFile's read callback
+struct StreamCtx {
+  InflateReader reader;  // Must be first — callback casts uzlib_uncomp* to StreamCtx*
+  const Stream* stream = nullptr;
+  size_t fed = 0;
+};
+
+int streamReadCallback(uzlib_uncomp* uncomp) {
+  auto* ctx = reinterpret_cast<StreamCtx*>(uncomp);
+  const size_t remaining = ctx->stream->compressed.size() - ctx->fed;
+  if (remaining == 0) return -1;
+  const size_t n = remaining < READ_CHUNK ? remaining : READ_CHUNK;
+  const uint8_t* chunk = ctx->stream->compressed.data() + ctx->fed;
+  ctx->fed += n;
+  uncomp->source = chunk + 1;
+  uncomp->source_limit = chunk + n;
+  return chunk[0];
+}
+
+bool inflateStreaming(const Stream& s, const bool tables, std::vector<uint8_t>& out) {
+  StreamCtx ctx;
+  ctx.stream = &s;
+  if (!ctx.reader.init(true)) return false;
+  if (!tables) uzlib_uncompress_set_fast_tables(ctx.reader.raw(), nullptr);
+  ctx.reader.setReadCallback(streamReadCallback);
+
+  out.resize(s.uncompressedSize);
+  size_t total = 0;
+  uint8_t chunk[READ_CHUNK];
+  while (true) {
+    size_t produced;
+    const InflateStatus status = ctx.reader.readAtMost(chunk, sizeof(chunk), &produced);
+    if (total + produced > out.size()) return false;
+    memcpy(out.data() + total, chunk, produced);
+    total += produced;
+    if (status == InflateStatus::Done) return total == out.size();
+    if (status == InflateStatus::Error) return false;
+  }
+}
+
+bool inflateOneShot(InflateReader& reader, const Stream& s, const bool tables, std::vector<uint8_t>& out) {
+  reader.init(false);
+  if (!tables) uzlib_uncompress_set_fast_tables(reader.raw(), nullptr);
+  reader.setSource(s.compressed.data(), s.compressed.size());
+  out.resize(s.uncompressedSize);
+  return reader.read(out.data(), out.size());
+}
+
+struct Corpus {
+  const char* name;
+  std::vector<Stream> streams;
+  bool streaming;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::string> epubs;
+  for (int i = 1; i < argc; i++) epubs.emplace_back(argv[i]);
+  if (epubs.empty()) {
+    for (const char* name : {"test_jpeg_images", "test_mixed_images", "test_png_images", "test_tables"}) {
+      epubs.push_back(std::string(TEST_EPUB_DIR "/") + name + ".epub");
+    }
+  }
+
+  Corpus corpora[2] = {{"EPUB entries (streaming)", {}, true}, {"font groups (one-shot)", {}, false}};
+  for (const auto& path : epubs) {
+    if (!loadEpub(path, corpora[0].streams)) {
+      printf("Could not read %s\n", path.c_str());
+      return 1;
+    }
+  }
+  loadFont("bookerly_14_regular", bookerly_14_regular, corpora[1].streams);
+  loadFont("notosans_12_regular", notosans_12_regular, corpora[1].streams);
+
+  int failures = 0;
+  printf("%-26s %7s %10s %12s %12s %8s\n", "corpus", "streams", "bytes out", "bitwise MB/s", "tables MB/s", "speedup");
+  for (const auto& corpus : corpora) {
+    size_t bytesOut = 0;
+    for (const auto& s : corpus.streams) bytesOut += s.uncompressedSize;
+
+    double mbPerSec[2];
+    std::vector<uint8_t> out[2];
+    InflateReader oneShot;
+    for (int tables = 0; tables < 2; tables++) {
+      const auto start = std::chrono::steady_clock::now();
+      for (int round = 0; round < ROUNDS; round++) {
+        for (const auto& s : corpus.streams) {
+          const bool ok = corpus.streaming ? inflateStreaming(s, tables, out[tables])
+                                           : inflateOneShot(oneShot, s, tables, out[tables]);
+          if (round > 0) continue;
+          if (!ok || (s.crc != 0 && crc32(out[tables].data(), out[tables].size()) != s.crc)) {
+            printf("  %s: %s output is wrong\n", s.name.c_str(), tables ? "table" : "bitwise");
+            failures++;
+          }
+        }
+      }
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      mbPerSec[tables] = bytesOut * ROUNDS / seconds / 1e6;
+    }
+    // Font groups carry no checksum; both decoders have to agree on every group
+    if (!corpus.streaming) {
+      std::vector<uint8_t> bitwise, table;
+      for (const auto& s : corpus.streams) {
+        inflateOneShot(oneShot, s, false, bitwise);
+        inflateOneShot(oneShot, s, true, table);
+        if (bitwise != table) {
+          printf("  %s: decoders disagree\n", s.name.c_str());
+          failures++;
+        }
+      }
+    }
+    printf("%-26s %7zu %10zu %12.1f %12.1f %7.2fx\n", corpus.name, corpus.streams.size(), bytesOut, mbPerSec[0],
+           mbPerSec[1], mbPerSec[1] / mbPerSec[0]);
+  }
+
+  printf("\nRAM per reader: %zu bytes InflateReader + %zu bytes lookup tables (+ %d bytes ring buffer when streaming)\n",
+         sizeof(InflateReader), UZLIB_FAST_TABLES_LEN * sizeof(unsigned short), 32768);
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,289 @@
+#include <InflateReader.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+// Replays opening and reading 20 books against a first-fit model of a 200KB and a 230KB device heap, once with every
+// streamed entry allocating its own inflate window and once with InflateReader::reserveWindows() holding one for each
+// book, as ReaderActivity does. Every malloc InflateReader and the replay make is served from the model while it is
+// on. A book streams the container, OPF, TOC, its CSS files, the cover and four chapters, each leaving some blocks
+// behind, and a few blocks outlive the book. Reports the window allocations that failed, and the largest free block
+// after the 20 books, averaged over 100 seeds and for the worst seed. The fit policy is a stand-in for the ESP32's;
+// the trend is what carries over, not the exact bytes.
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void __libc_free(void*);
+extern "C" void* __libc_realloc(void*, size_t);
+
+namespace {
+
+constexpr size_t MAX_ARENA = 230 * 1024;
+constexpr int BOOKS = 20;
+constexpr int SEEDS = 100;
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+// First-fit heap over a fixed arena: 8-byte headers, 16-byte granules, neighbours coalesced on free
+struct BlockHeader {
+  uint32_t size;  // Including the header
+  uint32_t used;
+};
+
+alignas(16) uint8_t arena[MAX_ARENA];
+size_t arenaSize = MAX_ARENA;
+bool arenaOn = false;
+
+bool inArena(const void* p) { return p >= arena && p < arena + MAX_ARENA; }
+
+BlockHeader* blockAt(const size_t offset) { return reinterpret_cast<BlockHeader*>(arena + offset); }
+
+void arenaReset(const size_t size) {
+  arenaSize = size;
+  blockAt(0)->size = size;
+  blockAt(0)->used = 0;
+}
+
+void* arenaAlloc(const size_t n) {
+  const size_t need = (n + sizeof(BlockHeader) + 15) & ~static_cast<size_t>(15);
+  for (size_t offset = 0; offset < arenaSize; offset += blockAt(offset)->size) {
+    BlockHeader* block = blockAt(offset);
+    if (block->used || block->size < need) continue;
+    if (block->size - need >= 32) {
+      BlockHeader* rest = blockAt(offset + need);
+      rest->size = block->size - need;
+      rest->used = 0;
+      block->size = need;
+    }
+    block->used = 1;
+    return block + 1;
+  }
+  return nullptr;
+}
+
+void arenaFree(void* p) {
+  (static_cast<BlockHeader*>(p) - 1)->used = 0;
+  for (size_t offset = 0; offset < arenaSize; offset += blockAt(offset)->size) {
+    BlockHeader* block = blockAt(offset);
+    while (!block->used && offset + block->size < arenaSize && !blockAt(offset + block->size)->used) {
+      block->size += blockAt(offset + block->size)->size;
+    }
+  }
+}
+
+size_t largestFree(size_t* total = nullptr) {
+  size_t largest = 0, sum = 0;
+  for (size_t offset = 0; offset < arenaSize; offset += blockAt(offset)->size) {
+    const BlockHeader* block = blockAt(offset);
+    if (block->used) continue;
+    largest = std::max(largest, block->size - sizeof(BlockHeader));
+    sum += block->size - sizeof(BlockHeader);
+  }
+  if (total) *total = sum;
+  return largest;
+}
+
+// Blocks the replay holds, kept outside the model so bookkeeping doesn't allocate from it
+struct Held {
+  void* blocks[1024];
+  int count = 0;
+
+  void add(void* p) {
+    if (p) blocks[count++] = p;
+  }
+  void freeAt(const int i) {
+    free(blocks[i]);
+    memmove(blocks + i, blocks + i + 1, (count - i - 1) * sizeof(void*));
+    count--;
+  }
+  void freeAll() {
+    for (int i = 0; i < count; i++) free(blocks[i]);
+    count = 0;
+  }
+};
+
+struct Replay {
+  std::mt19937 rng;
+  bool reserved;
+  int windowFailures = 0;   // Streamed entries that couldn't get a window: the read, and the book open, fail
+  int reserveFailures = 0;  // Book opens that couldn't reserve one
+  Held longLived;           // Survives closing the book: UI, settings, font cache, recent books
+
+  Replay(const bool reserved, const unsigned seed) : rng(seed), reserved(reserved) {}
+
+  size_t between(const size_t lo, const size_t hi) { return lo + rng() % (hi - lo + 1); }
+
+  // One streamed entry: read buffer and inflater, while the consumer allocates `churn` small blocks and keeps some
+  void stream(Held& keep, const int churn, const int keepEvery) {
+    void* readBuffer = malloc(1024);
+    InflateReader reader;
+    if (!reader.init(true)) windowFailures++;
+    Held scratch;
+    for (int i = 0; i < churn; i++) {
+      void* p = malloc(between(16, 300));
+      if (i % keepEvery == 0) {
+        keep.add(p);
+      } else {
+        scratch.add(p);
+      }
+    }
+    reader.deinit();
+    free(readBuffer);
+    scratch.freeAll();
+  }
+
+  void book() {
+    if (reserved && !InflateReader::reserveWindows(1)) reserveFailures++;
+    Held bookData;
+    bookData.add(malloc(400));  // Epub
+    stream(bookData, 10, 100);  // container.xml
+    stream(bookData, 200, 3);   // OPF: manifest and spine strings
+    stream(bookData, 80, 4);    // NCX or nav
+    for (int css = between(1, 6); css > 0; css--) stream(bookData, 60, 6);
+    void* cover = malloc(between(10000, 30000));
+    stream(bookData, 5, 100);
+    free(cover);
+
+    // A few chapters: the section build streams the chapter, then pages are read
+    for (int chapter = 0; chapter < 4; chapter++) {
+      Held section;
+      section.add(malloc(between(2000, 6000)));
+      stream(section, 200, 8);
+      for (int i = 0; i < 6; i++) {
+        void* p = malloc(between(200, 3000));
+        if (rng() % 8 == 0) {
+          longLived.add(p);
+        } else {
+          section.add(p);
+        }
+      }
+      section.freeAll();
+    }
+
+    // Recent books entry, thumbnails, font cache growth
+    for (int i = 0; i < 3; i++) longLived.add(malloc(between(64, 1500)));
+    while (longLived.count > 60) longLived.freeAt(20 + rng() % (longLived.count - 20));
+    bookData.freeAll();
+    if (reserved) InflateReader::releaseWindows();
+  }
+};
+
+struct Result {
+  double windowFailures = 0;
+  double reserveFailures = 0;
+  double largest = 0;  // Largest free block after the books
+  double totalFree = 0;
+  size_t worstLargest = SIZE_MAX;
+};
+
+Result run(const size_t heap, const bool reserved) {
+  Result result;
+  for (unsigned seed = 1; seed <= SEEDS; seed++) {
+    arenaReset(heap);
+    arenaOn = true;
+    Replay replay(reserved, seed);
+    for (int i = 0; i < 20; i++) replay.longLived.add(malloc(replay.between(100, 4000)));  // Boot
+    for (int b = 0; b < BOOKS; b++) replay.book();
+    size_t total;
+    const size_t largest = largestFree(&total);
+    arenaOn = false;
+    result.windowFailures += replay.windowFailures;
+    result.reserveFailures += replay.reserveFailures;
+    result.largest += largest;
+    result.totalFree += total;
+    result.worstLargest = std::min(result.worstLargest, largest);
+  }
+  result.windowFailures /= SEEDS;
+  result.reserveFailures /= SEEDS;
+  result.largest /= SEEDS;
+  result.totalFree /= SEEDS;
+  return result;
+}
+
+// Releasing the pool while a reader holds its window frees that window once the reader gives it back
+void releaseWhileCheckedOut() {
+  arenaReset(MAX_ARENA);
+  arenaOn = true;
+  size_t empty, reservedFree, heldFree, releasedFree, returnedFree;
+  largestFree(&empty);
+  const bool reservedOk = InflateReader::reserveWindows(1);
+  largestFree(&reservedFree);
+  {
+    InflateReader reader;
+    reader.init(true);
+    largestFree(&heldFree);
+    InflateReader::releaseWindows();
+    largestFree(&releasedFree);
+    reader.deinit();
+    largestFree(&returnedFree);
+  }
+  const bool reserveAgain = InflateReader::reserveWindows(1);
+  InflateReader::releaseWindows();
+  size_t finalFree;
+  largestFree(&finalFree);
+  arenaOn = false;
+
+  check(reservedOk && reservedFree < empty, "a window is reserved");
+  check(heldFree == reservedFree, "a streaming reader takes the reserved window instead of allocating");
+  check(releasedFree == heldFree, "releasing the pool leaves a checked-out window with its reader");
+  check(returnedFree == empty, "the window is freed when its reader gives it back");
+  check(reserveAgain && finalFree == empty, "the pool can be reserved and released again afterwards");
+}
+
+}  // namespace
+
+// Every allocation while the model is on, from InflateReader as much as from the replay, comes out of the arena
+extern "C" void* malloc(const size_t n) { return arenaOn ? arenaAlloc(n) : __libc_malloc(n); }
+extern "C" void free(void* p) {
+  if (!p) return;
+  if (inArena(p)) {
+    arenaFree(p);
+  } else {
+    __libc_free(p);
+  }
+}
+extern "C" void* calloc(const size_t count, const size_t size) {
+  void* p = malloc(count * size);
+  if (p) memset(p, 0, count * size);
+  return p;
+}
+extern "C" void* realloc(void* p, const size_t n) {
+  if (!p) return malloc(n);
+  if (!inArena(p)) return __libc_realloc(p, n);
+  void* q = malloc(n);
+  if (!q) return nullptr;
+  const size_t old = (static_cast<BlockHeader*>(p) - 1)->size - sizeof(BlockHeader);
+  memcpy(q, p, std::min(old, n));
+  free(p);
+  return q;
+}
+
+int main() {
+  releaseWhileCheckedOut();
+
+  printf("%d book opens per run, %d seeds: window per streamed entry -> reserved for each book\n", BOOKS, SEEDS);
+  for (const size_t heap : {size_t{200 * 1024}, size_t{230 * 1024}}) {
+    const Result perEntry = run(heap, false);
+    const Result reserved = run(heap, true);
+    check(reserved.windowFailures == 0, "with a reserved window, no streamed entry fails");
+    printf("  %zuKB first-fit heap\n", heap / 1024);
+    printf("    window allocations failing   %7.2f -> %7.2f  (reservations failing %.2f)\n", perEntry.windowFailures,
+           reserved.windowFailures, reserved.reserveFailures);
+    printf("    largest free block after     %7.0f -> %7.0f  (worst seed %zu -> %zu)\n", perEntry.largest,
+           reserved.largest, perEntry.worstLargest, reserved.worstLargest);
+    printf("    total free after             %7.0f -> %7.0f\n", perEntry.totalFree, reserved.totalFree);
+  }
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "PageTurnQueue.h"
+
+// Replays bursts of page-button presses against a model of the EPUB reader's input loop and render task, once with
+// the old handling (loop() moves the page itself and takes the render lock to change chapters) and once with turns
+// queued in PageTurnQueue and applied by the render task. Reports panel frames against requested turns, and whether
+// the burst ends on the page it asked for. Durations are estimates for the X4, not measurements.
+
+namespace {
+
+constexpr int DRAW_MS = 110;            // Load and rasterize a page
+constexpr int FAST_REFRESH_MS = 420;    // Render task waits for it before the next render
+constexpr int GRAY_PLANE_MS = 60;       // Each grayscale plane
+constexpr int GRAY_REFRESH_MS = 380;    // Grayscale waveform
+constexpr int SECTION_BUILD_MS = 1800;  // Index a chapter that has no cache yet
+constexpr int BUILD_POLL_MS = 100;      // How often a build polls for cancellation (one parse buffer)
+
+struct Book {
+  std::vector<int> pageCounts;
+  std::vector<bool> built;
+  bool isImagePage(const int spine, const int page) const { return spine == 2 && page % 4 == 1; }
+};
+
+struct Press {
+  int at;
+  int turn;  // +1 next, -1 previous
+};
+
+struct Position {
+  int spine;
+  int page;
+  bool operator==(const Position& o) const { return spine == o.spine && page == o.page; }
+};
+
+struct Result {
+  int frames = 0;        // Refreshes sent to the panel
+  int pagesDrawn = 0;    // Pages rasterized
+  int builds = 0;        // Section builds started
+  int settledAt = 0;     // When the last refresh finished
+  Position shown{0, 0};  // Page on the panel at the end
+};
+
+// What the presses should lead to, one at a time with page counts known
+Position expectedTarget(const Book& book, Position pos, const std::vector<Press>& presses) {
+  for (const auto& press : presses) {
+    const auto t = PageTurnQueue::resolve(pos.spine, pos.page, book.pageCounts[pos.spine], press.turn);
+    pos = {t.spineIndex, t.page == PageTurnQueue::LAST_PAGE ? book.pageCounts[t.spineIndex] - 1 : t.page};
+  }
+  return pos;
+}
+
+class Model {
+ public:
+  Model(Book book, const Position start, const bool queued, const bool antiAliasing)
+      : book(std::move(book)), queued(queued), antiAliasing(antiAliasing), spine(start.spine), page(start.page) {
+    sectionPages = this->book.pageCounts[spine];
+  }
+
+  Result run(const std::vector<Press>& presses) {
+    pending.assign(presses.begin(), presses.end());
+    while (true) {
+      // Idle: wait for the next press
+      if (!notified) {
+        if (pending.empty()) break;
+        now = std::max(now, pending.front().at);
+        deliverInput(now);
+        continue;
+      }
+      // The render task takes every notification at once and renders the state as it is then
+      notified = false;
+      rendering = true;
+      render();
+      rendering = false;
+      // Presses that waited for the render lock run now, in order
+      while (!blocked.empty()) {
+        const Press press = blocked.front();
+        blocked.pop_front();
+        handlePress(press);
+      }
+      if (pending.empty() && !notified) break;
+    }
+    result.shown = shown;
+    return result;
+  }
+
+ private:
+  Book book;
+  const bool queued;
+  const bool antiAliasing;
+  int now = 0;
+  std::deque<Press> pending;
+  std::deque<Press> blocked;  // Old model: presses stuck behind the render lock
+  bool notified = false;
+  bool rendering = false;
+  // Reader state
+  int spine;
+  int page;
+  bool sectionExists = true;  // The Section object, created when its build starts
+  bool sectionLoaded = true;
+  int sectionPages = 0;  // Zero while a section is being built, like Section::pageCount
+  int nextPage = 0;      // Page to open once the section is loaded, -1 = last
+  PageTurnQueue turns;
+  Position shown{-1, -1};
+  Result result;
+
+  // The input loop runs alongside the render task
+  void deliverInput(const int until) {
+    while (!pending.empty() && pending.front().at <= until) {
+      const Press press = pending.front();
+      pending.pop_front();
+      if (!blocked.empty()) {
+        blocked.push_back(press);  // Loop is stuck; later presses queue behind it
+      } else {
+        handlePress(press);
+      }
+    }
+  }
+
+  void handlePress(const Press& press) {
+    if (queued) {
+      turns.push(press.turn);
+      notified = true;
+      return;
+    }
+    // Old loop(): move within the section, or take the render lock and change chapters. Without a section the
+    // press only asks for a render; while one is being built it has no pages yet, so any turn changes chapters.
+    if (!sectionExists) {
+      notified = true;
+      return;
+    }
+    const int pages = sectionLoaded ? sectionPages : 0;
+    if (press.turn > 0 ? page < pages - 1 : page > 0) {
+      page += press.turn;
+      notified = true;
+      return;
+    }
+    if (press.turn < 0 && spine == 0) {
+      notified = true;
+      return;
+    }
+    if (rendering) {
+      blocked.push_back(press);
+      return;
+    }
+    spine = std::min<int>(spine + press.turn, book.pageCounts.size() - 1);
+    nextPage = press.turn > 0 ? 0 : -1;
+    sectionExists = false;
+    sectionLoaded = false;
+    notified = true;
+  }
+
+  // Advances the clock while input keeps arriving. Returns false if `cancel` fired at one of the polls.
+  template <typename Cancel>
+  bool spend(const int ms, const int pollEvery, Cancel cancel) {
+    const int end = now + ms;
+    while (now < end) {
+      now = std::min(end, now + pollEvery);
+      deliverInput(now);
+      if (cancel()) return false;
+    }
+    return true;
+  }
+  void spend(const int ms) { spend(ms, ms, [] { return false; }); }
+
+  bool superseded() const { return queued && !turns.empty(); }
+
+  void refresh(const int ms) {
+    spend(ms);
+    result.frames++;
+  }
+
+  void render() {
+    if (!sectionLoaded) {
+      sectionExists = true;
+      if (!book.built[spine]) {
+        result.builds++;
+        sectionPages = 0;
+        const bool atStart = nextPage == 0;
+        const auto turnedAway = [&] { return queued && (atStart ? turns.peek() < 0 : turns.peek() > 0); };
+        if (!spend(SECTION_BUILD_MS, BUILD_POLL_MS, turnedAway)) {
+          applyTurns(0, 1, turns.take());
+          return;
+        }
+        book.built[spine] = true;
+      }
+      sectionLoaded = true;
+      sectionPages = book.pageCounts[spine];
+      page = nextPage < 0 ? sectionPages - 1 : nextPage;
+    }
+    if (queued) {
+      if (const int t = turns.take(); t != 0 && !applyTurns(page, sectionPages, t)) {
+        return;
+      }
+    }
+
+    const Position target{spine, page};
+    spend(DRAW_MS);
+    result.pagesDrawn++;
+    if (book.isImagePage(spine, page) && antiAliasing) {
+      refresh(FAST_REFRESH_MS);
+      shown = target;
+      if (superseded()) {
+        return;
+      }
+      spend(DRAW_MS);
+      refresh(FAST_REFRESH_MS);
+    } else {
+      refresh(FAST_REFRESH_MS);
+    }
+    shown = target;
+    result.settledAt = now;
+    if (antiAliasing) {
+      spend(GRAY_PLANE_MS);
+      if (superseded()) {
+        return;
+      }
+      spend(GRAY_PLANE_MS);
+      refresh(GRAY_REFRESH_MS);
+      result.settledAt = now;
+    }
+  }
+
+  bool applyTurns(const int fromPage, const int pageCount, const int t) {
+    const auto target = PageTurnQueue::resolve(spine, fromPage, pageCount, t);
+    if (target.spineIndex == spine) {
+      page = target.page;
+      return true;
+    }
+    spine = target.spineIndex;
+    nextPage = target.page == PageTurnQueue::LAST_PAGE ? -1 : target.page;
+    sectionExists = false;
+    sectionLoaded = false;
+    turns.push(target.remainingTurns);
+    notified = true;
+    return false;
+  }
+};
+
+std::vector<Press> burst(const int start, const int count, const int gapMs, const int turn) {
+  std::vector<Press> presses;
+  for (int i = 0; i < count; i++) presses.push_back({start + i * gapMs, turn});
+  return presses;
+}
+
+std::vector<Press> concat(std::vector<Press> a, const std::vector<Press>& b) {
+  a.insert(a.end(), b.begin(), b.end());
+  return a;
+}
+
+struct Scenario {
+  std::string name;
+  Position start;
+  std::vector<Press> presses;
+  bool antiAliasing;
+};
+
+}  // namespace
+
+int main() {
+  Book book;
+  book.pageCounts = {4, 30, 16, 22, 12};
+  book.built = {true, true, true, false, true};
+
+  const std::vector<Scenario> scenarios = {
+      {"10 x next, 80ms apart", {1, 5}, burst(0, 10, 80, 1), false},
+      {"10 x next, 80ms apart, AA", {1, 5}, burst(0, 10, 80, 1), true},
+      {"6 x next across an image chapter, AA", {1, 27}, burst(0, 6, 120, 1), true},
+      {"5 x next into an unbuilt chapter", {2, 13}, burst(0, 5, 150, 1), false},
+      {"next into unbuilt chapter, then back x2", {2, 15}, concat(burst(0, 1, 0, 1), burst(400, 2, 150, -1)), false},
+      {"20 x previous, 60ms apart, AA", {2, 4}, burst(0, 20, 60, -1), true},
+  };
+
+  int failures = 0;
+  printf("%-42s %8s | %-34s | %-34s\n", "scenario", "requests", "old: frames/drawn/builds, settled",
+         "queued: frames/drawn/builds, settled");
+  for (const auto& sc : scenarios) {
+    const Position expected = expectedTarget(book, sc.start, sc.presses);
+    Result r[2];
+    for (int q = 0; q < 2; q++) {
+      Model model(book, sc.start, q == 1, sc.antiAliasing);
+      r[q] = model.run(sc.presses);
+    }
+    char oldCol[64], newCol[64];
+    snprintf(oldCol, sizeof(oldCol), "%2d/%2d/%d %5dms %s", r[0].frames, r[0].pagesDrawn, r[0].builds, r[0].settledAt,
+             r[0].shown == expected ? "ok" : "WRONG PAGE");
+    snprintf(newCol, sizeof(newCol), "%2d/%2d/%d %5dms %s", r[1].frames, r[1].pagesDrawn, r[1].builds, r[1].settledAt,
+             r[1].shown == expected ? "ok" : "WRONG PAGE");
+    printf("%-42s %8zu | %-34s | %-34s\n", sc.name.c_str(), sc.presses.size(), oldCol, newCol);
+    if (!(r[1].shown == expected)) {
+      printf("  queued model ended on %d:%d, expected %d:%d\n", r[1].shown.spine, r[1].shown.page, expected.spine,
+             expected.page);
+      failures++;
+    }
+  }
+
+  // PageTurnQueue::resolve edge cases
+  const auto check = [&](const char* what, const PageTurnQueue::Target t, const int spine, const int page,
+                         const int remaining) {
+    if (t.spineIndex != spine || t.page != page || t.remainingTurns != remaining) {
+      printf("resolve %s: got %d:%d (+%d), expected %d:%d (+%d)\n", what, t.spineIndex, t.page, t.remainingTurns,
+             spine, page, remaining);
+      failures++;
+    }
+  };
+  check("within section", PageTurnQueue::resolve(2, 3, 10, 4), 2, 7, 0);
+  check("onto last page", PageTurnQueue::resolve(2, 3, 10, 6), 2, 9, 0);
+  check("into next section", PageTurnQueue::resolve(2, 3, 10, 9), 3, 0, 2);
+  check("out of an empty section", PageTurnQueue::resolve(2, 0, 0, 1), 3, 0, 0);
+  check("back into previous section", PageTurnQueue::resolve(2, 1, 10, -4), 1, PageTurnQueue::LAST_PAGE, -2);
+  check("back from start of book", PageTurnQueue::resolve(0, 1, 10, -5), 0, 0, 0);
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
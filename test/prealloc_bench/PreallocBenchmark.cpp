@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Builds a book's section files on a model of a fragmented FAT32 card, once growing each file cluster by cluster
+// (what SdFat does for plain appends) and once reserving a contiguous run first like Section::createSectionFile,
+// then loads pages from the finished files the way Section::loadPage does. Counts FAT sector traffic, data
+// commands (one per contiguous run touched) and estimates time from them. Durations are estimates for an SPI SD
+// card on the X4, not measurements.
+
+namespace {
+
+constexpr uint32_t SECTOR_SIZE = 512;
+constexpr uint32_t CLUSTER_SIZE = 32 * 1024;
+constexpr uint32_t FAT_ENTRIES_PER_SECTOR = SECTOR_SIZE / 4;
+constexpr uint32_t CLUSTERS = 128 * 1024;  // A 4 GiB slice of the card
+constexpr uint32_t FREE = 0;
+constexpr uint32_t END_OF_CHAIN = 0x0FFFFFFF;
+
+// Per SD command and per sector moved
+constexpr int COMMAND_US = 400;
+constexpr int SECTOR_READ_US = 110;
+constexpr int SECTOR_WRITE_US = 150;
+// Cards program sequential writes fastest; a write that jumps elsewhere pays for a new allocation unit
+constexpr int WRITE_JUMP_US = 2000;
+
+constexpr int CHAPTERS = 40;
+constexpr double SECTION_RATIO = 2.4;  // Section file size over XHTML size
+constexpr uint32_t RESERVE_RATIO = 3;  // Section.cpp SECTION_BYTES_PER_HTML_BYTE
+constexpr int PAGE_BYTES = 3000;
+
+struct Io {
+  long fatReads = 0;
+  long fatWrites = 0;
+  long commands = 0;
+  long sectorsRead = 0;
+  long sectorsWritten = 0;
+  long writeJumps = 0;
+
+  long micros() const {
+    return (fatReads + fatWrites + commands) * COMMAND_US + (fatReads + sectorsRead) * SECTOR_READ_US +
+           (fatWrites * 2 + sectorsWritten) * SECTOR_WRITE_US + writeJumps * WRITE_JUMP_US;
+  }
+};
+
+struct File {
+  std::vector<uint32_t> chain;
+  uint32_t size = 0;
+  uint32_t written = 0;
+  bool contiguous = false;
+};
+
+class Volume {
+ public:
+  Io io;
+
+  Volume() : fat(CLUSTERS, FREE) {}
+
+  // Fills most of the card with files, then deletes about half of them: free space ends up in short scattered runs
+  void fragment(std::mt19937& rng) {
+    std::vector<File> files;
+    while (used < CLUSTERS * 8 / 10) {
+      File f;
+      const uint32_t clusters = 1 + rng() % 6;
+      for (uint32_t i = 0; i < clusters; i++) extend(f);
+      files.push_back(f);
+    }
+    for (auto& f : files) {
+      if (rng() % 2) release(f);
+    }
+    io = Io{};
+    cachedFatSector = UINT32_MAX;
+    searchStart = 2;
+  }
+
+  // Appends one cluster, searching onwards from the last allocation like SdFat
+  void extend(File& f) {
+    uint32_t c = searchStart;
+    while (fat[c] != FREE) {
+      c = c + 1 < CLUSTERS ? c + 1 : 2;
+    }
+    searchStart = c;
+    touchFat(c, true);
+    fat[c] = END_OF_CHAIN;
+    if (!f.chain.empty()) {
+      touchFat(f.chain.back(), true);
+      fat[f.chain.back()] = c;
+    }
+    f.chain.push_back(c);
+    used++;
+  }
+
+  // SdFat's allocContiguous: scan the FAT onwards from the last allocation, wrapping once, for a free run
+  bool reserve(File& f, const uint32_t bytes) {
+    const uint32_t need = (bytes + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    uint32_t runStart = 0, runLength = 0;
+    for (uint32_t i = 0; i < CLUSTERS - 2; i++) {
+      const uint32_t c = 2 + (searchStart - 2 + i) % (CLUSTERS - 2);
+      if (c == 2) runLength = 0;  // Runs don't wrap around the end of the FAT
+      touchFat(c, false);
+      runLength = fat[c] == FREE ? runLength + 1 : 0;
+      if (runLength == 1) runStart = c;
+      if (runLength == need) {
+        for (uint32_t k = 0; k < need; k++) {
+          touchFat(runStart + k, true);
+          fat[runStart + k] = k + 1 < need ? runStart + k + 1 : END_OF_CHAIN;
+          f.chain.push_back(runStart + k);
+        }
+        searchStart = runStart + need - 1;
+        used += need;
+        f.size = bytes;
+        f.contiguous = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void truncate(File& f, const uint32_t bytes) {
+    const uint32_t keep = (bytes + CLUSTER_SIZE - 1) / CLUSTER_SIZE;
+    while (f.chain.size() > keep) {
+      touchFat(f.chain.back(), true);
+      fat[f.chain.back()] = FREE;
+      f.chain.pop_back();
+      used--;
+    }
+    if (!f.chain.empty()) {
+      touchFat(f.chain.back(), true);
+      fat[f.chain.back()] = END_OF_CHAIN;
+    }
+    f.size = bytes;
+  }
+
+  void release(File& f) { truncate(f, 0); }
+
+  // Sequential writes through a sector buffer; a preallocated file already has its clusters
+  void write(File& f, const uint32_t bytes) {
+    for (uint32_t done = 0; done < bytes;) {
+      if (!f.contiguous && f.written % CLUSTER_SIZE == 0 && f.written / CLUSTER_SIZE >= f.chain.size()) {
+        extend(f);
+      }
+      const uint32_t cluster = f.chain[f.written / CLUSTER_SIZE];
+      if (cluster != lastWrittenCluster && cluster != lastWrittenCluster + 1) {
+        io.commands++;
+        io.writeJumps++;
+      }
+      lastWrittenCluster = cluster;
+      const uint32_t n = std::min<uint32_t>(SECTOR_SIZE - f.written % SECTOR_SIZE, bytes - done);
+      if (f.written % SECTOR_SIZE == 0) io.sectorsWritten++;
+      done += n;
+      f.written += n;
+      if (!f.contiguous) f.size = f.written;
+    }
+  }
+
+  // Opens the file and reads `bytes` at `offset`: walks the chain from the start unless the file is contiguous
+  void read(const File& f, const uint32_t offset, const uint32_t bytes, const bool freshOpen) {
+    const uint32_t first = offset / CLUSTER_SIZE;
+    const uint32_t last = (offset + bytes - 1) / CLUSTER_SIZE;
+    if (!f.contiguous) {
+      if (freshOpen) cachedFatSector = UINT32_MAX;
+      for (uint32_t i = 0; i < last; i++) touchFat(f.chain[i], false);
+    }
+    for (uint32_t i = first; i <= last; i++) {
+      if (i == first || f.chain[i] != f.chain[i - 1] + 1) io.commands++;
+    }
+    io.sectorsRead += (offset + bytes - 1) / SECTOR_SIZE - offset / SECTOR_SIZE + 1;
+  }
+
+  // SdFat keeps one FAT sector cached and writes it back (to both FATs) when it moves to another
+  void touchFat(const uint32_t cluster, const bool dirty) {
+    const uint32_t sector = cluster / FAT_ENTRIES_PER_SECTOR;
+    if (sector != cachedFatSector) {
+      if (fatDirty) io.fatWrites++;
+      io.fatReads++;
+      cachedFatSector = sector;
+      fatDirty = false;
+    }
+    fatDirty = fatDirty || dirty;
+  }
+
+  void flushFat() {
+    if (fatDirty) io.fatWrites++;
+    fatDirty = false;
+  }
+
+ private:
+  std::vector<uint32_t> fat;
+  uint32_t used = 0;
+  uint32_t searchStart = 2;
+  uint32_t cachedFatSector = UINT32_MAX;
+  bool fatDirty = false;
+  uint32_t lastWrittenCluster = UINT32_MAX - 1;
+};
+
+struct Result {
+  Io build;
+  Io parse;
+  Io pages;
+  int pagesLoaded = 0;
+  int fragments = 0;
+  int reserveMisses = 0;
+};
+
+Result run(const bool preallocate, const std::vector<uint32_t>& htmlSizes) {
+  std::mt19937 rng(21);
+  Volume volume;
+  volume.fragment(rng);
+
+  Result r;
+  std::vector<File> sections;
+  for (const uint32_t html : htmlSizes) {
+    const uint32_t sectionSize = static_cast<uint32_t>(html * SECTION_RATIO);
+
+    // Extract the chapter to a temp file, parse it back, write the section file as pages complete
+    File tmp;
+    Io before = volume.io;
+    if (preallocate && !volume.reserve(tmp, html)) r.reserveMisses++;
+    volume.write(tmp, html);
+    volume.flushFat();
+
+    File section;
+    if (preallocate && !volume.reserve(section, sectionSize * RESERVE_RATIO / SECTION_RATIO)) r.reserveMisses++;
+    const Io afterTmp = volume.io;
+    for (uint32_t off = 0; off < html; off += 4096) volume.read(tmp, off, std::min<uint32_t>(4096, html - off), false);
+    const Io afterParse = volume.io;
+    volume.write(section, sectionSize);
+    if (section.contiguous) volume.truncate(section, sectionSize);
+    volume.release(tmp);
+    volume.flushFat();
+
+    Io& parse = r.parse;
+    parse.fatReads += afterParse.fatReads - afterTmp.fatReads;
+    parse.commands += afterParse.commands - afterTmp.commands;
+    parse.sectorsRead += afterParse.sectorsRead - afterTmp.sectorsRead;
+    Io& build = r.build;
+    build.fatReads += volume.io.fatReads - before.fatReads - (afterParse.fatReads - afterTmp.fatReads);
+    build.fatWrites += volume.io.fatWrites - before.fatWrites;
+    build.commands += volume.io.commands - before.commands - (afterParse.commands - afterTmp.commands);
+    build.sectorsWritten += volume.io.sectorsWritten - before.sectorsWritten;
+    build.writeJumps += volume.io.writeJumps - before.writeJumps;
+
+    for (size_t i = 1; i < section.chain.size(); i++) {
+      if (section.chain[i] != section.chain[i - 1] + 1) r.fragments++;
+    }
+    sections.push_back(section);
+  }
+
+  // Read every page of every chapter, each load opening the section file afresh
+  const Io before = volume.io;
+  for (const auto& section : sections) {
+    for (uint32_t off = 64; off + PAGE_BYTES < section.size; off += PAGE_BYTES) {
+      volume.read(section, off, PAGE_BYTES, true);
+      r.pagesLoaded++;
+    }
+  }
+  r.pages.fatReads = volume.io.fatReads - before.fatReads;
+  r.pages.commands = volume.io.commands - before.commands;
+  r.pages.sectorsRead = volume.io.sectorsRead - before.sectorsRead;
+  return r;
+}
+
+void printRow(const char* name, const Io& io, const int ops) {
+  printf("%-28s %9ld %9ld %9ld %9ld %11.2f\n", name, io.fatReads, io.fatWrites, io.commands, io.writeJumps,
+         io.micros() / 1000.0 / ops);
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 rng(4);
+  std::vector<uint32_t> htmlSizes(CHAPTERS);
+  uint64_t totalHtml = 0;
+  for (auto& s : htmlSizes) {
+    s = 20000 + rng() % 180000;
+    totalHtml += s;
+  }
+
+  const Result plain = run(false, htmlSizes);
+  const Result reserved = run(true, htmlSizes);
+
+  printf("%d chapters, %llu KiB of XHTML, %d pages; card 80%% filled then half the files deleted\n", CHAPTERS,
+         static_cast<unsigned long long>(totalHtml / 1024), plain.pagesLoaded);
+  printf("%-28s %9s %9s %9s %9s %11s\n", "", "fat reads", "fat wrts", "commands", "jumps", "ms per op");
+  printRow("build, appending", plain.build, CHAPTERS);
+  printRow("build, preallocated", reserved.build, CHAPTERS);
+  printRow("parse temp XHTML, appending", plain.parse, CHAPTERS);
+  printRow("parse temp XHTML, preallocated", reserved.parse, CHAPTERS);
+  printRow("page load, appending", plain.pages, plain.pagesLoaded);
+  printRow("page load, preallocated", reserved.pages, reserved.pagesLoaded);
+  printf("section file fragments: appending %d, preallocated %d (%d reservations fell back to appending)\n",
+         plain.fragments, reserved.fragments, reserved.reserveMisses);
+
+  const bool ok = reserved.pages.micros() < plain.pages.micros() && reserved.fragments < plain.fragments &&
+                  plain.pagesLoaded == reserved.pagesLoaded;
+  printf(ok ? "All checks passed\n" : "Preallocation did not help\n");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+// Host stand-in for the HAL, picked up ahead of the real HalStorage.h: an in-memory card that charges each call a
+// modelled SD time on the simulation clock and counts it. Times are estimates for a FAT32 card on the X4's SPI bus:
+// opening walks the directory, closing syncs the directory entry and the FAT.
+
+#define O_RDONLY 0x00
+#define O_WRONLY 0x01
+#define O_RDWR 0x02
+#define O_CREAT 0x40
+#define O_TRUNC 0x200
+
+using oflag_t = int;
+
+namespace sim {
+inline uint64_t clockMicros = 0;
+}
+
+struct Card {
+  static constexpr uint32_t OPEN_MICROS = 4500;
+  static constexpr uint32_t WRITE_MICROS = 900;
+  static constexpr uint32_t CLOSE_MICROS = 9000;
+
+  std::map<std::string, std::vector<uint8_t>> files;
+  uint32_t opens = 0;
+  uint32_t writes = 0;
+  uint32_t closes = 0;
+  int failEvery = 0;  // Fail every Nth write; 0 for never
+
+  void charge(const uint32_t micros) { sim::clockMicros += micros; }
+};
+
+class FsFile {
+ public:
+  FsFile() = default;
+  explicit FsFile(std::vector<uint8_t>* data) : data(data) {}
+  explicit operator bool() const { return data != nullptr; }
+
+ private:
+  friend class HalStorage;
+  std::vector<uint8_t>* data = nullptr;
+  size_t pos = 0;
+};
+
+class HalStorage {
+ public:
+  Card card;
+
+  FsFile open(const char* path, const oflag_t oflag = O_RDONLY) {
+    card.opens++;
+    card.charge(Card::OPEN_MICROS);
+    auto it = card.files.find(path);
+    if (it == card.files.end()) {
+      if (!(oflag & O_CREAT)) return {};
+      it = card.files.emplace(path, std::vector<uint8_t>()).first;
+    }
+    if (oflag & O_TRUNC) it->second.clear();
+    return FsFile(&it->second);
+  }
+
+  size_t write(FsFile& file, const void* buffer, const size_t count) {
+    card.writes++;
+    card.charge(Card::WRITE_MICROS);
+    if (!file.data || (card.failEvery > 0 && card.writes % card.failEvery == 0)) return 0;
+    if (file.pos + count > file.data->size()) file.data->resize(file.pos + count);
+    memcpy(file.data->data() + file.pos, buffer, count);
+    file.pos += count;
+    return count;
+  }
+
+  bool close(FsFile& file) {
+    card.closes++;
+    card.charge(Card::CLOSE_MICROS);
+    const bool ok = file.data != nullptr;
+    file.data = nullptr;
+    return ok;
+  }
+};
+
+inline HalStorage Storage;
@@ -0,0 +1,233 @@
+#include <HalStorage.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ProgressJournal.h"
+
+// Replays synthetic reading sessions through ProgressJournal and compares it with writing progress.bin on every page
+// turn, as the readers did before. After every step of every session it reads progress.bin back the way a reader
+// would after an unexpected reset and checks the position lost is never more than the page on screen. Card times are
+// the estimates in the stub HalStorage.h, not measurements.
+
+namespace {
+
+const std::string PATH = "/.crosspoint/epub_sim/progress.bin";
+constexpr uint32_t LOOP_POLL_MS = 50;  // How often the reader's loop() comes round while idle
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+struct Turn {
+  uint64_t atMs;
+  int spineIndex;
+  int page;
+  int pageCount;
+  uint16_t battery;
+};
+
+struct Profile {
+  const char* name;
+  double skimChance;     // Chance a turn starts a run of quick page turns
+  double jumpChance;     // Chance a turn is a jump through the table of contents
+  double backChance;     // Chance a turn goes back a page
+  double redrawChance;   // Chance of a redraw in place (settings, a menu closing)
+  uint16_t batteryFrom;  // Battery over the session, falling linearly
+  uint16_t batteryTo;
+};
+
+std::vector<Turn> makeSession(const Profile& profile, std::mt19937& rng, const int turns) {
+  std::uniform_real_distribution<double> unit(0, 1);
+  std::vector<int> chapterPages(60);
+  for (auto& pages : chapterPages) pages = 12 + rng() % 30;
+
+  std::vector<Turn> session;
+  uint64_t atMs = 0;
+  int spineIndex = 0, page = 0, skimLeft = 0;
+  for (int i = 0; i < turns; i++) {
+    const double r = unit(rng);
+    if (skimLeft == 0 && unit(rng) < profile.skimChance) skimLeft = 10 + rng() % 30;
+    atMs += skimLeft > 0 ? 300 + rng() % 900 : 15000 + rng() % 45000;
+    if (skimLeft > 0) skimLeft--;
+
+    if (r < profile.jumpChance) {
+      spineIndex = rng() % chapterPages.size();
+      page = 0;
+    } else if (r < profile.jumpChance + profile.backChance) {
+      if (--page < 0) {
+        spineIndex = std::max(spineIndex - 1, 0);
+        page = chapterPages[spineIndex] - 1;
+      }
+    } else if (r < profile.jumpChance + profile.backChance + profile.redrawChance) {
+      // Same page again
+    } else if (++page >= chapterPages[spineIndex]) {
+      spineIndex = (spineIndex + 1) % chapterPages.size();
+      page = 0;
+    }
+    const auto battery = static_cast<uint16_t>(profile.batteryFrom -
+                                               (profile.batteryFrom - profile.batteryTo) * i / std::max(turns - 1, 1));
+    session.push_back({atMs, spineIndex, page, chapterPages[spineIndex], battery});
+  }
+  return session;
+}
+
+// EpubReaderActivity's progress.bin record
+std::vector<uint8_t> encode(const Turn& turn) {
+  return {static_cast<uint8_t>(turn.spineIndex & 0xFF), static_cast<uint8_t>(turn.spineIndex >> 8),
+          static_cast<uint8_t>(turn.page & 0xFF),       static_cast<uint8_t>(turn.page >> 8),
+          static_cast<uint8_t>(turn.pageCount & 0xFF),  static_cast<uint8_t>(turn.pageCount >> 8)};
+}
+
+// Pages of the on-screen position a reset right now would lose; -1 when the stored one is in another chapter
+int pagesLost(const Turn& shown) {
+  const auto it = Storage.card.files.find(PATH);
+  if (it == Storage.card.files.end() || it->second.size() < 4) return -1;
+  const auto& d = it->second;
+  const int spineIndex = d[0] | (d[1] << 8);
+  const int page = d[2] | (d[3] << 8);
+  if (spineIndex != shown.spineIndex) return -1;
+  return std::abs(shown.page - page);
+}
+
+struct Result {
+  uint32_t turns = 0;
+  uint32_t writes = 0;
+  uint32_t turnWrites = 0;  // Made while a page turn waited
+  uint64_t micros = 0;      // Spent in page turns waiting on the card
+  uint64_t behindMs = 0;    // Reading time during which a reset would lose the page on screen
+};
+
+// Every turn writes progress.bin, truncating it first
+Result runWritePerTurn(const std::vector<Turn>& session) {
+  Storage.card = {};
+  Result result;
+  for (const auto& turn : session) {
+    const uint64_t start = sim::clockMicros;
+    FsFile file = Storage.open(PATH.c_str(), O_RDWR | O_CREAT | O_TRUNC);
+    const auto record = encode(turn);
+    Storage.write(file, record.data(), record.size());
+    Storage.close(file);
+    result.turns++;
+    result.writes++;
+    result.turnWrites++;
+    result.micros += sim::clockMicros - start;
+  }
+  return result;
+}
+
+Result runJournal(const std::vector<Turn>& session) {
+  Storage.card = {};
+  Result result;
+  ProgressJournal journal;
+  journal.begin(PATH, -1, -1);
+
+  const auto checkReset = [&](const Turn& shown, const uint64_t untilMs) {
+    const int lost = pagesLost(shown);
+    check(lost >= 0 && lost <= 1, "a reset loses at most the page on screen");
+    if (lost > 0) result.behindMs += untilMs - shown.atMs;
+  };
+
+  for (size_t i = 0; i < session.size(); i++) {
+    const Turn& turn = session[i];
+    const uint64_t start = sim::clockMicros;
+    const uint32_t writes = Storage.card.writes;
+    const auto record = encode(turn);
+    journal.record(turn.spineIndex, turn.page, record.data(), record.size(), turn.battery,
+                   static_cast<uint32_t>(turn.atMs));
+    result.turnWrites += Storage.card.writes - writes;
+    result.micros += sim::clockMicros - start;
+
+    // The loop polls until the next turn; the idle flush happens at the first poll past IDLE_FLUSH_MS
+    const uint64_t nextMs = i + 1 < session.size() ? session[i + 1].atMs : turn.atMs + 60000;
+    uint64_t flushMs = nextMs;
+    for (uint64_t pollMs = turn.atMs + LOOP_POLL_MS; pollMs < nextMs; pollMs += LOOP_POLL_MS) {
+      if (journal.due(static_cast<uint32_t>(pollMs))) {
+        flushMs = pollMs;
+        break;
+      }
+    }
+    checkReset(turn, flushMs);
+    if (flushMs < nextMs) {
+      journal.flush();
+      checkReset(turn, turn.atMs);
+    }
+  }
+  journal.end();
+  check(!journal.pending(), "nothing pending after end()");
+  check(pagesLost(session.back()) == 0, "the last page is stored after end()");
+
+  result.turns = journal.stats().records;
+  result.writes = journal.stats().writes;
+  return result;
+}
+
+Result compare(const Profile& profile, const int turns, const uint32_t seed) {
+  std::mt19937 rng(seed);
+  const auto session = makeSession(profile, rng, turns);
+  const Result before = runWritePerTurn(session);
+  const Result after = runJournal(session);
+  check(after.turns == before.turns, "every turn recorded");
+  check(after.writes <= before.writes, "the journal never writes more than once a turn");
+
+  const uint64_t sessionMs = session.back().atMs;
+  printf("%-16s %5u turns  writes %5u -> %5u total (%4u in a turn, %4u idle)  %5.2f -> %5.2f ms/turn  behind %4.1f%% "
+         "of the time\n",
+         profile.name, before.turns, before.writes, after.writes, after.turnWrites, after.writes - after.turnWrites,
+         before.micros / 1000.0 / before.turns, after.micros / 1000.0 / after.turns,
+         100.0 * after.behindMs / sessionMs);
+  return after;
+}
+
+// A write that fails leaves the position pending, and the next trigger stores it
+void failedWriteStaysPending() {
+  Storage.card = {};
+  ProgressJournal journal;
+  journal.begin(PATH, 0, 0);
+  const Turn turn{0, 0, 1, 20, 100};
+  const auto record = encode(turn);
+  journal.record(turn.spineIndex, turn.page, record.data(), record.size(), turn.battery, 0);
+  Storage.card.failEvery = 1;
+  check(!journal.flush() && journal.pending(), "failed write stays pending");
+  Storage.card.failEvery = 0;
+  check(journal.due(ProgressJournal::IDLE_FLUSH_MS) && journal.flush() && pagesLost(turn) == 0,
+        "pending position written at the next trigger");
+
+  // Drawing the stored page again doesn't touch the card
+  const uint32_t writes = Storage.card.writes;
+  journal.record(turn.spineIndex, turn.page, record.data(), record.size(), turn.battery, 5000);
+  check(!journal.pending() && Storage.card.writes == writes, "redraw in place is not written");
+}
+
+}  // namespace
+
+int main() {
+  const Profile profiles[] = {
+      {"steady reading", 0.0, 0.002, 0.02, 0.01, 90, 60},
+      {"skimming", 0.08, 0.01, 0.05, 0.01, 80, 50},
+      {"chapter hopping", 0.02, 0.15, 0.05, 0.02, 70, 40},
+      {"low battery", 0.04, 0.01, 0.03, 0.01, 14, 5},
+  };
+
+  printf("progress.bin, write per turn -> write-behind journal (idle flush %u ms)\n", ProgressJournal::IDLE_FLUSH_MS);
+  uint32_t seed = 1;
+  for (const auto& profile : profiles) {
+    const Result result = compare(profile, 2000, seed++);
+    if (&profile == &profiles[0]) {
+      check(result.writes <= result.turns * 11 / 20, "steady reading writes about every other page");
+    }
+  }
+  failedWriteStaysPending();
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+#include "HalStorage.h"
+
+// Host stand-in: the caller tags are kept, the clock is the simulation's
+class StorageStats {
+ public:
+  enum class Tag : uint8_t { Other, Reader, SectionBuild, WebServer, Thumbnails, Progress, Count };
+
+  class Scope {
+   public:
+    explicit Scope(Tag) {}
+  };
+
+  static uint32_t now() { return static_cast<uint32_t>(sim::clockMicros); }
+};
@@ -0,0 +1,171 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "RefreshScheduler.h"
+
+// Replays synthetic page sequences through RefreshScheduler and compares it with the fixed "half refresh every N
+// pages" policy the readers used before. Panel times are estimates for the X4 panel, not measurements.
+
+namespace {
+
+constexpr int WIDTH_BYTES = RefreshScheduler::PANEL_WIDTH_BYTES;
+constexpr int HEIGHT = RefreshScheduler::PANEL_HEIGHT;
+constexpr size_t FRAME_SIZE = WIDTH_BYTES * HEIGHT;
+constexpr int PAGES_PER_HALF_REFRESH = 15;
+
+constexpr unsigned FAST_MS = 420;
+constexpr unsigned HALF_MS = 1720;
+constexpr unsigned FULL_MS = 3000;
+
+using Frame = std::vector<uint8_t>;
+
+// Frames are drawn in panel coordinates: bit cleared = black
+void setBlack(Frame& frame, const int x, const int y) { frame[y * WIDTH_BYTES + x / 8] &= ~(0x80 >> (x % 8)); }
+
+Frame blankFrame() { return Frame(FRAME_SIZE, 0xFF); }
+
+// Lines of text with ragged right edges and about `density` ink inside the text block, plus a status bar
+Frame textPage(std::mt19937& rng, const double density, const int lines = 22) {
+  Frame frame = blankFrame();
+  std::uniform_real_distribution<double> unit(0, 1);
+  const int lineHeight = (HEIGHT - 60) / lines;
+  for (int line = 0; line < lines; line++) {
+    const int top = 20 + line * lineHeight;
+    const int right = 760 - static_cast<int>(unit(rng) * (line % 7 == 6 ? 500 : 40));
+    for (int y = top + 4; y < top + lineHeight - 4; y++) {
+      for (int x = 40; x < right; x++) {
+        if (unit(rng) < density * 1.6) setBlack(frame, x, y);
+      }
+    }
+  }
+  // Status bar with a page number that changes every page
+  for (int y = HEIGHT - 24; y < HEIGHT - 10; y++) {
+    for (int x = 360; x < 440; x++) {
+      if (unit(rng) < 0.3) setBlack(frame, x, y);
+    }
+  }
+  return frame;
+}
+
+Frame imagePage(std::mt19937& rng) {
+  Frame frame = textPage(rng, 0.12, 6);
+  std::uniform_real_distribution<double> unit(0, 1);
+  for (int y = 180; y < 460; y++) {
+    for (int x = 80; x < 720; x++) {
+      if (unit(rng) < 0.5) setBlack(frame, x, y);
+    }
+  }
+  return frame;
+}
+
+// A popup drawn over (or removed from) the previous frame
+Frame withPopup(const Frame& base) {
+  Frame frame = base;
+  for (int y = 200; y < 280; y++) {
+    for (int xb = 25; xb < 75; xb++) {
+      frame[y * WIDTH_BYTES + xb] = (y == 200 || y == 279) ? 0x00 : 0xFF;
+    }
+  }
+  return frame;
+}
+
+struct Totals {
+  int fast = 0;
+  int half = 0;
+  int full = 0;
+  unsigned long panelMs = 0;
+  float worstGhosting = 0;
+
+  void add(const RefreshScheduler::Mode mode) {
+    if (mode == RefreshScheduler::FAST) {
+      fast++;
+      panelMs += FAST_MS;
+    } else if (mode == RefreshScheduler::HALF) {
+      half++;
+      panelMs += HALF_MS;
+    } else {
+      full++;
+      panelMs += FULL_MS;
+    }
+  }
+};
+
+char modeChar(const RefreshScheduler::Mode mode) {
+  return mode == RefreshScheduler::FAST ? '.' : mode == RefreshScheduler::HALF ? 'H' : 'F';
+}
+
+void runScenario(const std::string& name, const std::vector<Frame>& frames) {
+  RefreshScheduler scheduler;
+  scheduler.setTextPagesPerHalfRefresh(PAGES_PER_HALF_REFRESH);
+  // Ghosting estimate of the fixed policy, tracked with a second scheduler that is only told what happened
+  RefreshScheduler fixedTracker;
+  fixedTracker.setTextPagesPerHalfRefresh(PAGES_PER_HALF_REFRESH);
+
+  Totals adaptive;
+  Totals fixed;
+  std::string adaptiveTrace;
+  std::string fixedTrace;
+  int pagesUntilHalfRefresh = 0;
+
+  for (const Frame& frame : frames) {
+    const RefreshScheduler::Decision decision = scheduler.choose(frame.data());
+    adaptive.add(decision.mode);
+    adaptive.worstGhosting = std::max(adaptive.worstGhosting, decision.peakGhosting);
+    adaptiveTrace += modeChar(decision.mode);
+    scheduler.record(frame.data(), decision.mode);
+
+    const RefreshScheduler::Mode fixedMode =
+        pagesUntilHalfRefresh <= 1 ? RefreshScheduler::HALF : RefreshScheduler::FAST;
+    pagesUntilHalfRefresh = pagesUntilHalfRefresh <= 1 ? PAGES_PER_HALF_REFRESH : pagesUntilHalfRefresh - 1;
+    fixed.add(fixedMode);
+    fixed.worstGhosting = std::max(fixed.worstGhosting, fixedTracker.choose(frame.data()).peakGhosting);
+    fixedTrace += modeChar(fixedMode);
+    fixedTracker.record(frame.data(), fixedMode);
+  }
+
+  printf("%s (%zu frames)\n", name.c_str(), frames.size());
+  printf("  fixed    %s\n", fixedTrace.c_str());
+  printf("  adaptive %s\n", adaptiveTrace.c_str());
+  const auto report = [](const char* label, const Totals& t) {
+    printf("  %-8s fast %3d  half %3d  full %3d  panel %6.1f s  worst ghosting %5.1f pages\n", label, t.fast, t.half,
+           t.full, t.panelMs / 1000.0, t.worstGhosting);
+  };
+  report("fixed", fixed);
+  report("adaptive", adaptive);
+  printf("\n");
+}
+
+std::vector<Frame> sequence(const int count, const std::function<Frame(int)>& makeFrame) {
+  std::vector<Frame> frames;
+  frames.reserve(count);
+  for (int i = 0; i < count; i++) {
+    frames.push_back(makeFrame(i));
+  }
+  return frames;
+}
+
+}  // namespace
+
+int main() {
+  std::mt19937 rng(42);
+
+  printf("Legend: '.' fast, 'H' half, 'F' full. Half refresh every %d pages for the fixed policy.\n",
+         PAGES_PER_HALF_REFRESH);
+  printf("Estimated panel time per refresh: fast %u ms, half %u ms, full %u ms\n\n", FAST_MS, HALF_MS, FULL_MS);
+
+  runScenario("Novel: dense text", sequence(150, [&](int) { return textPage(rng, 0.12); }));
+  runScenario("Poetry: sparse text", sequence(150, [&](int) { return textPage(rng, 0.04, 10); }));
+  runScenario("Illustrated: image every 8th page",
+              sequence(150, [&](const int i) { return i % 8 == 7 ? imagePage(rng) : textPage(rng, 0.12); }));
+  runScenario("Comic: image pages", sequence(60, [&](int) { return imagePage(rng); }));
+
+  const Frame page = textPage(rng, 0.12);
+  runScenario("Menu: popup opened and closed over one page",
+              sequence(60, [&](const int i) { return i % 2 ? withPopup(page) : page; }));
+  return 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Host stand-in for the Arduino core, only what the renderer and its HAL use, with the
+// standard headers the device core pulls in. The clock is the host's steady clock.
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+#define PROGMEM
+
+class Print {
+ public:
+  virtual ~Print() = default;
+  virtual size_t write(uint8_t) { return 1; }
+  virtual size_t write(const uint8_t*, size_t count) { return count; }
+};
+
+class String {
+ public:
+  String() = default;
+  String(const char* s) : s(s) {}
+  const char* c_str() const { return s.c_str(); }
+  size_t length() const { return s.size(); }
+
+ private:
+  std::string s;
+};
@@ -0,0 +1,278 @@
+#include <Bitmap.h>
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Draws 480x800 BMPs at every bit depth the reader decodes through GfxRenderer::drawBitmap and through a per-pixel
+// reference that mirrors the float-scaled drawPixel loop the renderer used before, in all four orientations and all
+// three render modes. Unscaled draws with a crop must leave the same framebuffer, and a nearest-sampled 131x173
+// thumbnail must show exactly the source pixels its sampling tables pick; the thumbnail is timed for nearest
+// sampling, area averaging and the reference. The images are built in memory, so the timings
+// cover decoding and drawing, not the card. Host timings: the ratio is what carries over to the device.
+
+namespace {
+
+constexpr int WIDTH = 480;
+constexpr int HEIGHT = 800;
+constexpr int THUMB_WIDTH = 131;
+constexpr int THUMB_HEIGHT = 173;
+constexpr float CROP_X = 0.1f;
+constexpr float CROP_Y = 0.05f;
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+uint64_t fnv(const uint8_t* data, const size_t size) {
+  uint64_t h = 1469598103934665603ull;
+  for (size_t i = 0; i < size; i++) {
+    h ^= data[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+void put16(std::vector<uint8_t>& out, const uint16_t v) {
+  out.push_back(v & 0xFF);
+  out.push_back(v >> 8);
+}
+
+void put32(std::vector<uint8_t>& out, const uint32_t v) {
+  put16(out, v & 0xFFFF);
+  put16(out, v >> 16);
+}
+
+// Gray level 0-255 of the test pattern: a diagonal gradient crossed by text-like stripes and a checkered block
+uint8_t pattern(const int x, const int y) {
+  if (x > 300 && x < 420 && y > 100 && y < 260) return ((x / 6) + (y / 6)) % 2 ? 0 : 255;
+  if (y % 40 < 6 && x % 13 < 9) return 24;
+  return static_cast<uint8_t>((x * 255 / WIDTH + y * 255 / HEIGHT) / 2);
+}
+
+// An uncompressed BMP of the pattern, paletted gray at 1, 2, 4 and 8 bpp, BGR at 24
+std::vector<uint8_t> makeBmp(const int bpp, const bool topDown) {
+  const int colors = bpp <= 8 ? 1 << bpp : 0;
+  const uint32_t rowBytes = (WIDTH * bpp + 31) / 32 * 4;
+  const uint32_t offset = 14 + 40 + colors * 4;
+  std::vector<uint8_t> out;
+  out.push_back('B');
+  out.push_back('M');
+  put32(out, offset + rowBytes * HEIGHT);
+  put32(out, 0);
+  put32(out, offset);
+  put32(out, 40);
+  put32(out, WIDTH);
+  put32(out, static_cast<uint32_t>(topDown ? -HEIGHT : HEIGHT));
+  put16(out, 1);
+  put16(out, bpp);
+  put32(out, 0);
+  put32(out, rowBytes * HEIGHT);
+  put32(out, 2835);
+  put32(out, 2835);
+  put32(out, colors);
+  put32(out, 0);
+  for (int i = 0; i < colors; i++) {
+    const uint8_t level = static_cast<uint8_t>(i * 255 / (colors - 1));
+    out.insert(out.end(), {level, level, level, 0});
+  }
+  for (int row = 0; row < HEIGHT; row++) {
+    const int y = topDown ? row : HEIGHT - 1 - row;
+    std::vector<uint8_t> line(rowBytes, 0);
+    for (int x = 0; x < WIDTH; x++) {
+      const uint8_t gray = pattern(x, y);
+      if (bpp == 24) {
+        line[x * 3] = gray;
+        line[x * 3 + 1] = static_cast<uint8_t>(std::min(255, gray + 10));
+        line[x * 3 + 2] = static_cast<uint8_t>(gray / 2 + 64);
+        continue;
+      }
+      const int index = gray * (colors - 1) / 255;
+      const int bit = x * bpp;
+      line[bit / 8] |= index << (8 - bpp - bit % 8);
+    }
+    out.insert(out.end(), line.begin(), line.end());
+  }
+  return out;
+}
+
+// drawBitmap and drawBitmap1Bit before the sampling tables: every source pixel through drawPixel at floor(x * scale)
+void referenceBitmap(const GfxRenderer& renderer, const Bitmap& bitmap, const int x, const int y, const int maxWidth,
+                     const int maxHeight, const float cropX, const float cropY) {
+  const bool oneBit = bitmap.is1Bit() && cropX == 0.0f && cropY == 0.0f;
+  float scale = 1.0f;
+  bool isScaled = false;
+  const int cropPixX = oneBit ? 0 : std::floor(bitmap.getWidth() * cropX / 2.0f);
+  const int cropPixY = oneBit ? 0 : std::floor(bitmap.getHeight() * cropY / 2.0f);
+  if (maxWidth > 0 && (1.0f - cropX) * bitmap.getWidth() > maxWidth) {
+    scale = static_cast<float>(maxWidth) / ((1.0f - cropX) * bitmap.getWidth());
+    isScaled = true;
+  }
+  if (maxHeight > 0 && (1.0f - cropY) * bitmap.getHeight() > maxHeight) {
+    scale = std::min(scale, static_cast<float>(maxHeight) / ((1.0f - cropY) * bitmap.getHeight()));
+    isScaled = true;
+  }
+
+  std::vector<uint8_t> outputRow((bitmap.getWidth() + 3) / 4);
+  std::vector<uint8_t> rowBytes(bitmap.getRowBytes());
+  const auto mode = renderer.getRenderMode();
+  for (int bmpY = 0; bmpY < bitmap.getHeight() - cropPixY; bmpY++) {
+    int screenY = -cropPixY + (bitmap.isTopDown() ? bmpY : bitmap.getHeight() - 1 - bmpY);
+    if (isScaled) screenY = std::floor(screenY * scale);
+    screenY += y;
+    if (bitmap.readNextRow(outputRow.data(), rowBytes.data()) != BmpReaderError::Ok) return;
+    // The old loop stopped at the first row below the screen, which lost bottom-up images taller than the screen;
+    // the reference carries on the way drawBitmap1Bit did
+    if (screenY < 0 || screenY >= renderer.getScreenHeight() || bmpY < cropPixY) continue;
+
+    for (int bmpX = cropPixX; bmpX < bitmap.getWidth() - cropPixX; bmpX++) {
+      int screenX = bmpX - cropPixX;
+      if (isScaled) screenX = std::floor(screenX * scale);
+      screenX += x;
+      if (screenX >= renderer.getScreenWidth()) break;
+      if (screenX < 0) continue;
+
+      const uint8_t val = outputRow[bmpX / 4] >> (6 - ((bmpX * 2) % 8)) & 0x3;
+      if (oneBit) {
+        if (val < 3) renderer.drawPixel(screenX, screenY, true);
+      } else if (mode == GfxRenderer::BW && val < 3) {
+        renderer.drawPixel(screenX, screenY);
+      } else if (mode == GfxRenderer::GRAYSCALE_MSB && (val == 1 || val == 2)) {
+        renderer.drawPixel(screenX, screenY, false);
+      } else if (mode == GfxRenderer::GRAYSCALE_LSB && val == 1) {
+        renderer.drawPixel(screenX, screenY, false);
+      }
+    }
+  }
+}
+
+// What nearest sampling should produce for an uncropped thumbnail at (0, 0): screen pixel (dx, dy) shows source pixel
+// (dx * srcWidth / dstWidth, dy * srcHeight / dstHeight), with the box sized the way drawBitmap fits it
+void expectedThumbnail(const GfxRenderer& renderer, const Bitmap& bitmap) {
+  const int srcWidth = bitmap.getWidth();
+  const int srcHeight = bitmap.getHeight();
+  const float scale = std::min(static_cast<float>(THUMB_WIDTH) / srcWidth, static_cast<float>(THUMB_HEIGHT) / srcHeight);
+  const int dstWidth = std::min(THUMB_WIDTH, std::max(1, static_cast<int>(std::lround(srcWidth * scale))));
+  const int dstHeight = std::min(THUMB_HEIGHT, std::max(1, static_cast<int>(std::lround(srcHeight * scale))));
+
+  std::vector<std::vector<uint8_t>> rows(srcHeight, std::vector<uint8_t>((srcWidth + 3) / 4));
+  std::vector<uint8_t> rowBytes(bitmap.getRowBytes());
+  bitmap.rewindToData();
+  for (int bmpY = 0; bmpY < srcHeight; bmpY++) {
+    bitmap.readNextRow(rows[bitmap.isTopDown() ? bmpY : srcHeight - 1 - bmpY].data(), rowBytes.data());
+  }
+
+  const auto mode = renderer.getRenderMode();
+  renderer.clearScreen(mode == GfxRenderer::BW ? 0xFF : 0x00);
+  for (int dy = 0; dy < dstHeight; dy++) {
+    const auto& row = rows[dy * srcHeight / dstHeight];
+    for (int dx = 0; dx < dstWidth; dx++) {
+      const int sx = dx * srcWidth / dstWidth;
+      const uint8_t val = row[sx / 4] >> (6 - ((sx * 2) % 8)) & 0x3;
+      if (bitmap.is1Bit() || mode == GfxRenderer::BW) {
+        if (val < 3) renderer.drawPixel(dx, dy, true);
+      } else if (mode == GfxRenderer::GRAYSCALE_MSB ? (val == 1 || val == 2) : val == 1) {
+        renderer.drawPixel(dx, dy, false);
+      }
+    }
+  }
+}
+
+struct Draw {
+  double micros = 0;
+  uint64_t hash = 0;
+};
+
+enum class Path { Reference, Nearest, AreaAverage };
+
+Draw draw(const GfxRenderer& renderer, const Bitmap& bitmap, const Path path, const bool thumbnail) {
+  renderer.clearScreen(renderer.getRenderMode() == GfxRenderer::BW ? 0xFF : 0x00);
+  bitmap.rewindToData();
+  const int x = thumbnail ? 0 : 7;
+  const int y = thumbnail ? 0 : 11;
+  const int maxWidth = thumbnail ? THUMB_WIDTH : 2000;
+  const int maxHeight = thumbnail ? THUMB_HEIGHT : 2000;
+  const float cropX = thumbnail ? 0 : CROP_X;
+  const float cropY = thumbnail ? 0 : CROP_Y;
+  const unsigned long start = micros();
+  if (path == Path::Reference) {
+    referenceBitmap(renderer, bitmap, x, y, maxWidth, maxHeight, cropX, cropY);
+  } else {
+    renderer.drawBitmap(bitmap, x, y, maxWidth, maxHeight, cropX, cropY,
+                        path == Path::Nearest ? GfxRenderer::BitmapScaling::Nearest
+                                              : GfxRenderer::BitmapScaling::AreaAverage);
+  }
+  Draw result;
+  result.micros = static_cast<double>(micros() - start);
+  result.hash = fnv(renderer.getFrameBuffer(), HalDisplay::BUFFER_SIZE);
+  return result;
+}
+
+}  // namespace
+
+int main() {
+  HalDisplay display;
+  GfxRenderer renderer(display);
+  display.begin();
+  renderer.begin();
+
+  const struct {
+    int bpp;
+    bool topDown;
+    const char* name;
+  } images[] = {{1, true, "1-bit"},       {2, true, "2-bit"},         {4, true, "4-bit"},
+                {8, true, "8-bit"},       {8, false, "8-bit bottom-up"}, {24, true, "24-bit"}};
+
+  printf("%dx%d, us per image over 4 orientations x 3 modes\n", WIDTH, HEIGHT);
+  printf("  %-16s %23s   %36s\n", "", "1:1 with crop", "131x173 thumbnail");
+  printf("  %-16s %10s %12s   %10s %12s %12s\n", "", "per-pixel", "span blit", "per-pixel", "nearest", "area avg");
+  for (const auto& image : images) {
+    const std::string path = "/bench_" + std::to_string(image.bpp) + (image.topDown ? "" : "_up") + ".bmp";
+    Storage.files[path] = std::make_shared<std::vector<uint8_t>>(makeBmp(image.bpp, image.topDown));
+    FsFile file;
+    Storage.openFileForRead("BENCH", path, file);
+    Bitmap bitmap(file);
+    if (bitmap.parseHeaders() != BmpReaderError::Ok) {
+      check(false, "bench image parses");
+      continue;
+    }
+
+    double reference = 0, blit = 0, referenceThumb = 0, nearestThumb = 0, areaThumb = 0;
+    bool same = true;
+    bool thumbnailsSampled = true;
+    for (int o = 0; o < 4; o++) {
+      renderer.setOrientation(static_cast<GfxRenderer::Orientation>(o));
+      for (int m = 0; m < 3; m++) {
+        renderer.setRenderMode(static_cast<GfxRenderer::RenderMode>(m));
+        const Draw before = draw(renderer, bitmap, Path::Reference, false);
+        const Draw after = draw(renderer, bitmap, Path::Nearest, false);
+        same = same && before.hash == after.hash;
+        reference += before.micros;
+        blit += after.micros;
+        referenceThumb += draw(renderer, bitmap, Path::Reference, true).micros;
+        const Draw nearest = draw(renderer, bitmap, Path::Nearest, true);
+        const Draw area = draw(renderer, bitmap, Path::AreaAverage, true);
+        expectedThumbnail(renderer, bitmap);
+        thumbnailsSampled = thumbnailsSampled && nearest.hash == fnv(renderer.getFrameBuffer(), HalDisplay::BUFFER_SIZE);
+        nearestThumb += nearest.micros;
+        areaThumb += area.micros;
+      }
+    }
+    check(same, "unscaled span blit matches the per-pixel path");
+    check(thumbnailsSampled, "nearest thumbnail samples every screen row and column");
+    printf("  %-16s %10.0f %12.0f   %10.0f %12.0f %12.0f%s\n", image.name, reference / 12, blit / 12,
+           referenceThumb / 12, nearestThumb / 12, areaThumb / 12, same && thumbnailsSampled ? "" : "  MISMATCH");
+    file.close();
+  }
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
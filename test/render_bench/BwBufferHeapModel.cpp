@@ -0,0 +1,266 @@
+#include <GfxRenderer.h>
+#include <GlyphDisplayList.h>
+#include <HalDisplay.h>
+#include <builtinFonts/ubuntu_12_regular.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// Replays a 200-page anti-aliased reading session with a section build every 25 pages against a first-fit model of a
+// 200KB device heap: every malloc the renderer and the session make is served from the model while it is on. Runs
+// the session in black and white and anti-aliased (BW backup allocated per page around the grayscale pass), and
+// reports the largest free block before, during and after, the heap calls made, and the largest block a section
+// build finds for its inflate window. Checks the backup holds nothing between pages and leaves the heap no worse
+// than the black and white session. The model's fit policy is a stand-in for the ESP32's; the trend is what carries
+// over, not the exact bytes.
+
+extern "C" void* __libc_malloc(size_t);
+extern "C" void __libc_free(void*);
+extern "C" void* __libc_realloc(void*, size_t);
+
+namespace {
+
+constexpr size_t ARENA = 200 * 1024;
+constexpr int PAGES = 200;
+constexpr int PAGES_PER_SECTION = 25;
+constexpr size_t INFLATE_WINDOW = 32768 + 11000;  // Window plus parser buffers a section build needs at once
+constexpr size_t BW_BUFFER = HalDisplay::BUFFER_SIZE;
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+// First-fit heap over a fixed arena: 8-byte headers, 16-byte granules, neighbours coalesced on free
+struct BlockHeader {
+  uint32_t size;  // Including the header
+  uint32_t used;
+};
+
+alignas(16) uint8_t arena[ARENA];
+bool arenaOn = false;
+size_t heapCalls = 0;
+
+bool inArena(const void* p) { return p >= arena && p < arena + ARENA; }
+
+BlockHeader* blockAt(const size_t offset) { return reinterpret_cast<BlockHeader*>(arena + offset); }
+
+void arenaReset() {
+  blockAt(0)->size = ARENA;
+  blockAt(0)->used = 0;
+  heapCalls = 0;
+}
+
+void* arenaAlloc(const size_t n) {
+  heapCalls++;
+  const size_t need = (n + sizeof(BlockHeader) + 15) & ~static_cast<size_t>(15);
+  for (size_t offset = 0; offset < ARENA; offset += blockAt(offset)->size) {
+    BlockHeader* block = blockAt(offset);
+    if (block->used || block->size < need) continue;
+    if (block->size - need >= 32) {
+      BlockHeader* rest = blockAt(offset + need);
+      rest->size = block->size - need;
+      rest->used = 0;
+      block->size = need;
+    }
+    block->used = 1;
+    return block + 1;
+  }
+  return nullptr;
+}
+
+void arenaFree(void* p) {
+  heapCalls++;
+  (static_cast<BlockHeader*>(p) - 1)->used = 0;
+  for (size_t offset = 0; offset < ARENA; offset += blockAt(offset)->size) {
+    BlockHeader* block = blockAt(offset);
+    while (!block->used && offset + block->size < ARENA && !blockAt(offset + block->size)->used) {
+      block->size += blockAt(offset + block->size)->size;
+    }
+  }
+}
+
+size_t largestFree(size_t* total = nullptr) {
+  size_t largest = 0, sum = 0;
+  for (size_t offset = 0; offset < ARENA; offset += blockAt(offset)->size) {
+    const BlockHeader* block = blockAt(offset);
+    if (block->used) continue;
+    largest = std::max(largest, block->size - sizeof(BlockHeader));
+    sum += block->size - sizeof(BlockHeader);
+  }
+  if (total) *total = sum;
+  return largest;
+}
+
+struct Result {
+  size_t before = 0;       // Largest free block once the book is open
+  size_t minimum = 0;      // Smallest largest free block over the session
+  size_t atIndexing = 0;   // Smallest largest free block a section build started with
+  size_t after = 0;        // Largest free block after the last page
+  size_t totalFree = 0;    // Free bytes after the last page
+  size_t calls = 0;        // malloc and free calls during the session
+  int windowFailures = 0;  // Section builds that found no room for the inflate window
+  int heldBackups = 0;     // Pages that ended with heap still taken by the BW backup
+};
+
+// One session; `antiAliased` adds the grayscale pass and its BW backup the way the readers do
+Result session(const bool antiAliased) {
+  HalDisplay display;
+  GfxRenderer renderer(display);
+  display.begin();
+  renderer.begin();
+  EpdFont font(&ubuntu_12_regular);
+  renderer.insertFont(1, EpdFontFamily(&font));
+
+  std::mt19937 rng(7);
+  std::vector<std::string> words;
+  for (int i = 0; i < 400; i++) {
+    std::string word;
+    for (int k = 2 + rng() % 9; k > 0; k--) word += static_cast<char>('a' + rng() % 26);
+    words.push_back(word);
+  }
+
+  Result result;
+  arenaReset();
+  arenaOn = true;
+  {
+    // Book, metadata and caches that live for the session
+    std::vector<void*> resident;
+    for (int i = 0; i < 40; i++) resident.push_back(malloc(64 + rng() % 1500));
+    result.before = largestFree();
+    result.minimum = result.before;
+    result.atIndexing = SIZE_MAX;
+
+    // Current and prefetched page, and what the section keeps between builds
+    const auto loadPage = [&]() {
+      std::vector<void*> elements;
+      for (int i = 90 + rng() % 60; i > 0; i--) elements.push_back(malloc(24 + rng() % 220));
+      return elements;
+    };
+    std::vector<std::vector<void*>> pages{loadPage()};
+    std::vector<void*> sectionState;
+    GlyphDisplayList glyphs;
+
+    for (int page = 0; page < PAGES; page++) {
+      if (page % PAGES_PER_SECTION == 0) {
+        for (void* p : sectionState) free(p);
+        sectionState.clear();
+        result.atIndexing = std::min(result.atIndexing, largestFree());
+        void* window = malloc(INFLATE_WINDOW);
+        if (!window) result.windowFailures++;
+        std::vector<void*> parse;
+        for (int i = 0; i < 250; i++) {
+          parse.push_back(malloc(16 + rng() % 400));
+          if (rng() % 3 == 0) {
+            const size_t k = rng() % parse.size();
+            free(parse[k]);
+            parse[k] = parse.back();
+            parse.pop_back();
+          }
+        }
+        for (int i = 0; i < 20; i++) sectionState.push_back(malloc(32 + rng() % 600));
+        for (void* p : parse) free(p);
+        free(window);
+      }
+
+      // BW pass with glyph capture, then both grayscale planes replayed over the backed-up frame
+      renderer.clearScreen();
+      renderer.beginGlyphCapture(glyphs);
+      for (int line = 0; line < 28; line++) {
+        std::string text;
+        while (text.size() < 60) text += words[rng() % words.size()] + " ";
+        renderer.drawText(1, 20, 20 + line * 27, text.c_str(), true);
+      }
+      renderer.endGlyphCapture();
+      if (antiAliased) {
+        size_t freeBefore, freeAfter;
+        largestFree(&freeBefore);
+        renderer.storeBwBuffer();
+        renderer.clearScreen(0x00);
+        renderer.setRenderMode(GfxRenderer::GRAYSCALE_LSB);
+        renderer.replayGlyphs(glyphs);
+        renderer.clearScreen(0x00);
+        renderer.setRenderMode(GfxRenderer::GRAYSCALE_MSB);
+        renderer.replayGlyphs(glyphs);
+        renderer.setRenderMode(GfxRenderer::BW);
+        renderer.restoreBwBuffer();
+        largestFree(&freeAfter);
+        if (freeAfter != freeBefore) result.heldBackups++;
+      }
+
+      // Progress path and the prefetch of the next page
+      std::string path = "/.crosspoint/epub_123456/progress.bin" + std::to_string(page);
+      pages.push_back(loadPage());
+      for (void* p : pages.front()) free(p);
+      pages.erase(pages.begin());
+      result.minimum = std::min(result.minimum, largestFree());
+    }
+    result.after = largestFree(&result.totalFree);
+    result.calls = heapCalls;
+
+    for (const auto& elements : pages) {
+      for (void* p : elements) free(p);
+    }
+    for (void* p : sectionState) free(p);
+    for (void* p : resident) free(p);
+  }
+  arenaOn = false;
+  return result;
+}
+
+}  // namespace
+
+// Every allocation while the model is on, from the renderer as much as from the session, comes out of the arena
+extern "C" void* malloc(const size_t n) { return arenaOn ? arenaAlloc(n) : __libc_malloc(n); }
+extern "C" void free(void* p) {
+  if (!p) return;
+  if (inArena(p)) {
+    arenaFree(p);
+  } else {
+    __libc_free(p);
+  }
+}
+extern "C" void* calloc(const size_t count, const size_t size) {
+  void* p = malloc(count * size);
+  if (p) memset(p, 0, count * size);
+  return p;
+}
+extern "C" void* realloc(void* p, const size_t n) {
+  if (!p) return malloc(n);
+  if (!inArena(p)) return __libc_realloc(p, n);
+  void* q = malloc(n);
+  if (!q) return nullptr;
+  const size_t old = (static_cast<BlockHeader*>(p) - 1)->size - sizeof(BlockHeader);
+  memcpy(q, p, std::min(old, n));
+  free(p);
+  return q;
+}
+
+int main() {
+  const Result bw = session(false);
+  const Result aa = session(true);
+  check(bw.windowFailures == 0 && aa.windowFailures == 0, "every section build finds its inflate window");
+  check(aa.heldBackups == 0, "the BW backup is freed after every grayscale pass");
+  check(aa.atIndexing >= bw.atIndexing, "the backup leaves indexing no less room");
+  check(aa.after >= bw.after, "the backup leaves the largest free block no worse after the session");
+
+  printf("%d pages, section build every %d, %zuKB first-fit heap: black and white -> anti-aliased (%zu byte backup)\n",
+         PAGES, PAGES_PER_SECTION, ARENA / 1024, BW_BUFFER);
+  printf("  largest free block once open   %7zu -> %7zu\n", bw.before, aa.before);
+  printf("  largest free block at indexing %7zu -> %7zu\n", bw.atIndexing, aa.atIndexing);
+  printf("  session minimum                %7zu -> %7zu\n", bw.minimum, aa.minimum);
+  printf("  largest free block after       %7zu -> %7zu  (total free %zu -> %zu)\n", bw.after, aa.after,
+         bw.totalFree, aa.totalFree);
+  printf("  heap calls                     %7zu -> %7zu\n", bw.calls, aa.calls);
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
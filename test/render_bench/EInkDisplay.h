@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Host stand-in for the panel driver: a framebuffer in RAM and refreshes that return straight away
+class EInkDisplay {
+ public:
+  static constexpr uint16_t DISPLAY_WIDTH = 800;
+  static constexpr uint16_t DISPLAY_HEIGHT = 480;
+  static constexpr uint16_t DISPLAY_WIDTH_BYTES = DISPLAY_WIDTH / 8;
+  static constexpr uint32_t BUFFER_SIZE = DISPLAY_WIDTH_BYTES * DISPLAY_HEIGHT;
+
+  enum RefreshMode { FULL_REFRESH, HALF_REFRESH, FAST_REFRESH };
+
+  EInkDisplay(int, int, int, int, int, int) {}
+
+  void begin() {}
+  void clearScreen(const uint8_t color) const { memset(frameBuffer, color, BUFFER_SIZE); }
+  void drawImage(const uint8_t*, uint16_t, uint16_t, uint16_t, uint16_t, bool) const {}
+  void drawImageTransparent(const uint8_t*, uint16_t, uint16_t, uint16_t, uint16_t, bool) const {}
+  void displayBuffer(RefreshMode, bool) {}
+  void refreshDisplay(RefreshMode, bool) {}
+  void displayWindow(uint16_t, uint16_t, uint16_t, uint16_t, bool) {}
+  void displayGrayBuffer(bool) {}
+  void copyGrayscaleBuffers(const uint8_t*, const uint8_t*) {}
+  void copyGrayscaleLsbBuffers(const uint8_t*) {}
+  void copyGrayscaleMsbBuffers(const uint8_t*) {}
+  void cleanupGrayscaleBuffers(const uint8_t*) {}
+  void deepSleep() {}
+  uint8_t* getFrameBuffer() const { return frameBuffer; }
+
+ private:
+  static inline uint8_t frameBuffer[BUFFER_SIZE];
+};
@@ -0,0 +1,326 @@
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+
+#include <algorithm>
+#include <cstdio>
+
+// Renders primitive sequences modelled on the Lyra home and settings screens (header, battery, cover tile, menu
+// buttons, tab bar, list rows, dithered fills, button hints) through GfxRenderer's row-span fills and through a
+// per-pixel reference that mirrors the drawPixel loops the renderer used before, in all four orientations. Reports
+// the time per screen and checks both leave the same framebuffer. Host timings: the ratio is what carries over to the
+// device, not the absolute numbers.
+
+namespace {
+
+constexpr int REPEATS = 200;
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+uint64_t fnv(const uint8_t* data, const size_t size) {
+  uint64_t h = 1469598103934665603ull;
+  for (size_t i = 0; i < size; i++) {
+    h ^= data[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+// The primitives as they were before the span fills: everything ends in drawPixel
+class Reference {
+ public:
+  explicit Reference(const GfxRenderer& renderer) : renderer(renderer) {}
+
+  void clearScreen() const { renderer.clearScreen(); }
+  int getScreenWidth() const { return renderer.getScreenWidth(); }
+  int getScreenHeight() const { return renderer.getScreenHeight(); }
+
+  void drawLine(int x1, int y1, int x2, int y2, const bool state = true) const {
+    if (x1 == x2) {
+      if (y2 < y1) std::swap(y1, y2);
+      for (int y = y1; y <= y2; y++) renderer.drawPixel(x1, y, state);
+    } else if (y1 == y2) {
+      if (x2 < x1) std::swap(x1, x2);
+      for (int x = x1; x <= x2; x++) renderer.drawPixel(x, y1, state);
+    } else {
+      int dx = x2 - x1;
+      int dy = y2 - y1;
+      const int sx = dx > 0 ? 1 : -1;
+      const int sy = dy > 0 ? 1 : -1;
+      dx *= sx;
+      dy *= sy;
+      int err = dx - dy;
+      while (true) {
+        renderer.drawPixel(x1, y1, state);
+        if (x1 == x2 && y1 == y2) break;
+        const int e2 = 2 * err;
+        if (e2 > -dy) {
+          err -= dy;
+          x1 += sx;
+        }
+        if (e2 < dx) {
+          err += dx;
+          y1 += sy;
+        }
+      }
+    }
+  }
+
+  void drawLine(const int x1, const int y1, const int x2, const int y2, const int lineWidth, const bool state) const {
+    for (int i = 0; i < lineWidth; i++) drawLine(x1, y1 + i, x2, y2 + i, state);
+  }
+
+  void drawRect(const int x, const int y, const int width, const int height, const int lineWidth,
+                const bool state) const {
+    for (int i = 0; i < lineWidth; i++) {
+      drawLine(x + i, y + i, x + width - i, y + i, state);
+      drawLine(x + width - i, y + i, x + width - i, y + height - i, state);
+      drawLine(x + width - i, y + height - i, x + i, y + height - i, state);
+      drawLine(x + i, y + height - i, x + i, y + i, state);
+    }
+  }
+
+  void fillRect(const int x, const int y, const int width, const int height, const bool state = true) const {
+    for (int fillY = y; fillY < y + height; fillY++) drawLine(x, fillY, x + width - 1, fillY, state);
+  }
+
+  void fillRectDither(const int x, const int y, const int width, const int height, const Color color) const {
+    if (color == Color::Black || color == Color::White) {
+      fillRect(x, y, width, height, color == Color::Black);
+      return;
+    }
+    for (int fillY = y; fillY < y + height; fillY++) {
+      for (int fillX = x; fillX < x + width; fillX++) ditherPixel(fillX, fillY, color);
+    }
+  }
+
+  void drawRoundedRect(const int x, const int y, const int width, const int height, const int lineWidth,
+                       const int cornerRadius, const bool state) const {
+    drawRoundedRect(x, y, width, height, lineWidth, cornerRadius, true, true, true, true, state);
+  }
+
+  void drawRoundedRect(const int x, const int y, const int width, const int height, const int lineWidth,
+                       const int cornerRadius, const bool roundTopLeft, const bool roundTopRight,
+                       const bool roundBottomLeft, const bool roundBottomRight, const bool state) const {
+    if (lineWidth <= 0 || width <= 0 || height <= 0) return;
+    const int maxRadius = std::min({cornerRadius, width / 2, height / 2});
+    if (maxRadius <= 0) {
+      drawRect(x, y, width, height, lineWidth, state);
+      return;
+    }
+    const int stroke = std::min(lineWidth, maxRadius);
+    const int right = x + width - 1;
+    const int bottom = y + height - 1;
+    const int horizontalWidth = width - 2 * maxRadius;
+    if (horizontalWidth > 0) {
+      if (roundTopLeft || roundTopRight) fillRect(x + maxRadius, y, horizontalWidth, stroke, state);
+      if (roundBottomLeft || roundBottomRight) fillRect(x + maxRadius, bottom - stroke + 1, horizontalWidth, stroke, state);
+    }
+    const int verticalHeight = height - 2 * maxRadius;
+    if (verticalHeight > 0) {
+      if (roundTopLeft || roundBottomLeft) fillRect(x, y + maxRadius, stroke, verticalHeight, state);
+      if (roundTopRight || roundBottomRight) fillRect(right - stroke + 1, y + maxRadius, stroke, verticalHeight, state);
+    }
+    if (roundTopLeft) drawArc(maxRadius, x + maxRadius, y + maxRadius, -1, -1, lineWidth, state);
+    if (roundTopRight) drawArc(maxRadius, right - maxRadius, y + maxRadius, 1, -1, lineWidth, state);
+    if (roundBottomRight) drawArc(maxRadius, right - maxRadius, bottom - maxRadius, 1, 1, lineWidth, state);
+    if (roundBottomLeft) drawArc(maxRadius, x + maxRadius, bottom - maxRadius, -1, 1, lineWidth, state);
+  }
+
+  void fillRoundedRect(const int x, const int y, const int width, const int height, const int cornerRadius,
+                       const Color color) const {
+    if (width <= 0 || height <= 0) return;
+    const int maxRadius = std::min({cornerRadius, width / 2, height / 2});
+    if (maxRadius <= 0) {
+      fillRectDither(x, y, width, height, color);
+      return;
+    }
+    const int horizontalWidth = width - 2 * maxRadius;
+    if (horizontalWidth > 0) fillRectDither(x + maxRadius + 1, y, horizontalWidth - 2, height, color);
+    const int sideHeight = height - 2 * (maxRadius + 1);
+    if (sideHeight > 0) {
+      fillRectDither(x, y + maxRadius + 1, maxRadius + 1, sideHeight, color);
+      fillRectDither(x + width - maxRadius - 1, y + maxRadius + 1, maxRadius + 1, sideHeight, color);
+    }
+    fillArc(maxRadius, x + maxRadius, y + maxRadius, -1, -1, color);
+    fillArc(maxRadius, x + width - maxRadius - 1, y + maxRadius, 1, -1, color);
+    fillArc(maxRadius, x + width - maxRadius - 1, y + height - maxRadius - 1, 1, 1, color);
+    fillArc(maxRadius, x + maxRadius, y + height - maxRadius - 1, -1, 1, color);
+  }
+
+ private:
+  const GfxRenderer& renderer;
+
+  void ditherPixel(const int x, const int y, const Color color) const {
+    switch (color) {
+      case Color::Clear:
+        break;
+      case Color::Black:
+        renderer.drawPixel(x, y, true);
+        break;
+      case Color::White:
+        renderer.drawPixel(x, y, false);
+        break;
+      case Color::LightGray:
+        renderer.drawPixel(x, y, x % 2 == 0 && y % 2 == 0);
+        break;
+      case Color::DarkGray:
+        renderer.drawPixel(x, y, (x + y) % 2 == 0);
+        break;
+    }
+  }
+
+  void drawArc(const int maxRadius, const int cx, const int cy, const int xDir, const int yDir, const int lineWidth,
+               const bool state) const {
+    const int innerRadius = std::max(maxRadius - std::min(lineWidth, maxRadius), 0);
+    for (int dy = 0; dy <= maxRadius; dy++) {
+      for (int dx = 0; dx <= maxRadius; dx++) {
+        const int distSq = dx * dx + dy * dy;
+        if (distSq <= maxRadius * maxRadius && distSq >= innerRadius * innerRadius) {
+          renderer.drawPixel(cx + xDir * dx, cy + yDir * dy, state);
+        }
+      }
+    }
+  }
+
+  void fillArc(const int maxRadius, const int cx, const int cy, const int xDir, const int yDir,
+               const Color color) const {
+    for (int dy = 0; dy <= maxRadius; dy++) {
+      for (int dx = 0; dx <= maxRadius; dx++) {
+        if (dx * dx + dy * dy <= maxRadius * maxRadius) ditherPixel(cx + xDir * dx, cy + yDir * dy, color);
+      }
+    }
+  }
+};
+
+template <typename Canvas>
+void battery(const Canvas& c, const int x, const int y) {
+  c.drawLine(x + 1, y, x + 12, y);
+  c.drawLine(x + 1, y + 11, x + 12, y + 11);
+  c.drawLine(x, y + 1, x, y + 10);
+  c.drawLine(x + 13, y + 1, x + 13, y + 10);
+  c.drawLine(x + 15, y + 4, x + 15, y + 7);
+  for (int bar = 0; bar < 3; bar++) c.fillRect(x + 2 + bar * 4, y + 2, 3, 8);
+}
+
+template <typename Canvas>
+void header(const Canvas& c) {
+  const int w = c.getScreenWidth();
+  c.fillRect(0, 0, w, 50, false);
+  battery(c, w - 40, 15);
+  c.drawLine(0, 49, w - 1, 49, 3, true);
+}
+
+template <typename Canvas>
+void buttonHints(const Canvas& c) {
+  const int w = c.getScreenWidth();
+  const int h = c.getScreenHeight();
+  for (int i = 0; i < 4; i++) {
+    const int x = 20 + i * (w - 40) / 4;
+    c.fillRect(x, h - 40, (w - 40) / 4 - 8, 40, false);
+    c.drawRoundedRect(x, h - 40, (w - 40) / 4 - 8, 44, 1, 6, true, true, false, false, true);
+  }
+}
+
+template <typename Canvas>
+void homeScreen(const Canvas& c) {
+  const int w = c.getScreenWidth();
+  c.clearScreen();
+  header(c);
+  // Cover tile, progress bar and menu buttons
+  c.fillRoundedRect(12, 56, w - 24, 242, 6, Color::LightGray);
+  c.drawRect(24, 64, 150, 226, 2, true);
+  c.fillRect(30, 300, w - 60, 16, false);
+  c.drawRoundedRect(30, 300, w - 60, 16, 1, 8, true);
+  c.fillRoundedRect(30, 300, (w - 60) / 3, 16, 8, Color::Black);
+  for (int i = 0; i < 4; i++) {
+    if (i == 1) c.fillRoundedRect(12, 330 + i * 60, w - 24, 52, 6, Color::LightGray);
+    c.drawRoundedRect(12, 330 + i * 60, w - 24, 52, 1, 6, true);
+  }
+  buttonHints(c);
+}
+
+template <typename Canvas>
+void settingsScreen(const Canvas& c) {
+  const int w = c.getScreenWidth();
+  const int h = c.getScreenHeight();
+  c.clearScreen();
+  header(c);
+  // Tab bar
+  c.fillRectDither(0, 50, w, 40, Color::LightGray);
+  for (int i = 0; i < 4; i++) {
+    const int x = 10 + i * 110;
+    if (i == 0) {
+      c.fillRoundedRect(x, 51, 100, 36, 6, Color::Black);
+    } else {
+      c.fillRectDither(x, 50, 100, 37, Color::LightGray);
+    }
+    c.drawLine(x, 87, x + 99, 87, 3, true);
+  }
+  c.drawLine(0, 89, w - 1, 89, true);
+  // List rows with a highlight, value chips and a scroll bar
+  for (int i = 0; i < 12; i++) {
+    if (i == 3) c.fillRoundedRect(8, 96 + i * 52, w - 30, 52, 6, Color::LightGray);
+    c.drawLine(16, 96 + i * 52 + 51, w - 40, 96 + i * 52 + 51, true);
+    c.fillRectDither(w - 120, 96 + i * 52 + 12, 80, 28, Color::DarkGray);
+  }
+  c.drawLine(w - 10, 96, w - 10, h - 50, true);
+  c.fillRect(w - 14, 150, 4, 120);
+  buttonHints(c);
+}
+
+// Microseconds per screen over REPEATS renders; `hash` gets the framebuffer after the last one
+template <typename Canvas>
+double renderScreens(const GfxRenderer& renderer, const Canvas& canvas, void (*screen)(const Canvas&),
+                     uint64_t& hash) {
+  const unsigned long start = micros();
+  for (int i = 0; i < REPEATS; i++) screen(canvas);
+  const double perScreen = static_cast<double>(micros() - start) / REPEATS;
+  hash = fnv(renderer.getFrameBuffer(), HalDisplay::BUFFER_SIZE);
+  return perScreen;
+}
+
+}  // namespace
+
+int main() {
+  HalDisplay display;
+  GfxRenderer renderer(display);
+  display.begin();
+  renderer.begin();
+  const Reference reference(renderer);
+
+  const char* const orientations[] = {"portrait", "landscape CW", "portrait inv", "landscape CCW"};
+  const struct {
+    const char* name;
+    void (*spans)(const GfxRenderer&);
+    void (*pixels)(const Reference&);
+  } screens[] = {{"home", homeScreen<GfxRenderer>, homeScreen<Reference>},
+                 {"settings", settingsScreen<GfxRenderer>, settingsScreen<Reference>}};
+
+  printf("us per screen, per-pixel path -> row spans, %d renders each\n", REPEATS);
+  for (const auto& screen : screens) {
+    double pixelTotal = 0, spanTotal = 0;
+    for (int o = 0; o < 4; o++) {
+      renderer.setOrientation(static_cast<GfxRenderer::Orientation>(o));
+      uint64_t pixelHash, spanHash;
+      const double pixels = renderScreens(renderer, reference, screen.pixels, pixelHash);
+      const double spans = renderScreens(renderer, renderer, screen.spans, spanHash);
+      check(pixelHash == spanHash, "row spans match the per-pixel path");
+      printf("  %-8s %-13s %8.1f -> %6.1f  (%.1fx)  checksum %016llx\n", screen.name, orientations[o], pixels, spans,
+             pixels / spans, static_cast<unsigned long long>(spanHash));
+      pixelTotal += pixels;
+      spanTotal += spans;
+    }
+    printf("  %-8s all           %8.1f -> %6.1f  (%.1fx)\n", screen.name, pixelTotal / 4, spanTotal / 4,
+           pixelTotal / spanTotal);
+  }
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include <GfxRenderer.h>
+#include <HalDisplay.h>
+#include <Utf8.h>
+#include <builtinFonts/bookerly_14_regular.h>
+#include <builtinFonts/ubuntu_12_regular.h>
+
+#include <cstdio>
+
+// Draws the same lines of text through GfxRenderer's span blitter and through a per-pixel rasterizer that mirrors the
+// drawPixel loop the renderer used before, in all four orientations, all three render modes, black and white text,
+// with a 2-bit font (bookerly) and a 1-bit one (ubuntu). Reports glyph pixels per microsecond for both and checks
+// the framebuffers match. Host timings: the ratio is what carries over to the device, not the absolute numbers.
+
+namespace {
+
+constexpr int TWO_BIT_FONT = 1;
+constexpr int ONE_BIT_FONT = 2;
+constexpr int REPEATS = 100;
+
+// No combining marks, so the reference can place glyphs by advance alone
+const char* const LINE = "The quick brown fox jumps over the lazy dog, 0123456789 — “½ café”";
+
+int failures = 0;
+
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    failures++;
+  }
+}
+
+uint64_t fnv(const uint8_t* data, const size_t size) {
+  uint64_t h = 1469598103934665603ull;
+  for (size_t i = 0; i < size; i++) {
+    h ^= data[i];
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+// The per-pixel glyph loop of renderGlyphImpl before the span blitter: every bit through drawPixel
+void referenceText(const GfxRenderer& renderer, const EpdFontFamily& family, const int x, const int y,
+                   const char* text, const bool black, long& pixels) {
+  const EpdFontData* fontData = family.getData();
+  int cursorX = x;
+  const int cursorY = y + fontData->ascender;
+  uint32_t cp;
+  while ((cp = utf8NextCodepoint(reinterpret_cast<const uint8_t**>(&text)))) {
+    const EpdGlyph* glyph = family.getGlyph(cp);
+    if (!glyph) glyph = family.getGlyph(REPLACEMENT_GLYPH);
+    if (!glyph) continue;
+
+    const uint8_t* bitmap = renderer.getGlyphBitmap(fontData, glyph);
+    if (bitmap) {
+      int pixelPosition = 0;
+      for (int glyphY = 0; glyphY < glyph->height; glyphY++) {
+        const int screenY = cursorY - glyph->top + glyphY;
+        for (int glyphX = 0; glyphX < glyph->width; glyphX++, pixelPosition++) {
+          const int screenX = cursorX + glyph->left + glyphX;
+          if (fontData->is2Bit) {
+            const uint8_t bmpVal = 3 - ((bitmap[pixelPosition >> 2] >> ((3 - (pixelPosition & 3)) * 2)) & 0x3);
+            if (renderer.getRenderMode() == GfxRenderer::BW && bmpVal < 3) {
+              renderer.drawPixel(screenX, screenY, black);
+            } else if (renderer.getRenderMode() == GfxRenderer::GRAYSCALE_MSB && (bmpVal == 1 || bmpVal == 2)) {
+              renderer.drawPixel(screenX, screenY, false);
+            } else if (renderer.getRenderMode() == GfxRenderer::GRAYSCALE_LSB && bmpVal == 1) {
+              renderer.drawPixel(screenX, screenY, false);
+            }
+          } else if ((bitmap[pixelPosition >> 3] >> (7 - (pixelPosition & 7))) & 1) {
+            renderer.drawPixel(screenX, screenY, black);
+          }
+        }
+      }
+      pixels += glyph->width * glyph->height;
+    }
+    cursorX += glyph->advanceX;
+  }
+}
+
+struct Run {
+  double micros = 0;
+  long pixels = 0;
+  uint64_t hash = 0;
+};
+
+// Lines of text over the whole screen, alternating black and white text, all glyphs fully on screen
+template <bool reference>
+Run drawScreen(const GfxRenderer& renderer, const int fontId, const EpdFontFamily& family) {
+  Run run;
+  const int lineHeight = renderer.getLineHeight(fontId);
+  unsigned long drawing = 0;
+  for (int repeat = 0; repeat < REPEATS; repeat++) {
+    renderer.clearScreen(renderer.getRenderMode() == GfxRenderer::BW ? 0xFF : 0x00);
+    const unsigned long start = micros();
+    for (int line = 0, y = 4; y + lineHeight < renderer.getScreenHeight(); line++, y += lineHeight) {
+      const int x = 4 + (line * 7) % 13;  // Every bit phase of the panel bytes
+      const bool black = line % 5 != 4;
+      if constexpr (reference) {
+        long pixels = 0;
+        referenceText(renderer, family, x, y, LINE, black, pixels);
+        if (repeat == 0) run.pixels += pixels;
+      } else {
+        renderer.drawText(fontId, x, y, LINE, black);
+      }
+    }
+    drawing += micros() - start;
+  }
+  run.micros = static_cast<double>(drawing) / REPEATS;
+  run.hash = fnv(renderer.getFrameBuffer(), HalDisplay::BUFFER_SIZE);
+  return run;
+}
+
+}  // namespace
+
+int main() {
+  HalDisplay display;
+  GfxRenderer renderer(display);
+  display.begin();
+  renderer.begin();
+  FontDecompressor decompressor;
+  decompressor.init();
+  renderer.setFontDecompressor(&decompressor);
+
+  EpdFont twoBit(&bookerly_14_regular);
+  EpdFont oneBit(&ubuntu_12_regular);
+  const EpdFontFamily twoBitFamily(&twoBit);
+  const EpdFontFamily oneBitFamily(&oneBit);
+  renderer.insertFont(TWO_BIT_FONT, twoBitFamily);
+  renderer.insertFont(ONE_BIT_FONT, oneBitFamily);
+
+  const char* const orientations[] = {"portrait", "landscape CW", "portrait inv", "landscape CCW"};
+  const char* const modes[] = {"BW", "gray LSB", "gray MSB"};
+  const struct {
+    int id;
+    const EpdFontFamily* family;
+    const char* name;
+  } fonts[] = {{TWO_BIT_FONT, &twoBitFamily, "2-bit"}, {ONE_BIT_FONT, &oneBitFamily, "1-bit"}};
+
+  printf("glyph pixels per us, per-pixel path -> span blitter\n");
+  for (const auto& font : fonts) {
+    double referenceTotal = 0, blitTotal = 0;
+    long pixelTotal = 0;
+    for (int o = 0; o < 4; o++) {
+      renderer.setOrientation(static_cast<GfxRenderer::Orientation>(o));
+      for (int m = 0; m < 3; m++) {
+        renderer.setRenderMode(static_cast<GfxRenderer::RenderMode>(m));
+        const Run reference = drawScreen<true>(renderer, font.id, *font.family);
+        const Run blit = drawScreen<false>(renderer, font.id, *font.family);
+        check(reference.hash == blit.hash, "span blitter matches the per-pixel path");
+        printf("  %s %-13s %-8s %6.1f -> %6.1f  (%.2fx)  checksum %016llx\n", font.name, orientations[o], modes[m],
+               reference.pixels / reference.micros, reference.pixels / blit.micros, reference.micros / blit.micros,
+               static_cast<unsigned long long>(blit.hash));
+        referenceTotal += reference.micros;
+        blitTotal += blit.micros;
+        pixelTotal += reference.pixels;
+      }
+    }
+    printf("  %s all           %6.1f -> %6.1f  (%.2fx)\n", font.name, pixelTotal / referenceTotal,
+           pixelTotal / blitTotal, referenceTotal / blitTotal);
+  }
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// Host stand-in: the display pins are only used by the device driver
+#define EPD_SCLK 8
+#define EPD_MOSI 10
+#define EPD_CS 21
+#define EPD_DC 4
+#define EPD_RST 5
+#define EPD_BUSY 6
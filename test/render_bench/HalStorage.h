@@ -0,0 +1,119 @@
+#pragma once
+
+#include <Arduino.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Host stand-in for the HAL, picked up ahead of the real HalStorage.h: files live in memory, so benchmarks that read
+// bitmaps or caches time the renderer rather than a card. Handles have the device's modes: openFileForRead is
+// read-only, openFileForWrite read-write (sealing reads back what it wrote) and truncates the file in place.
+
+class FsFile {
+ public:
+  FsFile() = default;
+  FsFile(std::shared_ptr<std::vector<uint8_t>> data, const bool writable)
+      : data(std::move(data)), writable(writable) {}
+
+  int read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+  }
+  int read(void* buf, const size_t count) {
+    if (!data) return -1;
+    const size_t n = pos < data->size() ? std::min(count, data->size() - pos) : 0;
+    memcpy(buf, data->data() + pos, n);
+    pos += n;
+    return static_cast<int>(n);
+  }
+
+  size_t write(const uint8_t b) { return write(&b, 1); }
+  size_t write(const void* buf, const size_t count) {
+    if (!data || !writable) return 0;
+    if (pos + count > data->size()) data->resize(pos + count);
+    memcpy(data->data() + pos, buf, count);
+    pos += count;
+    return count;
+  }
+
+  bool seek(const uint64_t p) {
+    if (!data || p > data->size()) return false;
+    pos = p;
+    return true;
+  }
+  bool seekCur(const int64_t offset) { return seek(pos + offset); }
+  int available() const { return data && pos < data->size() ? static_cast<int>(data->size() - pos) : 0; }
+
+  uint64_t position() const { return pos; }
+  uint64_t size() const { return data ? data->size() : 0; }
+  uint64_t fileSize() const { return size(); }
+  // Files in memory carry no timestamps
+  bool getModifyDateTime(uint16_t*, uint16_t*) const { return false; }
+  bool close() {
+    data.reset();
+    pos = 0;
+    return true;
+  }
+  explicit operator bool() const { return data != nullptr; }
+
+ private:
+  std::shared_ptr<std::vector<uint8_t>> data;
+  bool writable = false;
+  size_t pos = 0;
+};
+
+class HalStorage {
+ public:
+  std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+
+  bool exists(const char* path) { return files.count(path) != 0; }
+  bool remove(const char* path) { return files.erase(path) != 0; }
+  bool replace(const char* tmpPath, const char* path) {
+    const auto it = files.find(tmpPath);
+    if (it == files.end()) return false;
+    files[path] = it->second;
+    files.erase(it);
+    return true;
+  }
+
+  bool openFileForRead(const char*, const std::string& path, FsFile& file) {
+    const auto it = files.find(path);
+    if (it == files.end()) return false;
+    file = FsFile(it->second, false);
+    return true;
+  }
+  bool openFileForRead(const char* moduleName, const char* path, FsFile& file) {
+    return openFileForRead(moduleName, std::string(path), file);
+  }
+  bool openFileForWrite(const char*, const std::string& path, FsFile& file) {
+    auto& data = files[path];
+    if (data) {
+      data->clear();
+    } else {
+      data = std::make_shared<std::vector<uint8_t>>();
+    }
+    file = FsFile(data, true);
+    return true;
+  }
+  bool openFileForWrite(const char* moduleName, const char* path, FsFile& file) {
+    return openFileForWrite(moduleName, std::string(path), file);
+  }
+
+  int read(FsFile& file, void* buffer, const size_t count) { return file.read(buffer, count); }
+  size_t write(FsFile& file, const void* buffer, const size_t count) { return file.write(buffer, count); }
+  bool seek(FsFile& file, const uint64_t position) { return file.seek(position); }
+  bool close(FsFile& file) { return file.close(); }
+
+  static HalStorage& getInstance() {
+    static HalStorage instance;
+    return instance;
+  }
+};
+
+#define Storage HalStorage::getInstance()
@@ -0,0 +1,19 @@
+#include <Arduino.h>
+
+#include <chrono>
+
+// Definitions behind the stub Arduino.h, shared by the renderer benchmarks
+
+namespace {
+const auto start = std::chrono::steady_clock::now();
+}
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void delay(unsigned long) {}
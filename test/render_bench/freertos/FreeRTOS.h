@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdint>
+
+// Host stand-in: the renderer benchmarks run on one thread, so tasks and semaphores do nothing
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define portMAX_DELAY 0xffffffff
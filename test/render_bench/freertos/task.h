@@ -0,0 +1,11 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+inline BaseType_t xTaskCreate(void (*)(void*), const char*, uint32_t, void*, UBaseType_t, TaskHandle_t* handle) {
+  if (handle) *handle = nullptr;
+  return pdTRUE;
+}
+inline void vTaskDelete(TaskHandle_t) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
+inline BaseType_t xTaskNotifyGive(TaskHandle_t) { return pdTRUE; }
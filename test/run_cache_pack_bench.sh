@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/cache_pack_bench"
+BINARY="$BUILD_DIR/CachePackBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+SOURCES=(
+  "$ROOT_DIR/test/cache_pack_bench/CachePackBenchmark.cpp"
+  "$ROOT_DIR/lib/Epub/Epub/CachePack.cpp"
+)
+
+# The bench directory comes first so its card model HalStorage.h stands in for the device one
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -Wno-unused-function
+  -I"$ROOT_DIR/test/cache_pack_bench"
+  -I"$ROOT_DIR/lib/Serialization"
+  -I"$ROOT_DIR/lib/Epub"
+)
+
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" -o "$BINARY"
+
+"$BINARY" "$@"
@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/inflate_bench"
+BINARY="$BUILD_DIR/InflateBenchmark"
+
+mkdir -p "$BUILD_DIR"
+
+# uzlib's checksum helpers aren't vendored; unused sections are dropped at link time like on the device
+cc -std=c99 -O2 -ffunction-sections -c "$ROOT_DIR/lib/uzlib/src/tinflate.c" -o "$BUILD_DIR/tinflate.o"
+
+SOURCES=(
+  "$ROOT_DIR/test/inflate_bench/InflateBenchmark.cpp"
+  "$ROOT_DIR/lib/InflateReader/InflateReader.cpp"
+  "$BUILD_DIR/tinflate.o"
+)
+
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -Wno-bidi-chars
+  -Wl,--gc-sections
+  -DTEST_EPUB_DIR="\"$ROOT_DIR/test/epubs\""
+  -I"$ROOT_DIR/lib/InflateReader"
+  -I"$ROOT_DIR/lib/uzlib/src"
+  -I"$ROOT_DIR/lib/EpdFont"
+)
+
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" -o "$BINARY"
+
+"$BINARY" "$@"
@@ -0,0 +1,33 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/inflate_window_heap_model"
+BINARY="$BUILD_DIR/InflateWindowHeapModel"
+
+mkdir -p "$BUILD_DIR"
+
+cc -std=c99 -O2 -ffunction-sections -c "$ROOT_DIR/lib/uzlib/src/tinflate.c" -o "$BUILD_DIR/tinflate.o"
+
+SOURCES=(
+  "$ROOT_DIR/test/inflate_window_heap_model/InflateWindowHeapModel.cpp"
+  "$ROOT_DIR/lib/InflateReader/InflateReader.cpp"
+  "$BUILD_DIR/tinflate.o"
+)
+
+# The model replaces malloc and free, which the compiler must not optimise around
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -fno-builtin-malloc
+  -fno-builtin-free
+  -Wl,--gc-sections
+  -I"$ROOT_DIR/lib/InflateReader"
+  -I"$ROOT_DIR/lib/uzlib/src"
+)
+
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" -o "$BINARY"
+
+"$BINARY" "$@"
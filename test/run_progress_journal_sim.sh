@@ -0,0 +1,27 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+ROOT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+BUILD_DIR="$ROOT_DIR/build/progress_journal_sim"
+BINARY="$BUILD_DIR/ProgressJournalSimulation"
+
+mkdir -p "$BUILD_DIR"
+
+SOURCES=(
+  "$ROOT_DIR/test/progress_journal_sim/ProgressJournalSimulation.cpp"
+  "$ROOT_DIR/src/activities/reader/ProgressJournal.cpp"
+)
+
+# The test directory comes first so its timed card model stands in for the HAL
+CXXFLAGS=(
+  -std=c++20
+  -O2
+  -Wall
+  -Wextra
+  -I"$ROOT_DIR/test/progress_journal_sim"
+  -I"$ROOT_DIR/src/activities/reader"
+)
+
+c++ "${CXXFLAGS[@]}" "${SOURCES[@]}" -o "$BINARY"
+
+"$BINARY" "$@"
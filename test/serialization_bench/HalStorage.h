@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// Host stand-in for the HAL's FsFile, picked up ahead of the real HalStorage.h: an in-memory file that counts the
+// calls made on it. Each counted call is one trip into the SD driver on the device.
+struct DriverCalls {
+  size_t reads = 0;
+  size_t writes = 0;
+  size_t seeks = 0;
+
+  size_t total() const { return reads + writes + seeks; }
+};
+
+class FsFile {
+ public:
+  static DriverCalls calls;
+
+  FsFile() = default;
+  explicit FsFile(std::shared_ptr<std::vector<uint8_t>> data) : data(std::move(data)) {}
+
+  int read() {
+    uint8_t b;
+    return read(&b, 1) == 1 ? b : -1;
+  }
+  int read(void* buf, const size_t count) {
+    calls.reads++;
+    const size_t n = pos < data->size() ? std::min(count, data->size() - pos) : 0;
+    memcpy(buf, data->data() + pos, n);
+    pos += n;
+    return static_cast<int>(n);
+  }
+
+  size_t write(const uint8_t b) { return write(&b, 1); }
+  size_t write(const void* buf, const size_t count) {
+    calls.writes++;
+    if (pos + count > data->size()) data->resize(pos + count);
+    memcpy(data->data() + pos, buf, count);
+    pos += count;
+    return count;
+  }
+
+  bool seek(const uint64_t p) {
+    calls.seeks++;
+    if (p > data->size()) return false;
+    pos = p;
+    return true;
+  }
+  bool seekCur(const int64_t offset) { return seek(pos + offset); }
+
+  uint64_t position() const { return pos; }
+  uint64_t size() const { return data->size(); }
+  uint64_t fileSize() const { return data->size(); }
+  explicit operator bool() const { return data != nullptr; }
+
+ private:
+  std::shared_ptr<std::vector<uint8_t>> data;
+  size_t pos = 0;
+};
+
+// The accounted FsFile operations of the real HalStorage, forwarding straight to the file
+class HalStorage {
+ public:
+  int read(FsFile& file, void* buffer, const size_t count) { return file.read(buffer, count); }
+  size_t write(FsFile& file, const void* buffer, const size_t count) { return file.write(buffer, count); }
+  bool seek(FsFile& file, const uint64_t position) { return file.seek(position); }
+
+  static HalStorage& getInstance() {
+    static HalStorage instance;
+    return instance;
+  }
+};
+
+#define Storage HalStorage::getInstance()
@@ -0,0 +1,394 @@
+#include <Serialization.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Counts SD driver calls (reads, writes and seeks on FsFile) for the cache files the reader touches on every page
+// turn and at book open, once with the old per-field FsFile serialization and once through BufferedReader and
+// BufferedWriter. Records follow the layouts of Page/TextBlock, book.bin spine entries, the TXT page index and the
+// XTC page table field by field. Both paths have to decode the same data. Also checks the buffered classes' edge
+// cases: seeks inside the buffer, reads across refills and past the end, oversized string lengths.
+
+DriverCalls FsFile::calls;
+
+namespace {
+
+using serialization::BufferedReader;
+using serialization::BufferedWriter;
+
+constexpr uint32_t SECTION_HEADER_SIZE = 27;  // Section.cpp HEADER_SIZE
+constexpr int PAGES = 40;
+constexpr int SPINE_ITEMS = 120;
+
+struct Line {
+  std::vector<std::string> words;
+  std::vector<uint16_t> xpos;
+  std::vector<uint8_t> styles;
+  std::vector<uint16_t> glyphCounts;
+  std::vector<uint16_t> glyphs;
+  int16_t style[10];
+  bool operator==(const Line& o) const {
+    return words == o.words && xpos == o.xpos && styles == o.styles && glyphCounts == o.glyphCounts &&
+           glyphs == o.glyphs && memcmp(style, o.style, sizeof(style)) == 0;
+  }
+};
+using Page = std::vector<Line>;
+
+std::vector<Page> makePages() {
+  std::mt19937 rng(7);
+  std::vector<Page> pages(PAGES);
+  for (auto& page : pages) {
+    page.resize(18 + rng() % 6);
+    for (auto& line : page) {
+      const int words = 6 + rng() % 7;
+      uint16_t x = 0;
+      for (int w = 0; w < words; w++) {
+        std::string word(2 + rng() % 9, 'a' + rng() % 26);
+        line.words.push_back(word);
+        line.xpos.push_back(x);
+        line.styles.push_back(rng() % 8 == 0 ? 2 : 0);
+        line.glyphCounts.push_back(word.size());
+        for (size_t c = 0; c < word.size(); c++) line.glyphs.push_back(rng() % 400);
+        x += word.size() * 11 + 7;
+      }
+      for (auto& v : line.style) v = rng() % 2;
+    }
+  }
+  return pages;
+}
+
+// PageLine + TextBlock::serialize, field by field
+template <typename Sink>
+void writeLine(Sink& f, const Line& line) {
+  serialization::writePod(f, static_cast<uint8_t>(1));  // TAG_PageLine
+  serialization::writePod(f, static_cast<int16_t>(20));
+  serialization::writePod(f, static_cast<int16_t>(40));
+  serialization::writePod(f, static_cast<uint16_t>(line.words.size()));
+  for (const auto& w : line.words) serialization::writeString(f, w);
+  for (auto x : line.xpos) serialization::writePod(f, x);
+  for (auto s : line.styles) serialization::writePod(f, s);
+  serialization::writePod(f, static_cast<uint32_t>(line.glyphs.size()));
+  for (auto c : line.glyphCounts) serialization::writePod(f, c);
+  f.write(reinterpret_cast<const uint8_t*>(line.glyphs.data()), line.glyphs.size() * sizeof(uint16_t));
+  serialization::writePod(f, static_cast<uint8_t>(line.style[0]));  // alignment
+  serialization::writePod(f, static_cast<bool>(line.style[1]));     // textAlignDefined
+  for (int i = 2; i < 10; i++) serialization::writePod(f, line.style[i]);
+  serialization::writePod(f, static_cast<int16_t>(0));  // textIndent
+  serialization::writePod(f, false);                    // textIndentDefined
+}
+
+template <typename Source>
+bool readLine(Source& f, Line& line) {
+  uint8_t tag;
+  int16_t xPos, yPos;
+  uint16_t wc;
+  serialization::readPod(f, tag);
+  serialization::readPod(f, xPos);
+  serialization::readPod(f, yPos);
+  serialization::readPod(f, wc);
+  if (tag != 1 || wc > 10000) return false;
+  line.words.resize(wc);
+  line.xpos.resize(wc);
+  line.styles.resize(wc);
+  for (auto& w : line.words) serialization::readString(f, w);
+  for (auto& x : line.xpos) serialization::readPod(f, x);
+  for (auto& s : line.styles) serialization::readPod(f, s);
+  uint32_t glyphCount;
+  serialization::readPod(f, glyphCount);
+  if (glyphCount > 100000) return false;
+  line.glyphCounts.resize(wc);
+  for (auto& c : line.glyphCounts) serialization::readPod(f, c);
+  line.glyphs.resize(glyphCount);
+  f.read(reinterpret_cast<uint8_t*>(line.glyphs.data()), glyphCount * sizeof(uint16_t));
+  uint8_t alignment;
+  bool alignDefined, indentDefined;
+  int16_t indent;
+  serialization::readPod(f, alignment);
+  serialization::readPod(f, alignDefined);
+  line.style[0] = alignment;
+  line.style[1] = alignDefined;
+  for (int i = 2; i < 10; i++) serialization::readPod(f, line.style[i]);
+  serialization::readPod(f, indent);
+  serialization::readPod(f, indentDefined);
+  return true;
+}
+
+// Section::createSectionFile: header placeholder, pages, LUT, then back to patch the header
+template <typename Sink>
+void writeSection(Sink& f, const std::vector<Page>& pages) {
+  const uint8_t header[SECTION_HEADER_SIZE] = {};
+  for (const uint8_t b : header) serialization::writePod(f, b);
+  std::vector<uint32_t> lut;
+  for (const auto& page : pages) {
+    lut.push_back(f.position());
+    serialization::writePod(f, static_cast<uint16_t>(page.size()));
+    for (const auto& line : page) writeLine(f, line);
+  }
+  const uint32_t lutOffset = f.position();
+  for (const uint32_t pos : lut) serialization::writePod(f, pos);
+  f.seek(SECTION_HEADER_SIZE - sizeof(uint32_t) - sizeof(uint16_t));
+  serialization::writePod(f, static_cast<uint16_t>(pages.size()));
+  serialization::writePod(f, lutOffset);
+}
+
+// Section::loadPage
+template <typename Source>
+bool loadPage(Source& f, const int index, Page& page) {
+  uint32_t lutOffset, pagePos;
+  uint16_t count;
+  f.seek(SECTION_HEADER_SIZE - sizeof(uint32_t));
+  serialization::readPod(f, lutOffset);
+  f.seek(lutOffset + sizeof(uint32_t) * index);
+  serialization::readPod(f, pagePos);
+  f.seek(pagePos);
+  serialization::readPod(f, count);
+  page.resize(count);
+  for (auto& line : page) {
+    if (!readLine(f, line)) return false;
+  }
+  return true;
+}
+
+struct Spine {
+  std::string href;
+  uint32_t cumulativeSize;
+  int16_t tocIndex;
+};
+
+// book.bin without metadata: LUT offset, spine LUT, spine entries
+std::shared_ptr<std::vector<uint8_t>> makeBookBin(std::vector<Spine>& spine) {
+  auto data = std::make_shared<std::vector<uint8_t>>();
+  FsFile f(data);
+  BufferedWriter w(f);
+  for (int i = 0; i < SPINE_ITEMS; i++) {
+    spine.push_back({"OEBPS/Text/chapter" + std::to_string(i) + ".xhtml", static_cast<uint32_t>(i * 14000),
+                     static_cast<int16_t>(i / 2)});
+  }
+  const uint32_t lutOffset = sizeof(uint32_t);
+  serialization::writePod(w, lutOffset);
+  uint32_t pos = lutOffset + sizeof(uint32_t) * SPINE_ITEMS;
+  for (const auto& s : spine) {
+    serialization::writePod(w, pos);
+    pos += sizeof(uint32_t) + s.href.size() + sizeof(s.cumulativeSize) + sizeof(s.tocIndex);
+  }
+  for (const auto& s : spine) {
+    serialization::writeString(w, s.href);
+    serialization::writePod(w, s.cumulativeSize);
+    serialization::writePod(w, s.tocIndex);
+  }
+  return data;
+}
+
+// BookMetadataCache::getSpineEntry; the LUT offset was read by load()
+template <typename Source>
+Spine getSpineEntry(Source& f, const int index) {
+  constexpr uint32_t lutOffset = sizeof(uint32_t);
+  uint32_t entryPos;
+  f.seek(lutOffset + sizeof(uint32_t) * index);
+  serialization::readPod(f, entryPos);
+  f.seek(entryPos);
+  Spine s;
+  serialization::readString(f, s.href);
+  serialization::readPod(f, s.cumulativeSize);
+  serialization::readPod(f, s.tocIndex);
+  return s;
+}
+
+// TXT page index body and XTC page table: runs of fixed-size records
+template <typename Source, typename Record>
+void readRecords(Source& f, std::vector<Record>& out) {
+  for (auto& r : out) serialization::readPod(f, r);
+}
+
+struct XtcPageTableEntry {
+  uint64_t dataOffset;
+  uint32_t dataSize;
+  uint16_t width;
+  uint16_t height;
+};
+
+struct Row {
+  const char* name;
+  size_t operations;
+  DriverCalls before;
+  DriverCalls after;
+};
+
+void printRow(const Row& r) {
+  printf("%-34s %6zu %8zu %6zu %6zu %8.1f %8.1f %7.0fx\n", r.name, r.operations, r.before.reads, r.before.writes,
+         r.before.seeks, r.before.total() / static_cast<double>(r.operations),
+         r.after.total() / static_cast<double>(r.operations),
+         r.before.total() / static_cast<double>(std::max<size_t>(1, r.after.total())));
+}
+
+template <typename Fn>
+DriverCalls count(Fn fn) {
+  FsFile::calls = {};
+  fn();
+  return FsFile::calls;
+}
+
+int failures = 0;
+void check(const bool ok, const char* what) {
+  if (!ok) {
+    printf("  FAILED: %s\n", what);
+    failures++;
+  }
+}
+
+void edgeCases() {
+  auto data = std::make_shared<std::vector<uint8_t>>(1500);
+  for (size_t i = 0; i < data->size(); i++) (*data)[i] = i * 7;
+  FsFile f(data);
+  BufferedReader r(f);
+
+  uint8_t b[600];
+  check(r.read(b, 10) && b[9] == static_cast<uint8_t>(63), "small read");
+  FsFile::calls = {};
+  check(r.seek(3) && r.read() == 21 && FsFile::calls.total() == 0, "seek inside the buffer touches no file");
+  check(r.seek(500) && r.read(b, 20) && b[19] == static_cast<uint8_t>(519 * 7), "read across a refill");
+  check(r.read(b, 600) && b[599] == static_cast<uint8_t>(1119 * 7) && r.position() == 1120, "large read");
+  check(r.skip(370) && r.read() == static_cast<uint8_t>(1490 * 7), "skip");
+  check(!r.read(b, 20) && b[8] == static_cast<uint8_t>(1499 * 7) && b[9] == 0 && !r.ok(), "read past the end");
+  check(r.read() == -1, "byte read at the end");
+
+  auto strings = std::make_shared<std::vector<uint8_t>>();
+  FsFile sf(strings);
+  {
+    BufferedWriter w(sf);
+    serialization::writeString(w, "ok");
+    serialization::writePod(w, static_cast<uint32_t>(1u << 30));  // Length of a string that isn't there
+    w.write("xyz", 3);
+  }
+  check(strings->size() == 13, "writer flushes on destruction");
+  sf.seek(0);
+  BufferedReader sr(sf);
+  std::string s;
+  check(serialization::readString(sr, s) && s == "ok", "string");
+  check(!serialization::readString(sr, s) && s.empty(), "string length past the end of the file is rejected");
+
+  // Writer seeks back over data it hasn't flushed yet, then carries on at the end
+  auto patched = std::make_shared<std::vector<uint8_t>>();
+  FsFile pf(patched);
+  BufferedWriter pw(pf);
+  for (uint32_t i = 0; i < 300; i++) serialization::writePod(pw, i);
+  const uint32_t end = pw.position();
+  pw.seek(4);
+  serialization::writePod(pw, static_cast<uint32_t>(0xabcd));
+  pw.seek(end);
+  serialization::writePod(pw, static_cast<uint32_t>(300));
+  pw.flush();
+  uint32_t v[301];
+  memcpy(v, patched->data(), sizeof(v));
+  check(patched->size() == sizeof(v) && v[1] == 0xabcd && v[2] == 2 && v[300] == 300, "writer seek and patch");
+}
+
+}  // namespace
+
+int main() {
+  edgeCases();
+
+  const auto pages = makePages();
+  std::vector<Row> rows;
+
+  // Section build
+  auto sectionOld = std::make_shared<std::vector<uint8_t>>();
+  auto sectionNew = std::make_shared<std::vector<uint8_t>>();
+  Row build{"section build (per page)", PAGES, {}, {}};
+  build.before = count([&] {
+    FsFile f(sectionOld);
+    writeSection(f, pages);
+  });
+  build.after = count([&] {
+    FsFile f(sectionNew);
+    BufferedWriter w(f);
+    writeSection(w, pages);
+  });
+  check(*sectionOld == *sectionNew, "buffered section file matches the unbuffered one");
+  rows.push_back(build);
+
+  // Page turns: every page once, each load opening the file afresh like Section::loadPage
+  Row turn{"page turn (Section::loadPage)", PAGES, {}, {}};
+  std::vector<Page> loadedOld(PAGES), loadedNew(PAGES);
+  turn.before = count([&] {
+    for (int i = 0; i < PAGES; i++) {
+      FsFile f(sectionNew);
+      check(loadPage(f, i, loadedOld[i]), "unbuffered page load");
+    }
+  });
+  turn.after = count([&] {
+    for (int i = 0; i < PAGES; i++) {
+      FsFile f(sectionNew);
+      BufferedReader r(f);
+      check(loadPage(r, i, loadedNew[i]), "buffered page load");
+    }
+  });
+  check(loadedOld == pages, "unbuffered pages decode to what was written");
+  check(loadedNew == pages, "buffered pages decode to what was written");
+  rows.push_back(turn);
+
+  // Spine lookups: walking the spine (progress, chapter lists) keeps one reader for the open book
+  std::vector<Spine> spine;
+  const auto bookBin = makeBookBin(spine);
+  Row walk{"book.bin spine walk (per entry)", SPINE_ITEMS, {}, {}};
+  walk.before = count([&] {
+    FsFile f(bookBin);
+    for (int i = 0; i < SPINE_ITEMS; i++) check(getSpineEntry(f, i).href == spine[i].href, "unbuffered spine");
+  });
+  walk.after = count([&] {
+    FsFile f(bookBin);
+    BufferedReader r(f);
+    for (int i = 0; i < SPINE_ITEMS; i++) {
+      const Spine s = getSpineEntry(r, i);
+      check(s.href == spine[i].href && s.cumulativeSize == spine[i].cumulativeSize, "buffered spine");
+    }
+  });
+  rows.push_back(walk);
+
+  std::mt19937 rng(3);
+  std::vector<int> jumps(64);
+  for (auto& j : jumps) j = rng() % SPINE_ITEMS;
+  Row jump{"book.bin random lookup", jumps.size(), {}, {}};
+  jump.before = count([&] {
+    FsFile f(bookBin);
+    for (const int i : jumps) getSpineEntry(f, i);
+  });
+  jump.after = count([&] {
+    FsFile f(bookBin);
+    BufferedReader r(f);
+    for (const int i : jumps) check(getSpineEntry(r, i).tocIndex == spine[i].tocIndex, "buffered random spine");
+  });
+  rows.push_back(jump);
+
+  // TXT page index for a long book and the XTC page table of a 300 page file, each loaded once
+  const auto runOfRecords = [&](const char* name, auto record, const size_t n) {
+    using Record = decltype(record);
+    auto data = std::make_shared<std::vector<uint8_t>>(n * sizeof(Record));
+    for (size_t i = 0; i < data->size(); i++) (*data)[i] = i * 13;
+    std::vector<Record> a(n), b(n);
+    Row row{name, 1, {}, {}};
+    row.before = count([&] {
+      FsFile f(data);
+      readRecords(f, a);
+    });
+    row.after = count([&] {
+      FsFile f(data);
+      BufferedReader r(f);
+      readRecords(r, b);
+    });
+    check(memcmp(a.data(), b.data(), n * sizeof(Record)) == 0, name);
+    rows.push_back(row);
+  };
+  runOfRecords("TXT page index, 3000 pages", uint32_t{}, 3000);
+  runOfRecords("XTC page table, 300 pages", XtcPageTableEntry{}, 300);
+
+  printf("%-34s %6s %8s %6s %6s %8s %8s %8s\n", "", "ops", "reads", "writes", "seeks", "old/op", "new/op",
+         "fewer");
+  for (const auto& r : rows) printRow(r);
+  printf("(reads/writes/seeks are the old path's; a counted call is one trip into the SD driver on the device)\n");
+
+  printf(failures == 0 ? "All checks passed\n" : "%d checks failed\n", failures);
+  return failures == 0 ? 0 : 1;
+}